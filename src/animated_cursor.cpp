@@ -0,0 +1,393 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "animated_cursor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <map>
+#include <stdexcept>
+
+#include "logger.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+///
+/// \brief Header of every RIFF chunk.
+///
+struct riff_chunk
+{
+	char          id[4]; ///< Four character code of the chunk.
+	std::uint32_t size;  ///< Size of the chunk data, without the header and the padding.
+};
+
+#pragma pack(pop)
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Four character codes of the chunks and lists used by ANI files.
+///
+static constexpr std::string_view RIFF_ID     = "RIFF";
+static constexpr std::string_view ACON_ID     = "ACON";
+static constexpr std::string_view LIST_ID     = "LIST";
+static constexpr std::string_view INFO_ID     = "INFO";
+static constexpr std::string_view FRAMES_ID   = "fram";
+static constexpr std::string_view FRAME_ID    = "icon";
+static constexpr std::string_view HEADER_ID   = "anih";
+static constexpr std::string_view RATES_ID    = "rate";
+static constexpr std::string_view SEQUENCE_ID = "seq ";
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Splits a sequence of RIFF chunks.
+/// \param bytes: The chunks.
+/// \returns The header and the data of every chunk.
+///
+static std::vector<std::pair<riff_chunk, std::span<const std::uint8_t>>> read_chunks(std::span<const std::uint8_t> bytes);
+
+///
+/// \brief Reads an array of little endian 32-bit values.
+/// \param chunk: The chunk data.
+/// \returns The values.
+///
+static std::vector<std::uint32_t> read_values(std::span<const std::uint8_t> chunk);
+
+///
+/// \brief Appends a RIFF chunk, padded to an even size.
+/// \param bytes: The file being built.
+/// \param id: The four character code.
+/// \param data: The chunk data.
+///
+static void write_chunk(std::vector<std::uint8_t>&    bytes,
+                        std::string_view              id,
+                        std::span<const std::uint8_t> data);
+
+///
+/// \brief Overwrites the size of a chunk whose data was appended after it.
+/// \param bytes: The file being built.
+/// \param offset: The offset of the chunk header.
+///
+static void patch_chunk_size(std::vector<std::uint8_t>& bytes,
+                             std::size_t                offset);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+animated_cursor::animated_cursor(const std::string_view file_path)
+    : file{ file_path }
+    , ani_header{}
+    , info{}
+    , unique_frames{}
+    , steps{}
+    , rates{}
+{
+	std::vector<std::span<const std::uint8_t>> frames   = {};
+	std::vector<std::uint32_t>                 sequence = {};
+
+	parse(frames, sequence);
+	deduplicate(frames, sequence);
+}
+
+const animated_cursor::header& animated_cursor::get_header() const noexcept
+{
+	return ani_header;
+}
+
+const std::vector<std::span<const std::uint8_t>>& animated_cursor::get_frames() const noexcept
+{
+	return unique_frames;
+}
+
+const std::vector<std::uint32_t>& animated_cursor::get_sequence() const noexcept
+{
+	return steps;
+}
+
+const std::vector<std::uint32_t>& animated_cursor::get_rates() const noexcept
+{
+	return rates;
+}
+
+std::vector<std::uint8_t> animated_cursor::serialize() const
+{
+	std::vector<std::uint8_t> bytes = {};
+
+	write_chunk(bytes, RIFF_ID, {});
+	bytes.insert(bytes.end(), ACON_ID.begin(), ACON_ID.end());
+
+	if (!info.empty())
+	{
+		write_chunk(bytes, LIST_ID, info);
+	}
+
+	write_chunk(bytes, HEADER_ID, { reinterpret_cast<const std::uint8_t*>(&ani_header), sizeof(ani_header) });
+
+	if (!rates.empty())
+	{
+		write_chunk(bytes, RATES_ID, { reinterpret_cast<const std::uint8_t*>(rates.data()), rates.size() * sizeof(std::uint32_t) });
+	}
+
+	if (0 != (SEQUENCE_FLAG & ani_header.flags))
+	{
+		write_chunk(bytes, SEQUENCE_ID, { reinterpret_cast<const std::uint8_t*>(steps.data()), steps.size() * sizeof(std::uint32_t) });
+	}
+
+	const std::size_t frames_offset = bytes.size();
+
+	write_chunk(bytes, LIST_ID, {});
+	bytes.insert(bytes.end(), FRAMES_ID.begin(), FRAMES_ID.end());
+
+	for (const std::span<const std::uint8_t> frame : unique_frames)
+	{
+		write_chunk(bytes, FRAME_ID, frame);
+	}
+
+	patch_chunk_size(bytes, frames_offset);
+	patch_chunk_size(bytes, 0);
+
+	return bytes;
+}
+
+void animated_cursor::parse(std::vector<std::span<const std::uint8_t>>& frames,
+                            std::vector<std::uint32_t>&                 sequence)
+{
+	const std::span<const std::uint8_t> bytes      = file.get_bytes();
+	riff_chunk                          riff       = {};
+	bool                                has_header = false;
+
+	if (bytes.size() < sizeof(riff) + ACON_ID.size())
+	{
+		throw std::invalid_argument{ "Animated cursor does not have a RIFF header!" };
+	}
+
+	std::memcpy(&riff, bytes.data(), sizeof(riff));
+
+	if (RIFF_ID != std::string_view{ riff.id, sizeof(riff.id) } || riff.size < ACON_ID.size() ||
+	    ACON_ID != std::string_view{ reinterpret_cast<const char*>(bytes.data()) + sizeof(riff), ACON_ID.size() })
+	{
+		throw std::invalid_argument{ "Animated cursor does not have a RIFF header!" };
+	}
+
+	const std::size_t end = std::min<std::size_t>(bytes.size(), sizeof(riff) + static_cast<std::size_t>(riff.size));
+
+	for (const auto& [chunk, data] : read_chunks(bytes.subspan(sizeof(riff) + ACON_ID.size(), end - sizeof(riff) - ACON_ID.size())))
+	{
+		const std::string_view id = std::string_view{ chunk.id, sizeof(chunk.id) };
+
+		if (HEADER_ID == id)
+		{
+			if (data.size() < sizeof(ani_header))
+			{
+				throw std::invalid_argument{ std::format("Animated cursor header size {} is invalid!", data.size()) };
+			}
+
+			std::memcpy(&ani_header, data.data(), sizeof(ani_header));
+			has_header = true;
+		}
+		else if (RATES_ID == id)
+		{
+			rates = read_values(data);
+		}
+		else if (SEQUENCE_ID == id)
+		{
+			sequence = read_values(data);
+		}
+		else if (LIST_ID == id && INFO_ID.size() <= data.size() && INFO_ID == std::string_view{ reinterpret_cast<const char*>(data.data()), INFO_ID.size() })
+		{
+			info = data;
+		}
+		else if (LIST_ID == id && FRAMES_ID.size() <= data.size() && FRAMES_ID == std::string_view{ reinterpret_cast<const char*>(data.data()), FRAMES_ID.size() })
+		{
+			for (const auto& [frame_chunk, frame] : read_chunks(data.subspan(FRAMES_ID.size())))
+			{
+				if (FRAME_ID == std::string_view{ frame_chunk.id, sizeof(frame_chunk.id) })
+				{
+					frames.push_back(frame);
+				}
+			}
+		}
+	}
+
+	if (!has_header)
+	{
+		throw std::invalid_argument{ "Animated cursor does not have an \"anih\" chunk!" };
+	}
+
+	if (0 == (ICON_FRAMES_FLAG & ani_header.flags))
+	{
+		throw std::invalid_argument{ "Animated cursors with raw bitmap frames are not supported!" };
+	}
+
+	if (0 == ani_header.steps_count || frames.size() != ani_header.frames_count)
+	{
+		throw std::invalid_argument{ std::format("Animated cursor has {} frame(s) and {} step(s), expecting {} frame(s)!", frames.size(), ani_header.steps_count,
+		                                         ani_header.frames_count) };
+	}
+
+	if ((!sequence.empty() && sequence.size() != ani_header.steps_count) || (!rates.empty() && rates.size() != ani_header.steps_count))
+	{
+		throw std::invalid_argument{ "Animated cursor sequence or rates do not match the step count!" };
+	}
+
+	if (sequence.empty() && ani_header.steps_count > frames.size())
+	{
+		throw std::invalid_argument{ "Animated cursor has more steps than frames and no sequence!" };
+	}
+
+	for (const std::span<const std::uint8_t> frame : frames)
+	{
+		icon::header frame_header = {};
+
+		if (frame.size() < sizeof(frame_header))
+		{
+			throw std::invalid_argument{ "Animated cursor frame is not an ICO/CUR file!" };
+		}
+
+		std::memcpy(&frame_header, frame.data(), sizeof(frame_header));
+
+		if (0 != frame_header.reserved || (1 != frame_header.type && 2 != frame_header.type) || 0 == frame_header.entries_count)
+		{
+			throw std::invalid_argument{ "Animated cursor frame is not an ICO/CUR file!" };
+		}
+	}
+}
+
+void animated_cursor::deduplicate(const std::vector<std::span<const std::uint8_t>>& frames,
+                                  const std::vector<std::uint32_t>&                 sequence)
+{
+	std::map<sha256::digest, std::uint32_t> indexes = {};
+
+	for (std::uint32_t step = 0; step < ani_header.steps_count; ++step)
+	{
+		const std::uint32_t frame = sequence.empty() ? step : sequence[step];
+
+		if (frames.size() <= frame)
+		{
+			throw std::invalid_argument{ std::format("Animated cursor step {} refers to frame {} out of {}!", step, frame, frames.size()) };
+		}
+
+		const auto [position, inserted] = indexes.try_emplace(sha256::hash(frames[frame]), static_cast<std::uint32_t>(unique_frames.size()));
+
+		if (inserted)
+		{
+			unique_frames.push_back(frames[frame]);
+		}
+
+		steps.push_back(position->second);
+	}
+
+	LOG("Deduplicated {} frame(s) into {}.", frames.size(), unique_frames.size());
+
+	if (!rates.empty() && std::all_of(rates.begin(), rates.end(), [this](const std::uint32_t rate) { return rate == rates.front(); }))
+	{
+		ani_header.display_rate = rates.front();
+		rates.clear();
+	}
+
+	ani_header.header_size  = sizeof(ani_header);
+	ani_header.frames_count = static_cast<std::uint32_t>(unique_frames.size());
+	ani_header.flags        = ICON_FRAMES_FLAG;
+
+	for (std::uint32_t step = 0; step < steps.size(); ++step)
+	{
+		if (step != steps[step] || steps.size() != unique_frames.size())
+		{
+			ani_header.flags |= SEQUENCE_FLAG;
+			break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<std::pair<riff_chunk, std::span<const std::uint8_t>>> read_chunks(const std::span<const std::uint8_t> bytes)
+{
+	std::vector<std::pair<riff_chunk, std::span<const std::uint8_t>>> chunks = {};
+	std::size_t                                                       offset = 0;
+
+	while (sizeof(riff_chunk) <= bytes.size() - offset)
+	{
+		riff_chunk chunk = {};
+
+		std::memcpy(&chunk, bytes.data() + offset, sizeof(chunk));
+		offset += sizeof(chunk);
+
+		if (bytes.size() - offset < chunk.size)
+		{
+			throw std::invalid_argument{ std::format("Chunk \"{}\" is truncated!", std::string_view{ chunk.id, sizeof(chunk.id) }) };
+		}
+
+		chunks.push_back({ chunk, bytes.subspan(offset, chunk.size) });
+		offset += std::min<std::size_t>(bytes.size() - offset, chunk.size + (chunk.size & 1));
+	}
+
+	return chunks;
+}
+
+static std::vector<std::uint32_t> read_values(const std::span<const std::uint8_t> chunk)
+{
+	std::vector<std::uint32_t> values = std::vector<std::uint32_t>(chunk.size() / sizeof(std::uint32_t));
+
+	std::memcpy(values.data(), chunk.data(), values.size() * sizeof(std::uint32_t));
+	return values;
+}
+
+static void write_chunk(std::vector<std::uint8_t>&          bytes,
+                        const std::string_view              id,
+                        const std::span<const std::uint8_t> data)
+{
+	riff_chunk chunk = {};
+
+	std::memcpy(chunk.id, id.data(), sizeof(chunk.id));
+	chunk.size = static_cast<std::uint32_t>(data.size());
+
+	bytes.insert(bytes.end(), reinterpret_cast<const std::uint8_t*>(&chunk), reinterpret_cast<const std::uint8_t*>(&chunk) + sizeof(chunk));
+	bytes.insert(bytes.end(), data.begin(), data.end());
+
+	if (0 != (data.size() & 1))
+	{
+		bytes.push_back(0x00);
+	}
+}
+
+static void patch_chunk_size(std::vector<std::uint8_t>& bytes,
+                             const std::size_t          offset)
+{
+	const std::uint32_t size = static_cast<std::uint32_t>(bytes.size() - offset - sizeof(riff_chunk));
+
+	std::memcpy(bytes.data() + offset + offsetof(riff_chunk, size), &size, sizeof(size));
+}
+
+} // namespace icon_changer
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "icon.hpp"
+#include "mapped_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Class to read and optimize animated cursor (ANI) files.
+/// \details The file is memory mapped and the frames are referenced in place.
+/// Frames with the same contents are stored once and the playback sequence
+/// refers to them, frames never played are dropped.
+/// \see https://en.wikipedia.org/wiki/ANI_(file_format)
+///
+class animated_cursor final
+{
+public:
+	///
+	/// \brief This data structure corresponds to ANIHEADER.
+	///
+	struct PACKED header final
+	{
+		std::uint32_t header_size;  ///< Size of this structure, 36.
+		std::uint32_t frames_count; ///< Number of stored frames.
+		std::uint32_t steps_count;  ///< Number of steps of the animation.
+		std::uint32_t width;        ///< Width of raw frames, 0 for ICO/CUR frames.
+		std::uint32_t height;       ///< Height of raw frames, 0 for ICO/CUR frames.
+		std::uint32_t bit_count;    ///< Bits per pixel of raw frames, 0 for ICO/CUR frames.
+		std::uint32_t planes;       ///< Color planes of raw frames, 0 for ICO/CUR frames.
+		std::uint32_t display_rate; ///< Default step duration in jiffies (1/60 s).
+		std::uint32_t flags;        ///< ICON_FRAMES_FLAG and SEQUENCE_FLAG.
+	};
+
+	///
+	/// \brief Set when the frames are ICO/CUR files rather than raw bitmaps.
+	///
+	static constexpr std::uint32_t ICON_FRAMES_FLAG = 0x00000001;
+
+	///
+	/// \brief Set when the file has a "seq " chunk.
+	///
+	static constexpr std::uint32_t SEQUENCE_FLAG = 0x00000002;
+
+public:
+	///
+	/// \brief Constructor to parse an ANI file.
+	/// \details Reads the "anih", "rate" and "seq " chunks and the frames of
+	/// the "fram" list, then deduplicates the frames.
+	/// \param file_path: The path to the ANI file.
+	///
+	explicit animated_cursor(std::string_view file_path);
+
+	///
+	/// \brief Gets the animation header, updated for the deduplicated frames.
+	/// \returns The header.
+	///
+	[[nodiscard]] const header& get_header() const noexcept;
+
+	///
+	/// \brief Gets the distinct frames, in the order they are first played.
+	/// \returns The ICO/CUR files of the frames, pointing into the mapped file.
+	///
+	[[nodiscard]] const std::vector<std::span<const std::uint8_t>>& get_frames() const noexcept;
+
+	///
+	/// \brief Gets the playback sequence.
+	/// \returns The index of the frame shown at every step.
+	///
+	[[nodiscard]] const std::vector<std::uint32_t>& get_sequence() const noexcept;
+
+	///
+	/// \brief Gets the durations of the steps.
+	/// \returns The duration of every step in jiffies, empty when every step
+	/// lasts the default display rate.
+	///
+	[[nodiscard]] const std::vector<std::uint32_t>& get_rates() const noexcept;
+
+	///
+	/// \brief Serializes the animation into an ANI file.
+	/// \details The "seq " and "rate" chunks are only written when needed, so
+	/// the result is never larger than the original file. It is also the
+	/// payload of an RT_ANICURSOR resource.
+	/// \returns The bytes of the ANI file.
+	///
+	[[nodiscard]] std::vector<std::uint8_t> serialize() const;
+
+private:
+	///
+	/// \brief Parses the chunks of the RIFF file.
+	/// \param frames: Receives every frame of the "fram" list, in file order.
+	/// \param sequence: Receives the "seq " chunk, empty if missing.
+	///
+	void parse(std::vector<std::span<const std::uint8_t>>& frames,
+	           std::vector<std::uint32_t>&                 sequence);
+
+	///
+	/// \brief Removes the duplicated and unused frames.
+	/// \param frames: Every frame of the file, in file order.
+	/// \param sequence: The "seq " chunk, empty if missing.
+	///
+	void deduplicate(const std::vector<std::span<const std::uint8_t>>& frames,
+	                 const std::vector<std::uint32_t>&                 sequence);
+
+private:
+	mapped_file                                file;          ///< The mapped ANI file.
+	header                                     ani_header;    ///< The animation header.
+	std::span<const std::uint8_t>              info;          ///< The "INFO" list (title, author), empty if missing.
+	std::vector<std::span<const std::uint8_t>> unique_frames; ///< The distinct frames.
+	std::vector<std::uint32_t>                 steps;         ///< The frame shown at every step.
+	std::vector<std::uint32_t>                 rates;         ///< The duration of every step, can be empty.
+};
+
+} // namespace icon_changer
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "async_api.hpp"
+
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+
+#include "resource_tree.hpp"
+#include "stamp.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+task<icon> load_icon_async(executor& executor, std::string icon_path)
+{
+	co_await executor.schedule();
+
+	require_file(icon_path);
+
+	co_return icon{ icon_path, true };
+}
+
+task<apply_result> apply_async(executor& executor, std::string icon_path, std::string executable_path, stamp_options options)
+{
+	co_await executor.schedule();
+
+	require_file(icon_path);
+	require_file(executable_path);
+
+	// Stamped exactly like the command line, see change_icon_cli().
+	const resource_tree stamp = build_stamp(icon_path, options);
+
+	if (nullptr == stamp.find(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE))
+	{
+		throw std::invalid_argument{ std::format("\"{}\" is a cursor, not an icon!", icon_path) };
+	}
+
+	const std::uint64_t old_size = std::filesystem::file_size(executable_path);
+
+	static_cast<void>(stamp_file(stamp, executable_path, options, false, false));
+
+	co_return apply_result{ old_size, std::filesystem::file_size(executable_path) };
+}
+
+} // namespace icon_changer
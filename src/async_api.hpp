@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "executor.hpp"
+#include "icon.hpp"
+#include "stamp.hpp"
+#include "task.hpp"
+
+#include <cstdint>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The outcome of apply_async().
+///
+struct apply_result
+{
+	std::uint64_t old_size; ///< The size of the executable before, in bytes.
+	std::uint64_t new_size; ///< The size of the executable after, in bytes.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Loads an icon on an executor.
+/// \details The icon is memory mapped, its images are read when used.
+/// \param executor: The executor doing the file I/O.
+/// \param icon_path: The path to the icon.
+/// \returns The task loading the icon, started when awaited.
+///
+extern task<icon> load_icon_async(executor& executor, std::string icon_path);
+
+///
+/// \brief Sets the main icon of an executable on an executor.
+/// \details Works like the command line: the same options stamp the same
+/// executable. Without options signed executables are rejected, and cursors
+/// are always rejected as the icon.
+/// \param executor: The executor doing the file I/O.
+/// \param icon_path: The path to the icon.
+/// \param executable_path: The path to the executable.
+/// \param options: The cursors stamped along, the signature policy and
+/// whether the output is verified.
+/// \returns The task changing the icon, started when awaited.
+///
+extern task<apply_result> apply_async(executor& executor, std::string icon_path, std::string executable_path, stamp_options options = {});
+
+} // namespace icon_changer
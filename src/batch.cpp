@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "batch.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Limit of the target sizes given in a job file (256 TiB), so the
+/// sizes of a whole batch can be added up.
+///
+static constexpr std::uint64_t MAX_TARGET_SIZE = std::uint64_t{ 1 } << 48;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Parses the size of a target given in a job file.
+/// \param text: The size in bytes.
+/// \returns The size, empty if the text is not a valid size.
+///
+static std::optional<std::uint64_t> parse_size(std::string_view text);
+
+///
+/// \brief Computes the key under which updates of the same file are merged.
+/// \param file_path: The path to the file, which may not exist yet.
+/// \returns The canonical path, or the normalized one if it cannot be resolved.
+///
+static std::string get_target_key(std::string_view file_path);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<job> read_jobs(const std::string_view job_file_path)
+{
+	std::ifstream    file   = std::ifstream{ std::string{ job_file_path } };
+	std::vector<job> jobs   = {};
+	std::string      line   = {};
+	std::size_t      number = 0;
+
+	if (!file.is_open())
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", job_file_path) };
+	}
+
+	while (std::getline(file, line))
+	{
+		++number;
+
+		if (!line.empty() && '\r' == line.back())
+		{
+			line.pop_back();
+		}
+
+		if (line.empty() || '#' == line.front())
+		{
+			continue;
+		}
+
+		const std::size_t            separator = line.find('\t');
+		const std::size_t            end       = std::string::npos == separator ? separator : line.find('\t', separator + 1);
+		std::optional<std::uint64_t> size      = std::nullopt;
+
+		if (std::string::npos != end)
+		{
+			size = parse_size(std::string_view{ line }.substr(end + 1));
+		}
+
+		if (std::string::npos == separator || 0 == separator || separator + 1 == std::min(end, line.size()) || (std::string::npos != end && !size.has_value()))
+		{
+			throw std::invalid_argument{ std::format("Line {} of \"{}\" is not \"<path_to_icon>\\t<path_to_exe>[\\t<size>]\"!", number, job_file_path) };
+		}
+
+		jobs.push_back({ line.substr(0, separator), line.substr(separator + 1, end - separator - 1), size });
+	}
+
+	return jobs;
+}
+
+std::vector<job> coalesce_jobs(const std::vector<job>& jobs)
+{
+	std::unordered_map<std::string, std::size_t> positions = {};
+	std::vector<job>                             coalesced = {};
+
+	for (const job& job : jobs)
+	{
+		const auto [position, inserted] = positions.try_emplace(get_target_key(job.executable_path), coalesced.size());
+
+		if (inserted)
+		{
+			coalesced.push_back(job);
+			continue;
+		}
+
+		coalesced[position->second].icon_path = job.icon_path;
+
+		if (job.size.has_value())
+		{
+			coalesced[position->second].size = job.size;
+		}
+	}
+
+	return coalesced;
+}
+
+static std::optional<std::uint64_t> parse_size(const std::string_view text)
+{
+	std::uint64_t                size   = 0;
+	const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), size);
+
+	if (std::errc{} != result.ec || text.data() + text.size() != result.ptr || MAX_TARGET_SIZE < size)
+	{
+		return std::nullopt;
+	}
+
+	return size;
+}
+
+static std::string get_target_key(const std::string_view file_path)
+{
+	std::error_code             error     = {};
+	const std::filesystem::path path      = std::filesystem::absolute(std::filesystem::path{ file_path });
+	const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+
+	// Components that do not exist yet are not resolved, only normalized.
+	return error ? path.lexically_normal().string() : canonical.lexically_normal().string();
+}
+
+} // namespace icon_changer
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief One icon update requested in a job file.
+///
+struct job final
+{
+	std::string                  icon_path;       ///< The path to the `.ico` file.
+	std::string                  executable_path; ///< The path to the target executable.
+	std::optional<std::uint64_t> size;            ///< The size of the target before the run, balances --shard.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Reads the jobs of a job file.
+/// \details Every line holds the icon path and the executable path separated
+/// by a tab, optionally followed by another tab and the size of the
+/// executable in bytes. Empty lines and lines starting with '#' are skipped.
+/// \param job_file_path: The path to the job file.
+/// \returns The jobs, in file order.
+///
+extern std::vector<job> read_jobs(std::string_view job_file_path);
+
+///
+/// \brief Merges the jobs targeting the same executable into one.
+/// \details Only the last update of an executable would survive anyway, so
+/// it is the only one kept, at the position of the first one. Paths are
+/// compared after being made canonical.
+/// \param jobs: The jobs, in the order they were queued.
+/// \returns At most one job per executable.
+///
+extern std::vector<job> coalesce_jobs(const std::vector<job>& jobs);
+
+} // namespace icon_changer
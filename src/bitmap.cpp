@@ -17,9 +17,14 @@
 
 #include "bitmap.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <stdexcept>
 
+#include "io_strategy.hpp"
+#include "mapped_file.hpp"
+
 ////////////////////////////////////////////////////////////////////////////////
 // STRUCT DEFINITIONS
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,15 +64,23 @@ namespace icon_changer
 
 	bool bitmap::loadFromImage(const std::string& path)
 	{
-		std::ifstream file{ path, std::ios::binary };
+		std::ifstream file{ path, std::ios::binary | std::ios::ate };
 		if (!file.is_open())
 		{
 			throw std::invalid_argument{ "Failed to open BMP file: " + path };
 		}
 
+		const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+
 		BitmapFileHeader file_header{};
 		BitmapInfoHeader info_header{};
 
+		if (sizeof(file_header) + sizeof(info_header) > fileSize)
+		{
+			throw std::runtime_error{ "Not a valid BMP file: " + path };
+		}
+
+		file.seekg(0, std::ios::beg);
 		file.read(reinterpret_cast<char*>(&file_header), sizeof(file_header));
 		file.read(reinterpret_cast<char*>(&info_header), sizeof(info_header));
 
@@ -79,20 +92,55 @@ namespace icon_changer
 			throw std::runtime_error("Unsupported BMP compression: " + path);
 		}
 
+		// Every size below comes from the file, so it is checked before anything is allocated.
+		if (info_header.biWidth <= 0 || info_header.biHeight == 0 || info_header.biHeight == INT32_MIN
+		    || info_header.biBitCount == 0 || info_header.biBitCount > 32 || info_header.biBitCount % 8 != 0) {
+			throw std::runtime_error("Unsupported BMP dimensions or bit depth: " + path);
+		}
+
+		const bool topDown = (info_header.biHeight < 0);
+
 		width = info_header.biWidth;
-		height = info_header.biHeight;
+		height = topDown ? -info_header.biHeight : info_header.biHeight;
 		bitDepth = info_header.biBitCount;
 
-		const bool topDown = (info_header.biHeight < 0);
 		const std::size_t bytesPerPixel = bitDepth / 8;
-		const std::size_t paddedRowSize = ((bitDepth * width + 31) / 32) * 4;
-		const std::size_t rawRowSize = width * bytesPerPixel;
+		const std::size_t paddedRowSize = ((static_cast<std::uint64_t>(bitDepth) * width + 31) / 32) * 4;
+		const std::size_t rawRowSize = static_cast<std::size_t>(width) * bytesPerPixel;
+		const std::uint64_t pixelsSize = checked_multiply(rawRowSize, static_cast<std::uint64_t>(height), "BMP pixels");
+		const std::uint64_t storedSize = checked_multiply(paddedRowSize, static_cast<std::uint64_t>(height), "BMP pixels");
 
-		pixels.resize(width * height * bytesPerPixel);
+		if (file_header.bfOffBits > fileSize || fileSize - file_header.bfOffBits < storedSize) {
+			throw std::runtime_error("BMP file is smaller than its pixels: " + path);
+		}
+
+		reservation = memory_reservation{ pixelsSize + paddedRowSize, "BMP file " + path };
+		pixels.resize(pixelsSize);
+
+		// Where the I/O thresholds allow it, the rows are copied straight from
+		// the page cache, without a row buffer.
+		if (select_read_method(path) == read_method::mapped) {
+			const mapped_file mapping{ path };
+
+			if (mapping.get_bytes().size() < file_header.bfOffBits + storedSize) {
+				throw std::runtime_error("BMP file is smaller than its pixels: " + path);
+			}
+
+			for (int y = 0; y < height; ++y) {
+				int destY = topDown ? y : (height - 1 - y);
+
+				std::copy_n(mapping.get_bytes().data() + file_header.bfOffBits + y * paddedRowSize,
+					rawRowSize,
+					&pixels[destY * rawRowSize]
+				);
+			}
+
+			return true;
+		}
 
 		file.seekg(file_header.bfOffBits, std::ios::beg);
 
-		std::vector<std::uint8_t> row(paddedRowSize);
+		std::pmr::vector<std::uint8_t> row(paddedRowSize, pixels.get_allocator());
 
 		for (int y = 0; y < height; ++y) {
 			file.read(reinterpret_cast<char*>(row.data()), paddedRowSize);
@@ -20,6 +20,9 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory_resource>
+
+#include "memory_budget.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 // CLASS DECLARATION
@@ -30,19 +33,25 @@ namespace icon_changer
 class bitmap
 {
 private:
-	int                     width      = 0;
-	int                     height     = 0;
-	int                     bitDepth   = 0;
-	std::vector<std::uint8_t> pixels; // BGR format
+	int                            width      = 0;
+	int                            height     = 0;
+	int                            bitDepth   = 0;
+	std::pmr::vector<std::uint8_t> pixels; // BGR format, allocated from the bitmap's memory resource
+	memory_reservation             reservation; // Counts the pixels against the memory limits
 
 public:
 	////////////////////////////////////////////////////////////////////////////////
 	// PUBLIC METHODS
 	////////////////////////////////////////////////////////////////////////////////
 
+	bitmap() = default;
+
+	// Allocates the pixels and the row scratch buffer from resource, e.g. a per-job arena
+	explicit bitmap(std::pmr::memory_resource* resource) : pixels{ resource } {}
+
 	[[nodiscard]] int getWidth() const noexcept { return width; }
 	[[nodiscard]] int getHeight() const noexcept { return height; }
-	[[nodiscard]] const std::vector<std::uint8_t>& getPixels() const noexcept { return pixels; }
+	[[nodiscard]] const std::pmr::vector<std::uint8_t>& getPixels() const noexcept { return pixels; }
 	[[nodiscard]] int getBitDepth() const noexcept { return bitDepth; }
 
 	bool loadFromImage(const std::string& path);
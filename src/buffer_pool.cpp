@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "buffer_pool.hpp"
+
+#include <bit>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The smallest class: 4 KiB, as 1 << 12.
+///
+static constexpr std::size_t MIN_CLASS_SHIFT = 12;
+
+///
+/// \brief Alignment of the pooled buffers; stricter requests bypass the pool.
+///
+static constexpr std::size_t POOL_ALIGNMENT = alignof(std::max_align_t);
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Finds the size class of a request.
+/// \param bytes: The requested size.
+/// \param class_count: The number of classes.
+/// \returns The class index, class_count when the request is too large.
+///
+static std::size_t get_class(std::size_t bytes,
+                             std::size_t class_count) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+buffer_pool::buffer_pool(std::pmr::memory_resource* const upstream) noexcept
+    : upstream{ upstream }
+    , mutex{}
+    , free_buffers{}
+    , upstream_allocations{ 0 }
+{
+}
+
+buffer_pool::~buffer_pool() noexcept
+{
+	for (std::size_t index = 0; index < CLASS_COUNT; ++index)
+	{
+		while (nullptr != free_buffers[index])
+		{
+			void* const buffer = free_buffers[index];
+
+			free_buffers[index] = *static_cast<void**>(buffer);
+			upstream->deallocate(buffer, std::size_t{ 1 } << (MIN_CLASS_SHIFT + index), POOL_ALIGNMENT);
+		}
+	}
+}
+
+std::size_t buffer_pool::get_upstream_allocations() const noexcept
+{
+	return upstream_allocations;
+}
+
+void* buffer_pool::do_allocate(const std::size_t bytes,
+                               const std::size_t alignment)
+{
+	const std::size_t size_class = get_class(bytes, CLASS_COUNT);
+
+	if (CLASS_COUNT == size_class || POOL_ALIGNMENT < alignment)
+	{
+		++upstream_allocations;
+		return upstream->allocate(bytes, alignment);
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ mutex };
+
+		if (nullptr != free_buffers[size_class])
+		{
+			void* const buffer = free_buffers[size_class];
+
+			free_buffers[size_class] = *static_cast<void**>(buffer);
+			return buffer;
+		}
+	}
+
+	++upstream_allocations;
+	return upstream->allocate(std::size_t{ 1 } << (MIN_CLASS_SHIFT + size_class), POOL_ALIGNMENT);
+}
+
+void buffer_pool::do_deallocate(void* const       pointer,
+                                const std::size_t bytes,
+                                const std::size_t alignment)
+{
+	const std::size_t size_class = get_class(bytes, CLASS_COUNT);
+
+	if (CLASS_COUNT == size_class || POOL_ALIGNMENT < alignment)
+	{
+		upstream->deallocate(pointer, bytes, alignment);
+		return;
+	}
+
+	const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ mutex };
+
+	// The buffer is at least 4 KiB, plenty to link it into the free list.
+	*static_cast<void**>(pointer) = free_buffers[size_class];
+	free_buffers[size_class]      = pointer;
+}
+
+bool buffer_pool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static std::size_t get_class(const std::size_t bytes,
+                             const std::size_t class_count) noexcept
+{
+	const std::size_t size_class = bytes <= std::size_t{ 1 } << MIN_CLASS_SHIFT ? 0 : static_cast<std::size_t>(std::bit_width(bytes - 1)) - MIN_CLASS_SHIFT;
+
+	return size_class < class_count ? size_class : class_count;
+}
+
+} // namespace icon_changer
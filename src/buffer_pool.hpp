@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Memory resource recycling large buffers by size class.
+/// \details Requests are rounded up to a power of two from 4 KiB to 1 GiB and
+/// freed buffers are kept for the next request of the same class instead of
+/// being returned, so once every class a workload needs has been used it no
+/// longer allocates. It is meant for large buffers: put a
+/// std::pmr::monotonic_buffer_resource in front of it for small ones. Safe to
+/// share between threads.
+///
+class buffer_pool final : public std::pmr::memory_resource
+{
+public:
+	///
+	/// \brief Constructor to create an empty pool.
+	/// \param upstream: Where new buffers are allocated.
+	///
+	explicit buffer_pool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+
+	///
+	/// \brief Destructor to return the kept buffers upstream.
+	/// \details Buffers still in use must have been deallocated already.
+	///
+	~buffer_pool() noexcept override;
+
+	buffer_pool(const buffer_pool&) = delete;
+
+	buffer_pool& operator=(const buffer_pool&) = delete;
+
+	///
+	/// \brief Gets how many buffers were allocated upstream.
+	/// \returns The count, which stops growing in steady state.
+	///
+	[[nodiscard]] std::size_t get_upstream_allocations() const noexcept;
+
+private:
+	///
+	/// \brief Number of size classes, 4 KiB to 1 GiB.
+	///
+	static constexpr std::size_t CLASS_COUNT = 19;
+
+	///
+	/// \brief Takes a buffer of the request's class, kept or new.
+	/// \param bytes: The requested size.
+	/// \param alignment: The requested alignment.
+	/// \returns The buffer.
+	///
+	void* do_allocate(std::size_t bytes,
+	                  std::size_t alignment) override;
+
+	///
+	/// \brief Keeps a buffer for the next request of its class.
+	/// \param pointer: The buffer.
+	/// \param bytes: The size it was requested with.
+	/// \param alignment: The alignment it was requested with.
+	///
+	void do_deallocate(void*       pointer,
+	                   std::size_t bytes,
+	                   std::size_t alignment) override;
+
+	///
+	/// \brief Checks whether buffers of another resource can be freed here.
+	/// \param other: The other resource.
+	/// \returns true only for the pool itself.
+	///
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+	std::pmr::memory_resource*     upstream;             ///< Where new buffers are allocated.
+	std::mutex                     mutex;                ///< Guards the free lists.
+	std::array<void*, CLASS_COUNT> free_buffers;         ///< Kept buffers per class, linked through their first bytes.
+	std::atomic<std::size_t>       upstream_allocations; ///< Buffers allocated upstream.
+};
+
+} // namespace icon_changer
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "dpi_icon.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "bitmap.hpp"
+#include "logger.hpp"
+#include "parallel.hpp"
+#include "rgba_image.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Range of the DPI scales Windows offers, in percent.
+///
+static constexpr std::uint32_t MIN_SCALE = 100;
+static constexpr std::uint32_t MAX_SCALE = 500;
+
+///
+/// \brief Sizes of the shell contexts at 100%, in pixels.
+///
+static constexpr std::uint32_t SMALL_SIZE = 16;
+static constexpr std::uint32_t LARGE_SIZE = 32;
+static constexpr std::uint32_t JUMBO_SIZE = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Splits a comma separated list.
+/// \param list: The list.
+/// \returns The items, empty ones included.
+///
+static std::vector<std::string_view> split_list(std::string_view list);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::uint32_t> parse_scales(const std::string_view list)
+{
+	std::vector<std::uint32_t> scales = {};
+
+	for (const std::string_view item : split_list(list))
+	{
+		std::uint32_t              scale  = 0;
+		const std::from_chars_result result = std::from_chars(item.data(), item.data() + item.size(), scale);
+
+		if (std::errc{} != result.ec || item.data() + item.size() != result.ptr || MIN_SCALE > scale || MAX_SCALE < scale)
+		{
+			throw std::invalid_argument{ std::format("DPI scale \"{}\" is invalid, expecting {} to {}!", item, MIN_SCALE, MAX_SCALE) };
+		}
+
+		scales.push_back(scale);
+	}
+
+	return scales;
+}
+
+std::vector<shell_context> parse_contexts(const std::string_view list)
+{
+	std::vector<shell_context> contexts = {};
+
+	for (const std::string_view item : split_list(list))
+	{
+		if ("small" == item)
+		{
+			contexts.push_back(shell_context::small);
+		}
+		else if ("large" == item)
+		{
+			contexts.push_back(shell_context::large);
+		}
+		else if ("jumbo" == item)
+		{
+			contexts.push_back(shell_context::jumbo);
+		}
+		else
+		{
+			throw std::invalid_argument{ std::format("Shell context \"{}\" is invalid, expecting small, large or jumbo!", item) };
+		}
+	}
+
+	return contexts;
+}
+
+std::vector<std::uint32_t> select_icon_sizes(const std::span<const std::uint32_t> scales,
+                                             const std::span<const shell_context> contexts)
+{
+	std::vector<std::uint32_t> sizes = {};
+
+	for (const shell_context context : contexts)
+	{
+		for (const std::uint32_t scale : scales)
+		{
+			if (shell_context::jumbo == context)
+			{
+				// Larger jumbo icons are always scaled from the 256 pixels entry.
+				sizes.push_back(JUMBO_SIZE);
+				continue;
+			}
+
+			const std::uint32_t base = shell_context::small == context ? SMALL_SIZE : LARGE_SIZE;
+
+			sizes.push_back(std::min(JUMBO_SIZE, (base * scale + 50) / 100));
+		}
+	}
+
+	std::sort(sizes.begin(), sizes.end());
+	sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+	return sizes;
+}
+
+std::vector<std::uint32_t> write_dpi_icon(const std::string_view               master_path,
+                                          const std::string_view               output_path,
+                                          const std::span<const std::uint32_t> scales,
+                                          const std::span<const shell_context> contexts)
+{
+	const std::vector<std::uint32_t> sizes  = select_icon_sizes(scales, contexts);
+	bitmap                           master = {};
+
+	if (sizes.empty())
+	{
+		throw std::invalid_argument{ "At least one DPI scale and one shell context are needed!" };
+	}
+
+	master.loadFromImage(std::string{ master_path });
+
+	const rgba_image master_image = rgba_image::from_bitmap(master);
+
+	if (master_image.get_width() != master_image.get_height())
+	{
+		throw std::invalid_argument{ std::format("The master image must be square, \"{}\" is {}x{}!", master_path, master_image.get_width(), master_image.get_height()) };
+	}
+
+	if (master_image.get_width() < sizes.back())
+	{
+		LOG("The master image ({} pixels) is enlarged to {} pixels.", master_image.get_width(), sizes.back());
+	}
+
+	std::vector<std::optional<rgba_image>> resized = std::vector<std::optional<rgba_image>>(sizes.size());
+	std::vector<rgba_image>                images  = {};
+
+	parallel_for(sizes.size(), [&resized, &sizes, &master_image](const std::size_t index)
+	{
+		resized[index] = master_image.resize(sizes[index], sizes[index]);
+	});
+
+	for (std::optional<rgba_image>& image : resized)
+	{
+		images.push_back(std::move(image).value());
+	}
+
+	const std::vector<std::uint8_t> bytes = rgba_image::encode_ico(images);
+	std::ofstream                   file  = std::ofstream{ std::string{ output_path }, std::ios::binary };
+
+	if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to write \"{}\"!", output_path) };
+	}
+
+	return sizes;
+}
+
+static std::vector<std::string_view> split_list(const std::string_view list)
+{
+	std::vector<std::string_view> items = {};
+	std::size_t                   begin = 0;
+
+	while (true)
+	{
+		const std::size_t end = list.find(',', begin);
+
+		items.push_back(list.substr(begin, std::string_view::npos == end ? std::string_view::npos : end - begin));
+
+		if (std::string_view::npos == end)
+		{
+			return items;
+		}
+
+		begin = end + 1;
+	}
+}
+
+} // namespace icon_changer
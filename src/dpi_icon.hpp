@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Where the Windows shell shows an icon.
+///
+enum class shell_context
+{
+	small, ///< Title bars, lists and the notification area: 16 pixels at 100%.
+	large, ///< The desktop and "Large icons" views: 32 pixels at 100%.
+	jumbo, ///< "Extra large icons" and thumbnails: 256 pixels, the largest ICO size.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Parses a comma separated list of DPI scales (e.g. "100,150,200").
+/// \param list: The list, percentages between 100 and 500.
+/// \returns The scales.
+///
+extern std::vector<std::uint32_t> parse_scales(std::string_view list);
+
+///
+/// \brief Parses a comma separated list of shell contexts (e.g. "small,jumbo").
+/// \param list: The list of "small", "large" and "jumbo".
+/// \returns The contexts.
+///
+extern std::vector<shell_context> parse_contexts(std::string_view list);
+
+///
+/// \brief Derives the entry sizes Windows picks for the contexts at the scales.
+/// \details The shell asks for the context size multiplied by the scale and
+/// uses an entry of exactly that size when the icon has one; any other size
+/// is resampled on the fly and comes out blurry. Jumbo icons are never larger
+/// than 256 pixels.
+/// \param scales: The DPI scales, in percent.
+/// \param contexts: The shell contexts.
+/// \returns The sizes, ascending and without duplicates.
+///
+extern std::vector<std::uint32_t> select_icon_sizes(std::span<const std::uint32_t> scales,
+                                                    std::span<const shell_context> contexts);
+
+///
+/// \brief Generates an ICO file with exactly the sizes Windows picks.
+/// \details The master is decoded once and the sizes are resampled from it in
+/// parallel.
+/// \param master_path: The path to the master image, a square 24-bit or
+/// 32-bit BMP file.
+/// \param output_path: The path to the ICO file.
+/// \param scales: The DPI scales, in percent.
+/// \param contexts: The shell contexts.
+/// \returns The sizes written.
+///
+extern std::vector<std::uint32_t> write_dpi_icon(std::string_view               master_path,
+                                                 std::string_view               output_path,
+                                                 std::span<const std::uint32_t> scales,
+                                                 std::span<const shell_context> contexts);
+
+} // namespace icon_changer
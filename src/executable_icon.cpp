@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "executable_icon.hpp"
+
+#include <cstring>
+#include <format>
+#include <map>
+#include <optional>
+#include <stdexcept>
+
+#include "icon.hpp"
+#include "logger.hpp"
+#include "pe_image.hpp"
+#include "resource_tree.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+executable_icon::executable_icon(const std::string_view file_path)
+    : file{ std::make_shared<const mapped_file>(file_path) }
+    , header{}
+    , images{}
+{
+	const pe_image::resource_view                                                    resources = pe_image::find_resources(file->get_bytes());
+	std::map<std::uint16_t, std::map<std::uint16_t, std::span<const std::uint8_t>>> icons     = {};
+	std::optional<std::span<const std::uint8_t>>                                     group     = std::nullopt;
+	std::uint16_t                                                                    language  = resource_tree::NEUTRAL_LANGUAGE;
+
+	if (resources.directory.empty())
+	{
+		throw std::invalid_argument{ std::format("\"{}\" has no resources!", file_path) };
+	}
+
+	// RT_ICON sorts before RT_GROUP_ICON, so every image is known once the first group is found.
+	resource_tree::visit(resources.directory, resources.rva,
+	                     [&icons, &group, &language](const resource_id& type, const resource_id& name, const std::uint16_t resource_language,
+	                                                 const std::span<const std::uint8_t> data, std::uint32_t)
+	                     {
+		                     if (resource_id{ resource_type::icon } == type && !name.is_named())
+		                     {
+			                     icons[name.get_id()].try_emplace(resource_language, data);
+		                     }
+		                     else if (resource_id{ resource_type::group_icon } == type && !group.has_value())
+		                     {
+			                     group    = data;
+			                     language = resource_language;
+		                     }
+	                     });
+
+	icon::header group_header = {};
+
+	if (!group.has_value())
+	{
+		throw std::invalid_argument{ std::format("\"{}\" has no icon!", file_path) };
+	}
+
+	if (group->size() < sizeof(group_header))
+	{
+		throw std::invalid_argument{ std::format("The icon group of \"{}\" is truncated!", file_path) };
+	}
+
+	std::memcpy(&group_header, group->data(), sizeof(group_header));
+
+	if (1 != group_header.type || 0 == group_header.entries_count || group->size() < sizeof(group_header) + group_header.entries_count * sizeof(icon::entry))
+	{
+		throw std::invalid_argument{ std::format("The icon group of \"{}\" is invalid!", file_path) };
+	}
+
+	header.assign(group->begin(), group->begin() + sizeof(group_header) + group_header.entries_count * sizeof(icon::entry));
+
+	for (std::uint16_t index = 0; index < group_header.entries_count; ++index)
+	{
+		const std::size_t offset = sizeof(group_header) + index * sizeof(icon::entry);
+		icon::entry       entry  = {};
+
+		std::memcpy(&entry, header.data() + offset, sizeof(entry));
+
+		const auto icon = icons.find(entry.icon_id);
+
+		if (icons.end() == icon)
+		{
+			throw std::invalid_argument{ std::format("Icon {} of \"{}\" is missing!", entry.icon_id, file_path) };
+		}
+
+		// Prefer the image in the language of the group, like the loader does.
+		const auto image = icon->second.find(language);
+
+		const std::span<const std::uint8_t> payload = icon->second.end() == image ? icon->second.begin()->second : image->second;
+
+		images.push_back({ file, static_cast<std::uint64_t>(payload.data() - file->get_bytes().data()), static_cast<std::uint32_t>(payload.size()) });
+
+		entry.icon_id = static_cast<std::uint16_t>(index + 1);
+		std::memcpy(header.data() + offset, &entry, sizeof(entry));
+	}
+
+	LOG("Read {} icon image(s) from \"{}\".", images.size(), file_path);
+}
+
+const std::vector<std::uint8_t>& executable_icon::get_header() const noexcept
+{
+	return header;
+}
+
+const std::vector<file_range>& executable_icon::get_images() const noexcept
+{
+	return images;
+}
+
+} // namespace icon_changer
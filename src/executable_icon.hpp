@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The icon of an executable, read from its resources in place.
+/// \details The executable is memory mapped and the first RT_GROUP_ICON (the
+/// one the shell shows) is located together with the RT_ICON resources it
+/// refers to. The images are not copied: they are ranges of the mapping, so
+/// they are spliced into another executable with a single copy and without
+/// being decoded.
+///
+class executable_icon final
+{
+public:
+	///
+	/// \brief Constructor to read the icon of an executable.
+	/// \param file_path: The path to the executable.
+	///
+	explicit executable_icon(std::string_view file_path);
+
+	///
+	/// \brief Gets the group header (NEWHEADER + RESDIR) of the icon.
+	/// \details The RT_ICON identifiers are renumbered from 1, in the order of
+	/// get_images().
+	/// \returns The serialized header.
+	///
+	[[nodiscard]] const std::vector<std::uint8_t>& get_header() const noexcept;
+
+	///
+	/// \brief Gets the images of the icon.
+	/// \returns The RT_ICON payloads, ranges of the mapped executable which
+	/// they keep mapped.
+	///
+	[[nodiscard]] const std::vector<file_range>& get_images() const noexcept;
+
+private:
+	std::shared_ptr<const mapped_file> file;   ///< The mapped executable.
+	std::vector<std::uint8_t>          header; ///< The renumbered group header.
+	std::vector<file_range>            images; ///< The RT_ICON payloads.
+};
+
+} // namespace icon_changer
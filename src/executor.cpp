@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "executor.hpp"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+thread_pool_executor::thread_pool_executor(const std::size_t thread_count)
+    : mutex{}
+    , available{}
+    , queue{}
+    , threads{}
+{
+	threads.reserve(std::max<std::size_t>(1, thread_count));
+
+	for (std::size_t index = 0; index < std::max<std::size_t>(1, thread_count); ++index)
+	{
+		threads.emplace_back([this](const std::stop_token& stop)
+		{
+			run(stop);
+		});
+	}
+}
+
+thread_pool_executor::~thread_pool_executor() noexcept
+{
+	for (std::jthread& thread : threads)
+	{
+		thread.request_stop();
+	}
+
+	threads.clear();
+}
+
+void thread_pool_executor::post(const std::coroutine_handle<> coroutine)
+{
+	{
+		const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ mutex };
+
+		queue.push_back(coroutine);
+	}
+
+	available.notify_one();
+}
+
+void thread_pool_executor::run(const std::stop_token& stop)
+{
+	while (true)
+	{
+		std::coroutine_handle<> coroutine = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>{ mutex };
+
+			if (!available.wait(lock, stop, [this]()
+			{
+				return !queue.empty();
+			}))
+			{
+				return;
+			}
+
+			coroutine = queue.front();
+			queue.pop_front();
+		}
+
+		coroutine.resume();
+	}
+}
+
+} // namespace icon_changer
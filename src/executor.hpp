@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Where coroutines are resumed.
+/// \details The asynchronous API (see async_api.hpp) hops onto an executor
+/// before touching files, so the host decides which threads do the blocking
+/// I/O: a thread pool, or its own event loop.
+///
+class executor
+{
+public:
+	///
+	/// \brief Suspends the awaiting coroutine and resumes it on the executor.
+	///
+	struct schedule_awaiter final
+	{
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(const std::coroutine_handle<> coroutine) const
+		{
+			target.post(coroutine);
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+
+		executor& target; ///< The executor to resume on.
+	};
+
+	virtual ~executor() = default;
+
+	///
+	/// \brief Queues a coroutine to be resumed.
+	/// \param coroutine: The coroutine.
+	///
+	virtual void post(std::coroutine_handle<> coroutine) = 0;
+
+	///
+	/// \brief Moves the awaiting coroutine onto the executor.
+	/// \returns The awaiter, to be co_awaited.
+	///
+	[[nodiscard]] schedule_awaiter schedule() noexcept
+	{
+		return { *this };
+	}
+};
+
+///
+/// \brief Executor resuming coroutines on a fixed set of threads.
+/// \details Coroutines waiting for a thread cost nothing but their frame, so
+/// thousands of operations can be in flight on a few threads.
+///
+class thread_pool_executor final : public executor
+{
+public:
+	///
+	/// \brief Constructor to start the threads.
+	/// \param thread_count: The number of threads, at least 1.
+	///
+	explicit thread_pool_executor(std::size_t thread_count = std::thread::hardware_concurrency());
+
+	///
+	/// \brief Destructor to stop the threads.
+	/// \details Coroutines still queued are never resumed, so every task must
+	/// have finished before.
+	///
+	~thread_pool_executor() noexcept override;
+
+	thread_pool_executor(const thread_pool_executor&) = delete;
+
+	thread_pool_executor& operator=(const thread_pool_executor&) = delete;
+
+	///
+	/// \brief Queues a coroutine to be resumed on one of the threads.
+	/// \param coroutine: The coroutine.
+	///
+	void post(std::coroutine_handle<> coroutine) override;
+
+private:
+	///
+	/// \brief Resumes queued coroutines until the executor is destroyed.
+	/// \param stop: Signals the destruction.
+	///
+	void run(const std::stop_token& stop);
+
+private:
+	std::mutex                          mutex;     ///< Guards the queue.
+	std::condition_variable_any         available; ///< Signals queued coroutines.
+	std::deque<std::coroutine_handle<>> queue;     ///< The coroutines to be resumed.
+	std::vector<std::jthread>           threads;   ///< The threads, stopped and joined first on destruction.
+};
+
+} // namespace icon_changer
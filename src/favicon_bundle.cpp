@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "favicon_bundle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bitmap.hpp"
+#include "logger.hpp"
+#include "parallel.hpp"
+#include "rgba_image.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief A file of the bundle.
+///
+struct bundle_file final
+{
+	///
+	/// \brief Produces the contents of a file from the resampled images.
+	///
+	using encoder = std::function<std::vector<std::uint8_t>(const std::vector<std::optional<rgba_image>>&)>;
+
+	std::string_view name;   ///< The file name.
+	encoder          encode; ///< Produces the contents of the file.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Every size of the bundle, each is resampled once.
+///
+static constexpr std::array<std::uint32_t, 6> BUNDLE_SIZES = { 16, 32, 48, 180, 192, 512 };
+
+///
+/// \brief The sizes stored in favicon.ico.
+///
+static constexpr std::array<std::uint32_t, 3> FAVICON_SIZES = { 16, 32, 48 };
+
+///
+/// \brief The sizes listed in site.webmanifest.
+///
+static constexpr std::array<std::uint32_t, 2> MANIFEST_SIZES = { 192, 512 };
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Finds the resampled image of a bundle size.
+/// \param images: The images, in the order of BUNDLE_SIZES.
+/// \param size: One of BUNDLE_SIZES.
+/// \returns The image.
+///
+static const rgba_image& find_image(const std::vector<std::optional<rgba_image>>& images,
+                                    std::uint32_t                                  size);
+
+///
+/// \brief Builds site.webmanifest.
+/// \returns The bytes of the manifest.
+///
+static std::vector<std::uint8_t> encode_manifest();
+
+///
+/// \brief Writes a file unless it already has the same contents.
+/// \details The file is compared by size first and by SHA-256 only when the
+/// sizes match, so unchanged large files are read once and changed ones never.
+/// \param file_path: The path to the file.
+/// \param bytes: The new contents.
+/// \returns true if the file was written, false if it was up to date.
+///
+static bool write_if_changed(const std::filesystem::path&  file_path,
+                             std::span<const std::uint8_t> bytes);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+bundle_report write_favicon_bundle(const std::string_view master_path,
+                                   const std::string_view output_directory)
+{
+	static const std::array<bundle_file, 7> FILES = { {
+		{ "favicon.ico", [](const std::vector<std::optional<rgba_image>>& images)
+		{
+			std::vector<rgba_image> entries = {};
+
+			for (const std::uint32_t size : FAVICON_SIZES)
+			{
+				entries.push_back(find_image(images, size));
+			}
+
+			return rgba_image::encode_ico(entries);
+		} },
+		{ "favicon-16x16.png", [](const std::vector<std::optional<rgba_image>>& images) { return find_image(images, 16).to_png(); } },
+		{ "favicon-32x32.png", [](const std::vector<std::optional<rgba_image>>& images) { return find_image(images, 32).to_png(); } },
+		{ "apple-touch-icon.png", [](const std::vector<std::optional<rgba_image>>& images) { return find_image(images, 180).to_png(); } },
+		{ "android-chrome-192x192.png", [](const std::vector<std::optional<rgba_image>>& images) { return find_image(images, 192).to_png(); } },
+		{ "android-chrome-512x512.png", [](const std::vector<std::optional<rgba_image>>& images) { return find_image(images, 512).to_png(); } },
+		{ "site.webmanifest", [](const std::vector<std::optional<rgba_image>>&) { return encode_manifest(); } },
+	} };
+
+	bitmap master = {};
+
+	master.loadFromImage(std::string{ master_path });
+
+	const rgba_image master_image = rgba_image::from_bitmap(master);
+
+	if (master_image.get_width() != master_image.get_height())
+	{
+		throw std::invalid_argument{ std::format("The master image must be square, \"{}\" is {}x{}!", master_path, master_image.get_width(), master_image.get_height()) };
+	}
+
+	std::vector<std::optional<rgba_image>> images  = std::vector<std::optional<rgba_image>>(BUNDLE_SIZES.size());
+	std::vector<std::exception_ptr>        errors  = std::vector<std::exception_ptr>(FILES.size());
+	std::atomic<std::size_t>               written = 0;
+
+	parallel_for(BUNDLE_SIZES.size(), [&images, &master_image](const std::size_t index)
+	{
+		images[index] = master_image.resize(BUNDLE_SIZES[index], BUNDLE_SIZES[index]);
+	});
+
+	std::filesystem::create_directories(output_directory);
+
+	parallel_for(FILES.size(), [&images, &errors, &written, output_directory](const std::size_t index)
+	{
+		try
+		{
+			if (write_if_changed(std::filesystem::path{ output_directory } / FILES[index].name, FILES[index].encode(images)))
+			{
+				written.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		catch (...)
+		{
+			errors[index] = std::current_exception();
+		}
+	});
+
+	for (const std::exception_ptr& error : errors)
+	{
+		if (nullptr != error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	LOG("Wrote {} of {} favicon file(s).", written.load(), FILES.size());
+
+	return { written.load(), FILES.size() - written.load() };
+}
+
+static const rgba_image& find_image(const std::vector<std::optional<rgba_image>>& images,
+                                    const std::uint32_t                            size)
+{
+	return images[static_cast<std::size_t>(std::find(BUNDLE_SIZES.begin(), BUNDLE_SIZES.end(), size) - BUNDLE_SIZES.begin())].value();
+}
+
+static std::vector<std::uint8_t> encode_manifest()
+{
+	std::string manifest = "{\n  \"icons\": [\n";
+
+	for (const std::uint32_t size : MANIFEST_SIZES)
+	{
+		std::format_to(std::back_inserter(manifest), "    {{ \"src\": \"/android-chrome-{0}x{0}.png\", \"sizes\": \"{0}x{0}\", \"type\": \"image/png\" }}{1}\n", size,
+		               MANIFEST_SIZES.back() == size ? "" : ",");
+	}
+
+	manifest += "  ],\n  \"display\": \"standalone\"\n}\n";
+
+	return { manifest.begin(), manifest.end() };
+}
+
+static bool write_if_changed(const std::filesystem::path&        file_path,
+                             const std::span<const std::uint8_t> bytes)
+{
+	std::error_code error = {};
+
+	if (bytes.size() == std::filesystem::file_size(file_path, error) && !error &&
+	    sha256::hash(bytes) == sha256::hash_file(file_path.string()))
+	{
+		return false;
+	}
+
+	std::ofstream file = std::ofstream{ file_path, std::ios::binary };
+
+	if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to write \"{}\"!", file_path.string()) };
+	}
+
+	return true;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief What write_favicon_bundle() did with the files of the bundle.
+///
+struct bundle_report final
+{
+	std::size_t written;   ///< Files created or replaced.
+	std::size_t unchanged; ///< Files whose contents were already up to date.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Generates the icons a web site links to from a single master image.
+/// \details The master is decoded once and every size is resampled from it in
+/// parallel. The bundle holds favicon.ico (16, 32 and 48 pixels), the 16 and
+/// 32 pixel PNG favicons, apple-touch-icon.png (180 pixels), the Android
+/// icons (192 and 512 pixels) and a site.webmanifest referring to them. Files
+/// whose contents would not change are not rewritten.
+/// \param master_path: The path to the master image, a square 24-bit or
+/// 32-bit BMP file.
+/// \param output_directory: The directory receiving the bundle, created if
+/// needed.
+/// \returns How many files were written and skipped.
+///
+extern bundle_report write_favicon_bundle(std::string_view master_path,
+                                          std::string_view output_directory);
+
+} // namespace icon_changer
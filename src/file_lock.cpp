@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "file_lock.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#include "logger.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+#ifdef _WIN32
+
+///
+/// \brief The byte locked on Windows.
+/// \details Windows byte-range locks are mandatory, so locking the contents
+/// would also fail every read of the target, even through our own handles.
+/// A single byte far past the end of any file serializes the holders
+/// without getting in the way of the data.
+///
+static constexpr DWORD LOCK_OFFSET_LOW  = 0xFFFFFFFE;
+static constexpr DWORD LOCK_OFFSET_HIGH = 0xFFFFFFFF;
+static constexpr DWORD LOCK_LENGTH      = 1;
+
+file_lock::file_lock(const std::string_view file_path)
+    : handle{ INVALID_HANDLE_VALUE }
+{
+	const std::string path = std::string{ file_path };
+
+	while (true)
+	{
+		OVERLAPPED                 overlapped = {};
+		BY_HANDLE_FILE_INFORMATION locked     = {};
+		BY_HANDLE_FILE_INFORMATION current    = {};
+
+		overlapped.Offset     = LOCK_OFFSET_LOW;
+		overlapped.OffsetHigh = LOCK_OFFSET_HIGH;
+
+		// FILE_SHARE_DELETE lets the holder rename the new file over the locked one.
+		handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (INVALID_HANDLE_VALUE == handle)
+		{
+			throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+		}
+
+		if (FALSE == LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, LOCK_LENGTH, 0, &overlapped))
+		{
+			CloseHandle(handle);
+			throw std::runtime_error{ std::format("Failed to lock \"{}\"!", file_path) };
+		}
+
+		// The previous holder may have replaced the file while we were waiting.
+		const HANDLE other = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		const bool   same  = INVALID_HANDLE_VALUE != other && FALSE != GetFileInformationByHandle(handle, &locked) &&
+		                     FALSE != GetFileInformationByHandle(other, &current) && locked.dwVolumeSerialNumber == current.dwVolumeSerialNumber &&
+		                     locked.nFileIndexHigh == current.nFileIndexHigh && locked.nFileIndexLow == current.nFileIndexLow;
+
+		if (INVALID_HANDLE_VALUE != other)
+		{
+			CloseHandle(other);
+		}
+
+		if (same)
+		{
+			return;
+		}
+
+		LOG("\"{}\" was replaced while waiting for the lock, retrying.", file_path);
+		UnlockFileEx(handle, 0, LOCK_LENGTH, 0, &overlapped);
+		CloseHandle(handle);
+	}
+}
+
+file_lock::~file_lock() noexcept
+{
+	OVERLAPPED overlapped = {};
+
+	overlapped.Offset     = LOCK_OFFSET_LOW;
+	overlapped.OffsetHigh = LOCK_OFFSET_HIGH;
+
+	UnlockFileEx(handle, 0, LOCK_LENGTH, 0, &overlapped);
+	CloseHandle(handle);
+}
+
+#else
+
+file_lock::file_lock(const std::string_view file_path)
+    : descriptor{ -1 }
+{
+	const std::string path = std::string{ file_path };
+
+	while (true)
+	{
+		struct stat locked  = {};
+		struct stat current = {};
+
+		descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (-1 == descriptor)
+		{
+			throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+		}
+
+		if (-1 == flock(descriptor, LOCK_EX))
+		{
+			close(descriptor);
+			throw std::runtime_error{ std::format("Failed to lock \"{}\"!", file_path) };
+		}
+
+		// The previous holder may have replaced the file while we were waiting.
+		if (0 == fstat(descriptor, &locked) && 0 == stat(path.c_str(), &current) && locked.st_dev == current.st_dev && locked.st_ino == current.st_ino)
+		{
+			return;
+		}
+
+		LOG("\"{}\" was replaced while waiting for the lock, retrying.", file_path);
+		close(descriptor);
+	}
+}
+
+file_lock::~file_lock() noexcept
+{
+	// Closing the last descriptor of the open file description releases the lock.
+	close(descriptor);
+}
+
+#endif
+
+} // namespace icon_changer
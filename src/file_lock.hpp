@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Exclusive advisory lock on a file, held for the object's lifetime.
+/// \details Serializes concurrent updates of the same executable, including
+/// updates from other processes. Because saving renames a new file over the
+/// target, the lock is retried until it is held on the file currently at the
+/// path, so a waiter never works on a file that was already replaced.
+///
+class file_lock final
+{
+public:
+	///
+	/// \brief Constructor to block until the file is locked.
+	/// \param file_path: The path to the file, which must exist.
+	///
+	explicit file_lock(std::string_view file_path);
+
+	///
+	/// \brief Destructor to release the lock.
+	///
+	~file_lock() noexcept;
+
+	file_lock(const file_lock&) = delete;
+
+	file_lock& operator=(const file_lock&) = delete;
+
+private:
+#ifdef _WIN32
+	void* handle; ///< The locked file handle.
+#else
+	std::int32_t descriptor; ///< The locked file descriptor.
+#endif
+};
+
+} // namespace icon_changer
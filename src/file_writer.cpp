@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "file_writer.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "metrics.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+#ifdef _WIN32
+
+file_writer::file_writer(const std::string_view file_path)
+    : path{ file_path }
+    , handle{ CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) }
+{
+	if (INVALID_HANDLE_VALUE == handle)
+	{
+		throw std::runtime_error{ std::format("Failed to create \"{}\"!", file_path) };
+	}
+}
+
+file_writer::~file_writer() noexcept
+{
+	CloseHandle(handle);
+}
+
+void file_writer::write(std::span<const std::uint8_t> bytes)
+{
+	while (!bytes.empty())
+	{
+		DWORD written = 0;
+
+		if (FALSE == WriteFile(handle, bytes.data(), static_cast<DWORD>(std::min<std::size_t>(bytes.size(), MAXDWORD)), &written, nullptr))
+		{
+			throw std::runtime_error{ std::format("Failed to write \"{}\"!", path) };
+		}
+
+		add(counter::bytes_written, written);
+		bytes = bytes.subspan(written);
+	}
+}
+
+void file_writer::copy(const mapped_file&  source,
+                       const std::uint64_t offset,
+                       const std::uint64_t size)
+{
+	if (source.get_bytes().size() < offset || source.get_bytes().size() - offset < size)
+	{
+		throw std::logic_error{ std::format("Range {}+{} is outside of the source of \"{}\"!", offset, size, path) };
+	}
+
+	write(source.get_bytes().subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(size)));
+}
+
+#else
+
+file_writer::file_writer(const std::string_view file_path)
+    : path{ file_path }
+    , descriptor{ open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666) }
+    , filesystem{ filesystem_kind::local }
+{
+	if (-1 == descriptor)
+	{
+		throw std::runtime_error{ std::format("Failed to create \"{}\"!", file_path) };
+	}
+
+	filesystem = detect_filesystem(path);
+}
+
+file_writer::~file_writer() noexcept
+{
+	close(descriptor);
+}
+
+void file_writer::write(std::span<const std::uint8_t> bytes)
+{
+	while (!bytes.empty())
+	{
+		const ssize_t written = ::write(descriptor, bytes.data(), bytes.size());
+
+		if (0 > written && EINTR != errno)
+		{
+			throw std::runtime_error{ std::format("Failed to write \"{}\"!", path) };
+		}
+
+		add(counter::bytes_written, static_cast<std::uint64_t>(std::max<ssize_t>(written, 0)));
+		bytes = bytes.subspan(static_cast<std::size_t>(std::max<ssize_t>(written, 0)));
+	}
+}
+
+void file_writer::copy(const mapped_file&  source,
+                       const std::uint64_t offset,
+                       const std::uint64_t size)
+{
+	if (source.get_bytes().size() < offset || source.get_bytes().size() - offset < size)
+	{
+		throw std::logic_error{ std::format("Range {}+{} is outside of the source of \"{}\"!", offset, size, path) };
+	}
+
+	if (!should_splice(filesystem, size))
+	{
+		write(source.get_bytes().subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(size)));
+		return;
+	}
+
+	off_t         source_offset = static_cast<off_t>(offset);
+	std::uint64_t remaining     = size;
+
+	while (0 != remaining)
+	{
+		const ssize_t copied = copy_file_range(source.get_descriptor(), &source_offset, descriptor, nullptr, remaining, 0);
+
+		if (0 < copied)
+		{
+			add(counter::bytes_written, static_cast<std::uint64_t>(copied));
+			remaining -= static_cast<std::uint64_t>(copied);
+		}
+		else if (0 > copied && EINTR == errno)
+		{
+			continue;
+		}
+		else
+		{
+			// Unsupported by the kernel or the file systems (or the source shrank):
+			// finish from the mapping.
+			write(source.get_bytes().subspan(static_cast<std::size_t>(offset + size - remaining), static_cast<std::size_t>(remaining)));
+			break;
+		}
+	}
+}
+
+#endif
+
+} // namespace icon_changer
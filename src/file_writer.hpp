@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "io_strategy.hpp"
+#include "mapped_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Sequential writer of a new file that can splice ranges of other
+/// files into it.
+/// \details On Linux the ranges are copied with copy_file_range, so they never
+/// pass through user space (and are reflinked on file systems that support
+/// it). Elsewhere, for ranges below the splice threshold of the file system
+/// (see should_splice()), or when the kernel refuses, they are written from
+/// the mapping of the source.
+///
+class file_writer final
+{
+public:
+	///
+	/// \brief Constructor to create (or truncate) a file.
+	/// \param file_path: The path to the file.
+	///
+	explicit file_writer(std::string_view file_path);
+
+	///
+	/// \brief Destructor to close the file.
+	///
+	~file_writer() noexcept;
+
+	file_writer(const file_writer&) = delete;
+
+	file_writer& operator=(const file_writer&) = delete;
+
+	///
+	/// \brief Appends bytes from memory.
+	/// \param bytes: The bytes.
+	///
+	void write(std::span<const std::uint8_t> bytes);
+
+	///
+	/// \brief Appends a range of another file.
+	/// \param source: The source file.
+	/// \param offset: The offset of the range in the source.
+	/// \param size: The size of the range in bytes.
+	///
+	void copy(const mapped_file& source,
+	          std::uint64_t      offset,
+	          std::uint64_t      size);
+
+private:
+	std::string path; ///< The path, for error messages.
+#ifdef _WIN32
+	void* handle; ///< The file handle.
+#else
+	std::int32_t    descriptor; ///< The file descriptor.
+	filesystem_kind filesystem; ///< The file system of the file, for should_splice().
+#endif
+};
+
+} // namespace icon_changer
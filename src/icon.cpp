@@ -17,29 +17,89 @@
 
 #include "icon.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <format>
 #include <filesystem> //for std::remove
+#include <tuple>
 
 #include "logger.hpp"
 #include "bitmap.hpp"
+#include "io_strategy.hpp"
+#include "metrics.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
-// METHOD DEFINITIONS
+// LOCAL VARIABLES
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace icon_changer
 {
 
-icon::icon(const std::string_view file_path)
+///
+/// \brief Image types of the ICONDIR header.
+///
+static constexpr std::uint16_t ICO_IMAGE_TYPE = 0x0001;
+static constexpr std::uint16_t CUR_IMAGE_TYPE = 0x0002;
+
+///
+/// \brief Sizes of BITMAPINFOHEADER and BITMAPV5HEADER, the range of DIB
+/// headers carrying a bit count (PNG images start with a larger value).
+///
+static constexpr std::uint32_t DIB_HEADER_SIZE    = 40;
+static constexpr std::uint32_t DIB_V5_HEADER_SIZE = 124;
+
+///
+/// \brief Offset of biBitCount in BITMAPINFOHEADER.
+///
+static constexpr std::size_t DIB_BIT_COUNT_OFFSET = 14;
+
+///
+/// \brief The 8 bytes every PNG file starts with.
+///
+static constexpr std::array<std::uint8_t, 8> PNG_MAGIC = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+///
+/// \brief Offsets of the IHDR fields in a PNG file.
+///
+static constexpr std::size_t PNG_WIDTH_OFFSET      = 16;
+static constexpr std::size_t PNG_HEIGHT_OFFSET     = 20;
+static constexpr std::size_t PNG_BIT_DEPTH_OFFSET  = 24;
+static constexpr std::size_t PNG_COLOR_TYPE_OFFSET = 25;
+
+///
+/// \brief Number of channels of every PNG color type (0, 2, 3, 4 and 6).
+///
+static constexpr std::array<std::uint16_t, 7> PNG_CHANNELS = { 1, 0, 3, 1, 2, 0, 4 };
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+icon::icon(const std::string_view           file_path,
+           const bool                       mapped,
+           std::pmr::memory_resource* const resource)
     : resource_header{}
     , resource_entries{}
-    , images{}
+    , cursor_entries{}
+    , images{ resource }
+    , image_ranges{}
+    , reservation{}
 {
 	std::ifstream                 file    = open_file(file_path);
 	const std::vector<icon_entry> entries = read_icon_entries(file);
 
-	read_images(file, entries);
+	const bool map = mapped && !is_cursor() && read_method::mapped == select_read_method(file_path);
+
+	read_images(file, entries, map ? std::make_shared<const mapped_file>(file_path) : nullptr);
+
+	if (is_cursor())
+	{
+		convert_cursor_entries(entries);
+		return;
+	}
+
 	convert_entries(entries);
 }
 
@@ -57,14 +117,102 @@ std::vector<std::uint8_t> icon::get_header() const
 		serialized_header.insert(serialized_header.end(), entry_bytes.begin(), entry_bytes.end());
 	}
 
+	for (const cursor_entry& e : cursor_entries)
+	{
+		entry_bytes = serialize(e);
+		serialized_header.insert(serialized_header.end(), entry_bytes.begin(), entry_bytes.end());
+	}
+
 	return serialized_header;
 }
 
-std::vector<std::vector<std::uint8_t>>& icon::get_images() noexcept
+std::pmr::vector<std::pmr::vector<std::uint8_t>>& icon::get_images() noexcept
 {
 	return images;
 }
 
+const std::vector<file_range>& icon::get_image_ranges() const noexcept
+{
+	return image_ranges;
+}
+
+bool icon::is_cursor() const noexcept
+{
+	return CUR_IMAGE_TYPE == resource_header.type;
+}
+
+void icon::renumber(std::uint16_t first_id) noexcept
+{
+	for (entry& e : resource_entries)
+	{
+		e.icon_id = first_id++;
+	}
+
+	for (cursor_entry& e : cursor_entries)
+	{
+		e.cursor_id = first_id++;
+	}
+}
+
+std::size_t icon::find_best_entry(const std::uint32_t width,
+                                  const std::uint32_t height,
+                                  const std::uint16_t display_bit_count) const
+{
+	using score = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>;
+
+	const std::size_t count      = is_cursor() ? cursor_entries.size() : resource_entries.size();
+	std::size_t       best_index = 0;
+	score             best_score = { UINT32_MAX, UINT32_MAX, UINT32_MAX };
+
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		const image_metrics metrics        = get_metrics(index);
+		const std::uint32_t size_distance  = std::max(metrics.width, width) - std::min(metrics.width, width) + std::max(metrics.height, height) - std::min(metrics.height, height);
+		const std::uint32_t depth_distance = std::max(metrics.bit_count, display_bit_count) - std::min(metrics.bit_count, display_bit_count);
+
+		// Size distance first, then the larger entry, then the depth distance.
+		const score current = { size_distance, UINT32_MAX - metrics.width, depth_distance };
+
+		if (current < best_score)
+		{
+			best_index = index;
+			best_score = current;
+		}
+	}
+
+	return best_index;
+}
+
+icon::image_metrics icon::get_metrics(const std::size_t index) const
+{
+	if (is_cursor())
+	{
+		// The bit count was taken from the DIB header when the cursor was read.
+		return { cursor_entries[index].width, cursor_entries[index].height / 2u, cursor_entries[index].bit_count };
+	}
+
+	const entry&                        entry   = resource_entries[index];
+	const std::span<const std::uint8_t> image   = image_ranges.empty() ? std::span<const std::uint8_t>{ images[index] } : image_ranges[index].get_bytes();
+	image_metrics                       metrics = { 0 == entry.width ? 256u : entry.width, 0 == entry.height ? 256u : entry.height, entry.bit_count };
+
+	if (PNG_COLOR_TYPE_OFFSET < image.size() && std::equal(PNG_MAGIC.begin(), PNG_MAGIC.end(), image.begin()))
+	{
+		const std::uint8_t color_type = image[PNG_COLOR_TYPE_OFFSET];
+
+		metrics.width     = static_cast<std::uint32_t>(image[PNG_WIDTH_OFFSET]) << 24 | image[PNG_WIDTH_OFFSET + 1] << 16 | image[PNG_WIDTH_OFFSET + 2] << 8 | image[PNG_WIDTH_OFFSET + 3];
+		metrics.height    = static_cast<std::uint32_t>(image[PNG_HEIGHT_OFFSET]) << 24 | image[PNG_HEIGHT_OFFSET + 1] << 16 | image[PNG_HEIGHT_OFFSET + 2] << 8 | image[PNG_HEIGHT_OFFSET + 3];
+		metrics.bit_count = static_cast<std::uint16_t>(image[PNG_BIT_DEPTH_OFFSET] * (color_type < PNG_CHANNELS.size() ? PNG_CHANNELS[color_type] : 0));
+		return metrics;
+	}
+
+	if (0 == metrics.bit_count && DIB_BIT_COUNT_OFFSET + sizeof(std::uint16_t) <= image.size())
+	{
+		std::memcpy(&metrics.bit_count, image.data() + DIB_BIT_COUNT_OFFSET, sizeof(metrics.bit_count));
+	}
+
+	return metrics;
+}
+
 std::ifstream icon::open_file(const std::string_view file_path)
 {
 	std::ifstream file = std::ifstream{ file_path.data(), std::ios::binary };
@@ -98,11 +246,18 @@ std::vector<std::uint8_t> icon::serialize(const icon::entry& entry)
 	return bytes;
 }
 
-void icon::read_header(std::ifstream& file)
+std::vector<std::uint8_t> icon::serialize(const icon::cursor_entry& entry)
 {
-	static constexpr std::uint16_t ICO_IMAGE_TYPE = 0x0001;
-	static constexpr std::uint16_t CUR_IMAGE_TYPE = 0x0002;
+	std::vector<std::uint8_t> bytes = {};
+
+	bytes.resize(sizeof(entry));
+	std::memcpy(bytes.data(), &entry, sizeof(entry));
 
+	return bytes;
+}
+
+void icon::read_header(std::ifstream& file)
+{
 	try
 	{
 		file.read(reinterpret_cast<char*>(&resource_header), sizeof(resource_header));
@@ -117,12 +272,7 @@ void icon::read_header(std::ifstream& file)
 		throw std::invalid_argument{ std::format("Header reserved bytes are 0x{:X}, expecting 0x{:X}!", resource_header.reserved, 0x0000) };
 	}
 
-	if (CUR_IMAGE_TYPE == resource_header.type)
-	{
-		throw std::invalid_argument{ "Image is of CUR type, not ICO!" };
-	}
-
-	if (ICO_IMAGE_TYPE != resource_header.type)
+	if (ICO_IMAGE_TYPE != resource_header.type && CUR_IMAGE_TYPE != resource_header.type)
 	{
 		throw std::invalid_argument{ std::format("Image type 0x{:X} is invalid!", resource_header.type) };
 	}
@@ -153,10 +303,15 @@ std::vector<icon::icon_entry> icon::read_icon_entries(std::ifstream& file)
 	return entries;
 }
 
-void icon::read_images(std::ifstream&                 file,
-                       const std::vector<icon_entry>& entries)
+void icon::read_images(std::ifstream&                            file,
+                       const std::vector<icon_entry>&            entries,
+                       const std::shared_ptr<const mapped_file>& mapping)
 {
-	std::vector<std::uint8_t> image = {};
+	std::pmr::vector<std::uint8_t> image     = std::pmr::vector<std::uint8_t>{ images.get_allocator() };
+	std::uint64_t                  file_size = 0;
+
+	file.seekg(0, std::ios::end);
+	file_size = static_cast<std::uint64_t>(file.tellg());
 
 	for (const icon_entry& entry : entries)
 	{
@@ -165,15 +320,37 @@ void icon::read_images(std::ifstream&                 file,
 			throw std::invalid_argument{ std::format("Entry's reserved byte is 0x{:X}, excepting 0x{:X}!", entry.reserved, 0x00) };
 		}
 
-		if (0x0000 != entry.planes && 0x0001 != entry.planes)
+		// Cursors store the hotspot in the planes and bit count fields.
+		if (!is_cursor() && 0x0000 != entry.planes && 0x0001 != entry.planes)
 		{
 			throw std::invalid_argument{ std::format("Entry's color planes is 0x{:X}, expecting 0x{:X} or 0x{:X}!", entry.planes, 0x0000, 0x0001) };
 		}
 
+		// The payloads are found through their entries, they need not follow
+		// the directory or each other.
+		if (nullptr != mapping)
+		{
+			if (mapping->get_bytes().size() < entry.image_offset || mapping->get_bytes().size() - entry.image_offset < entry.image_size)
+			{
+				throw std::runtime_error{ "Failed to read icon image data from file." };
+			}
+
+			image_ranges.push_back({ mapping, entry.image_offset, entry.image_size });
+			continue;
+		}
+
+		// The declared size is checked against the file before anything is allocated.
+		if (file_size < entry.image_offset || file_size - entry.image_offset < entry.image_size)
+		{
+			throw std::runtime_error{ "Failed to read icon image data from file." };
+		}
+
+		reservation.grow(entry.image_size, "Icon image");
 		image.resize(entry.image_size);
 
 		try
 		{
+			file.seekg(static_cast<std::streamoff>(entry.image_offset), std::ios::beg);
 			file.read(reinterpret_cast<char*>(image.data()), image.size());
 		}
 		catch (const std::ios_base::failure& e)
@@ -181,6 +358,7 @@ void icon::read_images(std::ifstream&                 file,
 			throw std::runtime_error{ "Failed to read icon image data from file." };
 		}
 
+		add(counter::bytes_read, image.size());
 		images.push_back(std::move(image));
 	}
 }
@@ -216,6 +394,51 @@ void icon::convert_entries(const std::vector<icon_entry>& entries)
 		resource_entries.push_back(std::move(entry));
 	}
 }
+
+void icon::convert_cursor_entries(const std::vector<icon_entry>& entries)
+{
+	cursor_entry  entry     = {};
+	std::uint16_t cursor_id = 0;
+
+	for (std::size_t index = 0; index < entries.size(); ++index)
+	{
+		const hotspot                  hotspot = { entries[index].planes, entries[index].bit_count };
+		std::pmr::vector<std::uint8_t> image   = std::pmr::vector<std::uint8_t>(sizeof(hotspot) + images[index].size(), images.get_allocator());
+		std::uint32_t                  dib     = 0;
+
+		std::memcpy(image.data(), &hotspot, sizeof(hotspot));
+		std::copy(images[index].begin(), images[index].end(), image.begin() + sizeof(hotspot));
+
+		// The real bit count is only known from the DIB header, PNG images are 32 bpp.
+		entry.bit_count = 32;
+
+		if (DIB_BIT_COUNT_OFFSET + sizeof(std::uint16_t) <= images[index].size())
+		{
+			std::memcpy(&dib, images[index].data(), sizeof(dib));
+
+			if (DIB_HEADER_SIZE <= dib && DIB_V5_HEADER_SIZE >= dib)
+			{
+				std::memcpy(&entry.bit_count, images[index].data() + DIB_BIT_COUNT_OFFSET, sizeof(entry.bit_count));
+			}
+		}
+
+		entry.width         = 0 == entries[index].width ? 256 : entries[index].width;
+		entry.height        = 2 * (0 == entries[index].height ? 256 : entries[index].height);
+		entry.planes        = 1;
+		entry.resource_size = static_cast<std::uint32_t>(image.size());
+		entry.cursor_id     = ++cursor_id;
+
+		LOG("width: {}", entry.width);
+		LOG("height: {}", entry.height);
+		LOG("hotspot: {}, {}", hotspot.x, hotspot.y);
+		LOG("bit_count: {}", entry.bit_count);
+		LOG("resource_size: {}", entry.resource_size);
+		LOG("cursor_id: {}\n", entry.cursor_id);
+
+		images[index] = std::move(image);
+		cursor_entries.push_back(entry);
+	}
+}
 icon icon::from_bmp(const std::string_view bmp_path) 
 {
 	bitmap bmp;
@@ -18,9 +18,14 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
+#include <memory>
+#include <memory_resource>
 #include <string_view>
 #include <vector>
 
+#include "mapped_file.hpp"
+#include "memory_budget.hpp"
+
 ////////////////////////////////////////////////////////////////////////////////
 // MACROS
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,33 +54,6 @@ namespace icon_changer
 class icon final
 {
 public:
-	///
-	/// \brief Constructor to initialize icon object from a file.
-	/// \details Reads the ICO file, parses the header, entries, and images.
-	/// \param file_path: The path to the ICO file to be loaded.
-	///
-	icon(std::string_view file_path);
-
-	///
-	/// \brief Gets the serialized header data for a PE icon resource.
-	/// \details It follows the NEWHEADER and RESDIR format.
-	/// \returns A vector of bytes representing the serialized header data.
-	///
-	std::vector<std::uint8_t> get_header() const;
-
-	///
-	/// \brief Gets a reference to the image data of the icon file.
-	/// \returns A vector of vectors of bytes, where each inner vector
-	/// represents the data for one image.
-	///
-	std::vector<std::vector<std::uint8_t>>& get_images() noexcept;
-
-	/// \brief Creates an icon from a 24-bit BMP file
-	/// \brief bmp_path: Path to the source BMP file
-	/// \return icon object with one image
-	static icon from_bmp(const std::string_view bmp_path);
-
-private:
 	///
 	/// \brief This data structure corresponds to ICONDIR.
 	/// \details It also corresponds to NEWHEADER, because it's the same.
@@ -87,6 +65,16 @@ private:
 		std::uint16_t entries_count; ///< Number of images in the file.
 	};
 
+	///
+	/// \brief This data structure corresponds to LOCALHEADER.
+	/// \details It prefixes the image data of every RT_CURSOR resource.
+	///
+	struct PACKED hotspot final
+	{
+		std::uint16_t x; ///< Horizontal coordinate of the hotspot in pixels.
+		std::uint16_t y; ///< Vertical coordinate of the hotspot in pixels.
+	};
+
 	///
 	/// \brief This data structure corresponds to ICONDIRENTRY.
 	///
@@ -117,7 +105,115 @@ private:
 		std::uint16_t icon_id;       ///< Unique ordinal identifier of the RT_ICON resource.
 	};
 
+	///
+	/// \brief This data structure corresponds to RESDIR for CUR files.
+	///
+	struct PACKED cursor_entry final
+	{
+		std::uint16_t width;         ///< Cursor width in pixels.
+		std::uint16_t height;        ///< Cursor height in pixels, doubled for the XOR and AND masks.
+		std::uint16_t planes;        ///< Color planes, 1.
+		std::uint16_t bit_count;     ///< Bits per pixel.
+		std::uint32_t resource_size; ///< Size of the resource in bytes, hotspot included.
+		std::uint16_t cursor_id;     ///< Unique ordinal identifier of the RT_CURSOR resource.
+	};
+
+public:
+	///
+	/// \brief Constructor to initialize icon object from a file.
+	/// \details Reads the ICO or CUR file, parses the header, entries, and
+	/// images. For cursors the hotspot stored in the planes and bit count fields
+	/// is kept and prefixed to every image.
+	/// \param file_path: The path to the ICO or CUR file to be loaded.
+	/// \param mapped: Whether the images of an ICO file are left in the mapped
+	/// file (see get_image_ranges()) instead of being read. Cursors are always
+	/// read, their images need the hotspot prefix, and so are files the I/O
+	/// thresholds say to read (see select_read_method()).
+	/// \param resource: Where the images are allocated, e.g. a per-job arena.
+	///
+	icon(std::string_view           file_path,
+	     bool                       mapped   = false,
+	     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	///
+	/// \brief Gets the serialized header data for a PE icon or cursor resource.
+	/// \details It follows the NEWHEADER and RESDIR format, the RESDIR entries
+	/// use the cursor layout for cursors.
+	/// \returns A vector of bytes representing the serialized header data.
+	///
+	std::vector<std::uint8_t> get_header() const;
+
+	///
+	/// \brief Gets a reference to the image data of the icon file.
+	/// \details For cursors every image is an RT_CURSOR payload: the hotspot
+	/// (LOCALHEADER) followed by the image.
+	/// \returns A vector of vectors of bytes, where each inner vector
+	/// represents the data for one image.
+	///
+	std::pmr::vector<std::pmr::vector<std::uint8_t>>& get_images() noexcept;
+
+	///
+	/// \brief Gets where the images are in the mapped file.
+	/// \details Only set for ICO files loaded mapped, get_images() is empty
+	/// then. The ranges keep the file mapped.
+	/// \returns The ranges, one per image.
+	///
+	const std::vector<file_range>& get_image_ranges() const noexcept;
+
+	///
+	/// \brief Checks whether the file was a cursor.
+	/// \returns true for CUR files (RT_CURSOR), false for ICO files (RT_ICON).
+	///
+	bool is_cursor() const noexcept;
+
+	///
+	/// \brief Renumbers the resource identifiers referenced by the header.
+	/// \details Identifiers start from 1 by default, several cursors stamped
+	/// into the same executable need distinct ones.
+	/// \param first_id: The identifier of the first image.
+	///
+	void renumber(std::uint16_t first_id) noexcept;
+
+	///
+	/// \brief Finds the entry Windows shows at a size, like
+	/// LookupIconIdFromDirectoryEx.
+	/// \details The entries closest in size win, ties going to the larger
+	/// entry since shrinking looks better than enlarging; among those the bit
+	/// count closest to the display's wins. Nothing is decoded: only the
+	/// entries are read, plus the IHDR of PNG images and the header of DIBs
+	/// whose entry has no bit count.
+	/// \param width: The width Windows asks for, in pixels.
+	/// \param height: The height Windows asks for, in pixels.
+	/// \param display_bit_count: The bits per pixel of the display.
+	/// \returns The index of the entry in get_images() or get_image_ranges().
+	///
+	[[nodiscard]] std::size_t find_best_entry(std::uint32_t width,
+	                                          std::uint32_t height,
+	                                          std::uint16_t display_bit_count = 32) const;
+
+	/// \brief Creates an icon from a 24-bit BMP file
+	/// \brief bmp_path: Path to the source BMP file
+	/// \return icon object with one image
+	static icon from_bmp(const std::string_view bmp_path);
+
 private:
+	///
+	/// \brief The size and depth of an image, as Windows sees it.
+	///
+	struct image_metrics final
+	{
+		std::uint32_t width;     ///< Width in pixels.
+		std::uint32_t height;    ///< Height in pixels.
+		std::uint16_t bit_count; ///< Bits per pixel.
+	};
+
+	///
+	/// \brief Gets the size and depth of an image.
+	/// \param index: The index of the image.
+	/// \returns The metrics, from the entry or peeked from the image header.
+	///
+	[[nodiscard]] image_metrics get_metrics(std::size_t index) const;
+
 	///
 	/// \brief Opens the specified file and sets exceptions for failbit and badbit.
 	/// \param file_path: The path to the file to be opened.
@@ -139,6 +235,13 @@ private:
 	///
 	static std::vector<std::uint8_t> serialize(const entry& entry);
 
+	///
+	/// \brief Serializes a cursor entry into a byte vector.
+	/// \param entry: The cursor entry structure to be serialized.
+	/// \returns A vector of bytes representing the serialized entry.
+	///
+	static std::vector<std::uint8_t> serialize(const cursor_entry& entry);
+
 	///
 	/// \brief Reads the header of the ICO file and validates its content.
 	/// \param file: The file to read from.
@@ -159,9 +262,12 @@ private:
 	/// \details It also checks the integrity of the metadata.
 	/// \param file: The file to read from.
 	/// \param entries: A list of icon entries containing metadata for each image.
+	/// \param mapping: The mapped file, the images are only located in it
+	/// when not nullptr.
 	///
-	void read_images(std::ifstream&                 file,
-	                 const std::vector<icon_entry>& entries);
+	void read_images(std::ifstream&                            file,
+	                 const std::vector<icon_entry>&            entries,
+	                 const std::shared_ptr<const mapped_file>& mapping);
 
 	///
 	/// \brief Converts the icon entries into resource entries member.
@@ -169,6 +275,13 @@ private:
 	///
 	void convert_entries(const std::vector<icon_entry>& entries);
 
+	///
+	/// \brief Converts the cursor entries into cursor entries member and
+	/// prefixes the images with their hotspots.
+	/// \param entries: The list of CUR entries, hotspots in planes and bit count.
+	///
+	void convert_cursor_entries(const std::vector<icon_entry>& entries);
+
 private:
 	///
 	/// \brief The header of the ICO file.
@@ -182,10 +295,27 @@ private:
 	///
 	std::vector<entry> resource_entries;
 
+	///
+	/// \brief The metadata for each image in the CUR file.
+	/// \details Is actually stored as PE resource format.
+	///
+	std::vector<cursor_entry> cursor_entries;
+
 	///
 	/// \brief The image data for the ICO file.
+	/// \details Allocated from the memory resource passed to the constructor.
+	///
+	std::pmr::vector<std::pmr::vector<std::uint8_t>> images;
+
+	///
+	/// \brief The image data for the ICO file, when left in the mapped file.
+	///
+	std::vector<file_range> image_ranges;
+
+	///
+	/// \brief Counts the images read into memory against the memory limits.
 	///
-	std::vector<std::vector<std::uint8_t>> images;
+	memory_reservation reservation;
 };
 
 } // namespace icon_changer
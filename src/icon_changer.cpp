@@ -17,15 +17,45 @@
 
 #include "icon_changer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory_resource>
+#include <optional>
 #include <print>
 #include <stdexcept>
+#include <string>
 #include <vector>
-#include <windows.h>
 
+#include "animated_cursor.hpp"
 #include "ansi_color_codes.hpp"
+#include "batch.hpp"
+#include "buffer_pool.hpp"
+#include "dpi_icon.hpp"
+#include "favicon_bundle.hpp"
+#include "file_lock.hpp"
 #include "icon.hpp"
+#include "icon_library.hpp"
+#include "icon_splitter.hpp"
+#include "io_strategy.hpp"
+#include "journal.hpp"
+#include "json.hpp"
+#include "logger.hpp"
+#include "memory_budget.hpp"
+#include "metrics.hpp"
+#include "parallel.hpp"
+#include "pe_image.hpp"
+#include "resource_backend.hpp"
+#include "resource_lister.hpp"
+#include "resource_tree.hpp"
+#include "sha256.hpp"
+#include "shard.hpp"
+#include "stamp.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTIONS
@@ -34,6 +64,101 @@
 namespace icon_changer
 {
 
+///
+/// \brief Command-line options that modify how the icon is changed.
+///
+struct options final
+{
+	bool                      print_digest; ///< Print the Authenticode digest of the output.
+	stamp_options             stamp;        ///< What is stamped: --cursor, --from-exe, the signature policy and --verify.
+	const char*               job_file;     ///< The job file passed to --batch, nullptr if none.
+	bool                      dry_run;      ///< Only report what would change, write nothing.
+	memory_limits             limits;       ///< Memory caps for the files being loaded.
+	std::optional<shard_spec> shard;        ///< The part of the batch done here, all of it if none.
+	const char*               report;       ///< The report file passed to --report, nullptr if none.
+	const char*               journal;      ///< The journal passed to --journal, nullptr if none.
+	const char*               metrics;      ///< The metrics file passed to --metrics, nullptr if none.
+};
+
+///
+/// \brief Separates the options from the positional arguments.
+/// \param argument_count: The number of command-line arguments passed.
+/// \param arguments: The command-line arguments.
+/// \param positionals: Receives the program path followed by the positional
+/// arguments.
+/// \returns The parsed options.
+///
+static options parse_options(std::int32_t              argument_count,
+                             const char**              arguments,
+                             std::vector<const char*>& positionals);
+
+///
+/// \brief Parses the value of a memory cap option.
+/// \param option: The option, used in error messages.
+/// \param value: The cap in MiB, 0 for no cap.
+/// \returns The cap in bytes.
+///
+static std::uint64_t parse_memory_limit(std::string_view option,
+                                        std::string_view value);
+
+///
+/// \brief Runs the updates listed in a job file.
+/// \details Updates of the same executable are coalesced into the last one and
+/// the remaining ones run in parallel. A failed update does not stop the others.
+/// Every distinct icon is loaded once into a stamp shared by all its targets.
+/// \param job_file_path: The path to the job file.
+/// \param options: The command-line options, applied to every update.
+///
+static void change_icons_batch(std::string_view job_file_path,
+                               const options&   options);
+
+///
+/// \brief Hashes what a batch job stamps into its target, for the journal.
+/// \details Covers the icon, the cursors and the options changing the result.
+/// \param icon_path: The path to the `.ico` file.
+/// \param options: The command-line options.
+/// \returns The hash.
+///
+static sha256::digest hash_stamp_inputs(std::string_view icon_path,
+                                        const options&   options);
+
+///
+/// \brief Writes the report of a batch as JSON lines.
+/// \details One line per update and a summary line, all tagged with the
+/// shard, so the reports of all shards can simply be concatenated.
+/// \param report_path: The path to the report file.
+/// \param shard: The shard that ran the updates.
+/// \param partition: The fingerprint of the partition, the same in all the
+/// reports of a run if the shards agreed on it (0 without --shard).
+/// \param jobs: The updates.
+/// \param errors: Why each update failed, empty if it succeeded.
+/// \param skipped: Whether each update was skipped, see --journal.
+/// \param dry_run: Whether the updates were only simulated.
+///
+static void write_batch_report(std::string_view                report_path,
+                               const shard_spec&               shard,
+                               std::uint64_t                   partition,
+                               const std::vector<job>&         jobs,
+                               const std::vector<std::string>& errors,
+                               const std::vector<bool>&        skipped,
+                               bool                            dry_run);
+
+///
+/// \brief Rewrites an animated cursor with its duplicated frames removed.
+/// \param input_path: The path to the ANI file.
+/// \param output_path: The path to the optimized ANI file.
+///
+static void optimize_animated_cursor(std::string_view input_path,
+                                     std::string_view output_path);
+
+///
+/// \brief Rebuilds the resource section of an executable tightly packed.
+/// \details The executable stays locked while it is rewritten, like for an
+/// icon update.
+/// \param executable_path: The path to the executable.
+///
+static void compact_executable(std::string_view executable_path);
+
 ///
 /// \brief Validates the number of command-line arguments.
 /// \details If the argument count is incorrect, usage information is printed
@@ -50,36 +175,32 @@ static void validate_argument_count(std::int32_t     argument_count,
 /// version.
 /// \param icon_path: The path to the `.ico` file.
 /// \param executable_path: The path to the target `.exe` file.
+/// \param options: The command-line options.
 ///
 static void change_icon(std::string_view icon_path,
-                        std::string_view executable_path);
+                        std::string_view executable_path,
+                        const options&   options);
 
 ///
 /// \brief Secure version of icon replacement with rollback on failure.
-/// \details Opens the executable's resources, sets the icon images and header,
-/// and commits the changes.
-/// \param icon_path: The path to the `.ico` file.
+/// \details Parses the executable's resources, sets the icon images and header,
+/// and writes the executable back. The executable is only replaced once the
+/// new file has been written completely, and it stays locked meanwhile so
+/// concurrent updates (also from other processes) are serialized.
+/// \param stamp: The resources to be stamped, see build_stamp().
 /// \param executable_path: The path to the target `.exe` file.
+/// With --dry-run the update is applied in memory and reported instead.
+/// \param options: The command-line options.
+/// \param hash_contents: Whether the SHA-256 of the output is computed while
+/// it is written, see stamp_file().
+/// \param resource: Where the executable and its resources are loaded.
+/// \returns What was written, empty with --dry-run.
 ///
-static void change_icon_s(std::string_view icon_path,
-                          std::string_view executable_path);
-
-///
-/// \brief Adds the individual icon image resources to the executable.
-/// \details Iterates over all images and adds them with appropriate resource IDs.
-/// \param exe_resource: Handle to the open resource section of the executable.
-/// \param icon: The parsed icon object containing image data.
-///
-static void set_images(void* exe_resource,
-                       icon& icon);
-
-///
-/// \brief Adds the group icon header (NEWHEADER + RESDIR) to the executable.
-/// \param exe_resource: Handle to the open resource section of the executable.
-/// \param icon: The parsed icon object containing the group icon header.
-///
-static void set_icon_header(void*       exe_resource,
-                            const icon& icon);
+static std::optional<stamp_result> change_icon_s(const resource_tree&       stamp,
+                                                 std::string_view           executable_path,
+                                                 const options&             options,
+                                                 bool                       hash_contents = false,
+                                                 std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 ////////////////////////////////////////////////////////////////////////////////
 // FUNCTION DEFINITIONS
@@ -95,15 +216,190 @@ void change_icon_cli(const std::int32_t argument_count,
 	static constexpr std::uint16_t VERSION_MINOR = 1;
 	static constexpr std::uint16_t VERSION_PATCH = 0;
 
-	if (2 == argument_count && ("--version" == std::string_view{ arguments[1] } || "-v" == std::string_view{ arguments[1] }))
+	static constexpr std::string_view DEFAULT_DPI_SCALES     = "100,125,150,200,250,300";
+	static constexpr std::string_view DEFAULT_SHELL_CONTEXTS = "small,large,jumbo";
+
+	// Without any argument there is no mode, the positional checks report it.
+	const std::string_view mode = 2 <= argument_count ? arguments[1] : std::string_view{};
+
+	if (2 == argument_count && ("--version" == mode || "-v" == mode))
 	{
 		std::println("icon-changer version {}.{}.{}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
 		return;
 	}
 
-	validate_argument_count(argument_count, arguments[0]);
-	change_icon(arguments[1], arguments[2]);
-	std::println(GRN "Icon changed successfully!" CRESET);
+	const std::string io_config = get_io_config_path();
+
+	// --calibrate rewrites the configuration, so it must work when it is broken.
+	if ("--calibrate" != mode && !io_config.empty() && std::filesystem::exists(io_config))
+	{
+		try
+		{
+			set_io_thresholds(read_io_thresholds(io_config));
+		}
+		catch (const std::exception& exception)
+		{
+			std::println(YEL "{} Using the default I/O thresholds..." CRESET, exception.what());
+			set_io_thresholds(get_default_io_thresholds());
+		}
+	}
+
+	if ("--calibrate" == mode)
+	{
+		if (3 < argument_count)
+		{
+			throw std::invalid_argument{ "--calibrate takes at most a directory!" };
+		}
+
+		if (io_config.empty())
+		{
+			throw std::runtime_error{ "No configuration directory, set ICON_CHANGER_IO_CONFIG!" };
+		}
+
+		const std::string_view directory  = 3 == argument_count ? arguments[2] : ".";
+		const filesystem_kind  kind       = detect_filesystem(directory);
+		const io_thresholds    thresholds = calibrate_io(directory, get_io_thresholds());
+
+		write_io_thresholds(io_config, thresholds);
+
+		const auto describe = [](const std::uint64_t size)
+		{
+			return UINT64_MAX == size ? std::string{ "never" } : std::format("{} bytes", size);
+		};
+
+		std::println(GRN "Calibrated {} file systems (map from {}, copy in the kernel from {}) in \"{}\"!" CRESET, to_string(kind),
+		             describe(thresholds.map_size[static_cast<std::size_t>(kind)]), describe(thresholds.splice_size[static_cast<std::size_t>(kind)]), io_config);
+		return;
+	}
+
+	if ("--list" == mode)
+	{
+		std::optional<shard_spec> shard = std::nullopt;
+		std::int32_t              first = 2;
+
+		if (4 <= argument_count && "--shard" == std::string_view{ arguments[2] })
+		{
+			shard = parse_shard(arguments[3]);
+			first = 4;
+		}
+
+		if (first == argument_count)
+		{
+			throw std::invalid_argument{ "--list needs at least one file or directory!" };
+		}
+
+		list_resources_cli({ arguments + first, static_cast<std::size_t>(argument_count - first) }, shard);
+		return;
+	}
+
+	if ("--optimize-ani" == mode)
+	{
+		if (4 != argument_count)
+		{
+			throw std::invalid_argument{ "--optimize-ani needs an input and an output file!" };
+		}
+
+		optimize_animated_cursor(arguments[2], arguments[3]);
+		return;
+	}
+
+	if ("--favicon-bundle" == mode)
+	{
+		if (4 != argument_count)
+		{
+			throw std::invalid_argument{ "--favicon-bundle needs a master image and an output directory!" };
+		}
+
+		const bundle_report report = write_favicon_bundle(arguments[2], arguments[3]);
+
+		std::println(GRN "Wrote {} file(s), {} unchanged!" CRESET, report.written, report.unchanged);
+		return;
+	}
+
+	if ("--dpi-icon" == mode)
+	{
+		if (4 > argument_count || 6 < argument_count)
+		{
+			throw std::invalid_argument{ "--dpi-icon needs a master image, an output file and optionally the DPI scales and shell contexts!" };
+		}
+
+		const std::vector<std::uint32_t> scales   = parse_scales(4 < argument_count ? arguments[4] : DEFAULT_DPI_SCALES);
+		const std::vector<shell_context> contexts = parse_contexts(5 < argument_count ? arguments[5] : DEFAULT_SHELL_CONTEXTS);
+		const std::vector<std::uint32_t> sizes    = write_dpi_icon(arguments[2], arguments[3], scales, contexts);
+		std::string                      list     = {};
+
+		for (const std::uint32_t size : sizes)
+		{
+			list += std::format("{}{}", list.empty() ? "" : ", ", size);
+		}
+
+		std::println(GRN "Wrote {} size(s): {}!" CRESET, sizes.size(), list);
+		return;
+	}
+
+	if ("--split" == mode)
+	{
+		if (4 != argument_count)
+		{
+			throw std::invalid_argument{ "--split needs an icon (or a directory) and an output directory!" };
+		}
+
+		split_icons_cli(arguments[2], arguments[3]);
+		return;
+	}
+
+	if ("--icon-library" == mode)
+	{
+		if (4 != argument_count)
+		{
+			throw std::invalid_argument{ "--icon-library needs a directory of icons and an output file!" };
+		}
+
+		const library_report report = write_icon_library(arguments[2], arguments[3]);
+
+		std::println(GRN "Wrote {} icon(s) with {} image(s), {} distinct, in {} bytes!" CRESET, report.groups, report.images, report.unique_images, report.size);
+		return;
+	}
+
+	if ("--compact" == mode)
+	{
+		if (3 != argument_count)
+		{
+			throw std::invalid_argument{ "--compact needs an executable!" };
+		}
+
+		compact_executable(arguments[2]);
+		return;
+	}
+
+	std::vector<const char*> positionals = {};
+	const options            options     = parse_options(argument_count, arguments, positionals);
+
+	set_memory_limits(options.limits);
+
+	if (nullptr != options.job_file)
+	{
+		if (1 != positionals.size())
+		{
+			throw std::invalid_argument{ "--batch does not take any other path!" };
+		}
+
+		change_icons_batch(options.job_file, options);
+		return;
+	}
+
+	if (options.shard.has_value() || nullptr != options.report || nullptr != options.journal || nullptr != options.metrics)
+	{
+		throw std::invalid_argument{ "--shard, --report, --journal and --metrics need --batch!" };
+	}
+
+	validate_argument_count(static_cast<std::int32_t>(positionals.size()), positionals[0]);
+	change_icon(positionals[1], positionals[2], options);
+
+	if (!options.dry_run)
+	{
+		std::println(GRN "Icon changed successfully!" CRESET);
+	}
 }
 
 void change_icon_gui()
@@ -111,98 +407,541 @@ void change_icon_gui()
 	throw std::runtime_error{ "GUI not yet implemented!" };
 }
 
-static void validate_argument_count(const std::int32_t     argument_count,
-                                    const std::string_view program_path)
+static options parse_options(const std::int32_t        argument_count,
+                             const char** const        arguments,
+                             std::vector<const char*>& positionals)
 {
-	static constexpr std::size_t REQUIRED_ARGUMENT_COUNT = 3;
+	options options = { false, { {}, false, certificate_policy::unspecified, false }, nullptr, false, get_memory_limits(), std::nullopt, nullptr, nullptr, nullptr };
 
-	if (REQUIRED_ARGUMENT_COUNT == argument_count)
+	positionals.push_back(arguments[0]);
+
+	for (std::int32_t index = 1; index < argument_count; ++index)
 	{
-		return;
+		const std::string_view argument = arguments[index];
+
+		if (!argument.starts_with("--"))
+		{
+			positionals.push_back(arguments[index]);
+		}
+		else if ("--digest" == argument)
+		{
+			options.print_digest = true;
+		}
+		else if ("--strip-signature" == argument)
+		{
+			options.stamp.certificates = certificate_policy::strip;
+		}
+		else if ("--keep-signature" == argument)
+		{
+			options.stamp.certificates = certificate_policy::preserve;
+		}
+		else if ("--dry-run" == argument)
+		{
+			options.dry_run = true;
+		}
+		else if ("--verify" == argument)
+		{
+			options.stamp.verify = true;
+		}
+		else if ("--from-exe" == argument)
+		{
+			options.stamp.from_executable = true;
+		}
+		else if ("--cursor" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--cursor needs a cursor file!" };
+			}
+
+			options.stamp.cursors.push_back(arguments[++index]);
+		}
+		else if ("--batch" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--batch needs a job file!" };
+			}
+
+			options.job_file = arguments[++index];
+		}
+		else if ("--max-file-memory" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--max-file-memory needs a size in MiB!" };
+			}
+
+			options.limits.per_file = parse_memory_limit(argument, arguments[++index]);
+		}
+		else if ("--max-memory" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--max-memory needs a size in MiB!" };
+			}
+
+			options.limits.per_process = parse_memory_limit(argument, arguments[++index]);
+		}
+		else if ("--shard" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--shard needs a shard (e.g. 1/4)!" };
+			}
+
+			options.shard = parse_shard(arguments[++index]);
+		}
+		else if ("--report" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--report needs a report file!" };
+			}
+
+			options.report = arguments[++index];
+		}
+		else if ("--journal" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--journal needs a journal file!" };
+			}
+
+			options.journal = arguments[++index];
+		}
+		else if ("--metrics" == argument)
+		{
+			if (argument_count - 1 == index)
+			{
+				throw std::invalid_argument{ "--metrics needs a metrics file!" };
+			}
+
+			options.metrics = arguments[++index];
+		}
+		else
+		{
+			throw std::invalid_argument{ std::format("Unknown option \"{}\"!", argument) };
+		}
 	}
 
-	std::println("Usage: {} <path_to_icon> <path_to_exe>", program_path);
+	return options;
+}
 
-	if (REQUIRED_ARGUMENT_COUNT > argument_count)
+static std::uint64_t parse_memory_limit(const std::string_view option,
+                                        const std::string_view value)
+{
+	static constexpr std::uint64_t MEBIBYTE = 1024 * 1024;
+
+	std::uint64_t                mebibytes = 0;
+	const std::from_chars_result result    = std::from_chars(value.data(), value.data() + value.size(), mebibytes);
+
+	if (std::errc{} != result.ec || value.data() + value.size() != result.ptr || UINT64_MAX / MEBIBYTE < mebibytes)
 	{
-		throw std::runtime_error{ std::format("{} parameter(s) missing!", REQUIRED_ARGUMENT_COUNT - argument_count) };
+		throw std::invalid_argument{ std::format("{} needs a size in MiB, got \"{}\"!", option, value) };
 	}
 
-	std::println(YEL "{} parameter(s) will be ignored..." CRESET, argument_count - REQUIRED_ARGUMENT_COUNT);
+	return mebibytes * MEBIBYTE;
 }
 
-static void change_icon(const std::string_view icon_path,
-                        const std::string_view executable_path)
+static void change_icons_batch(const std::string_view job_file_path,
+                               const options&         options)
 {
-	if (!std::filesystem::exists(icon_path))
+	// Same order as the scrape interval of the node exporter.
+	static constexpr std::chrono::milliseconds METRICS_INTERVAL = std::chrono::seconds{ 10 };
+
+	const std::vector<job>                     jobs         = read_jobs(job_file_path);
+	std::vector<job>                           coalesced    = coalesce_jobs(jobs);
+	const shard_spec                           shard        = options.shard.value_or(shard_spec{ 0, 1 });
+	std::map<std::string_view, std::size_t>    stamp_lookup = {};
+	std::vector<std::string_view>              icon_paths   = {};
+	std::vector<std::optional<resource_tree>>  stamps       = {};
+	std::vector<std::string>                   errors       = {};
+	std::vector<std::string>                   outcomes     = {};
+	std::uint64_t                              partition    = 0;
+	std::optional<journal>                     completed    = std::nullopt;
+	std::vector<std::optional<sha256::digest>> inputs       = {};
+	std::vector<bool>                          skipped      = {};
+	std::size_t                                skip_count   = 0;
+	std::atomic<std::size_t>                   failed       = 0;
+	buffer_pool                                pool         = buffer_pool{};
+	std::optional<metrics_exporter>            exporter     = std::nullopt;
+
+	if (nullptr != options.metrics)
 	{
-		throw std::invalid_argument{ std::format("\"{}\" does not exist!", icon_path) };
+		exporter.emplace(options.metrics, METRICS_INTERVAL);
 	}
 
-	if (!std::filesystem::exists(executable_path))
+	LOG("Coalesced {} job(s) into {} update(s).", jobs.size(), coalesced.size());
+
+	if (1 < shard.count)
 	{
-		throw std::invalid_argument{ std::format("\"{}\" does not exist!", executable_path) };
+		std::vector<std::string>   targets  = {};
+		std::vector<std::uint64_t> sizes    = {};
+		std::vector<job>           selected = {};
+		std::size_t                sized    = 0;
+
+		// The targets are being stamped by the other shards, so their sizes
+		// come from the job file; without them every target weighs the same.
+		for (const job& job : coalesced)
+		{
+			targets.push_back(job.executable_path);
+			sizes.push_back(job.size.value_or(0));
+			sized += job.size.has_value();
+		}
+
+		if (0 != sized && coalesced.size() != sized)
+		{
+			throw std::invalid_argument{ std::format("\"{}\" gives the size of {} of {} target(s), --shard needs all of them or none!", job_file_path, sized, coalesced.size()) };
+		}
+
+		const shard_selection selection = select_shard(targets, sizes, shard);
+
+		for (const std::size_t index : selection.indices)
+		{
+			selected.push_back(std::move(coalesced[index]));
+		}
+
+		coalesced = std::move(selected);
+		partition = selection.partition;
+
+		LOG("Shard {} has {} update(s).", format_shard(shard), coalesced.size());
 	}
 
-	change_icon_s(icon_path, executable_path);
-}
+	add(counter::jobs_queued, coalesced.size());
+	inputs.resize(coalesced.size());
+	skipped.resize(coalesced.size());
 
-static void change_icon_s(const std::string_view icon_path,
-                          const std::string_view executable_path)
-{
-	icon        icon         = { icon_path };
-	void* const exe_resource = BeginUpdateResourceA(executable_path.data(), false);
+	if (nullptr != options.journal)
+	{
+		std::map<std::string_view, std::optional<sha256::digest>> input_lookup = {};
+		std::vector<std::uint8_t>                                 complete     = std::vector<std::uint8_t>(coalesced.size());
+
+		completed.emplace(options.journal);
+
+		for (const job& job : coalesced)
+		{
+			if (input_lookup.try_emplace(job.icon_path).second)
+			{
+				try
+				{
+					input_lookup[job.icon_path] = hash_stamp_inputs(job.icon_path, options);
+				}
+				catch (const std::exception&)
+				{
+					// Reported with the update, which cannot be skipped.
+				}
+			}
+		}
+
+		// Completed updates only cost a stat and a hash of the target.
+		parallel_for(coalesced.size(), [&coalesced, &input_lookup, &completed, &inputs, &complete](const std::size_t index)
+		{
+			const stage_timer timer = stage_timer{ stage::journal };
+
+			inputs[index]   = input_lookup.at(coalesced[index].icon_path);
+			complete[index] = inputs[index].has_value() && completed->is_complete(coalesced[index].executable_path, *inputs[index]);
+		});
 
-	if (nullptr == exe_resource)
+		for (std::size_t index = 0; index < coalesced.size(); ++index)
+		{
+			skipped[index]  = 0 != complete[index];
+			skip_count     += complete[index];
+		}
+
+		add(counter::jobs_skipped, skip_count);
+		LOG("Skipping {} update(s) found in the journal.", skip_count);
+	}
+
+	for (std::size_t index = 0; index < coalesced.size(); ++index)
 	{
-		throw std::runtime_error{ "Failed to get executable's resource handle!" };
+		if (skipped[index])
+		{
+			continue;
+		}
+
+		if (stamp_lookup.try_emplace(coalesced[index].icon_path, icon_paths.size()).second)
+		{
+			add(counter::stamp_misses);
+			icon_paths.push_back(coalesced[index].icon_path);
+		}
+		else
+		{
+			add(counter::stamp_hits);
+		}
 	}
 
-	try
+	LOG("Loading {} distinct icon(s).", icon_paths.size());
+
+	// Targets sharing an icon share its stamp: the icon is parsed and mapped
+	// once, each target only lays out its own directories.
+	stamps.resize(icon_paths.size());
+	errors.resize(icon_paths.size());
+
+	parallel_for(icon_paths.size(), [&icon_paths, &options, &pool, &stamps, &errors](const std::size_t index)
+	{
+		// What is loaded only to build the stamp lives in an arena, whose
+		// chunks are recycled by the pool from one icon to the next.
+		std::pmr::monotonic_buffer_resource arena = std::pmr::monotonic_buffer_resource{ &pool };
+
+		const stage_timer timer = stage_timer{ stage::load };
+
+		try
+		{
+			require_file(icon_paths[index]);
+			stamps[index] = build_stamp(icon_paths[index], options.stamp, &arena);
+		}
+		catch (const std::exception& exception)
+		{
+			errors[index] = exception.what();
+		}
+	});
+
+	outcomes.resize(coalesced.size());
+
+	parallel_for(coalesced.size(), [&coalesced, &options, &pool, &stamp_lookup, &stamps, &errors, &outcomes, &completed, &inputs, &skipped, &failed](const std::size_t index)
 	{
-		set_images(exe_resource, icon);
-		set_icon_header(exe_resource, icon);
+		if (skipped[index])
+		{
+			return;
+		}
+
+		// The executable and its resource tree live in an arena too, so in
+		// steady state a target is updated without allocating new buffers.
+		std::pmr::monotonic_buffer_resource arena = std::pmr::monotonic_buffer_resource{ &pool };
+
+		try
+		{
+			const std::size_t stamp = stamp_lookup.at(coalesced[index].icon_path);
+
+			if (!stamps[stamp].has_value())
+			{
+				throw std::runtime_error{ errors[stamp] };
+			}
+
+			// The journal records the output as it was written under the lock,
+			// so a concurrent writer cannot slip its contents into the entry.
+			const bool journaled = completed.has_value() && inputs[index].has_value() && !options.dry_run;
+
+			std::optional<stamp_result> result = std::nullopt;
+
+			{
+				const stage_timer timer = stage_timer{ stage::stamp };
+
+				require_file(coalesced[index].executable_path);
+				result = change_icon_s(*stamps[stamp], coalesced[index].executable_path, options, journaled, &arena);
+			}
+
+			if (journaled)
+			{
+				completed->record(coalesced[index].executable_path, *inputs[index], result.value().contents.value(), result.value().size);
+			}
+
+			add(counter::jobs_changed);
+		}
+		catch (const std::exception& exception)
+		{
+			std::println(RED "{}: {}" CRESET, coalesced[index].executable_path, exception.what());
+			outcomes[index] = exception.what();
+			failed.fetch_add(1, std::memory_order_relaxed);
+			add(counter::jobs_failed);
+		}
+	});
+
+	if (completed.has_value())
+	{
+		completed->flush();
+	}
+
+	if (nullptr != options.report)
+	{
+		write_batch_report(options.report, shard, partition, coalesced, outcomes, skipped, options.dry_run);
+	}
+
+	if (0 != failed)
+	{
+		throw std::runtime_error{ std::format("{} of {} update(s) failed!", failed.load(), coalesced.size()) };
+	}
+
+	if (0 != skip_count)
+	{
+		std::println(YEL "Skipped {} update(s) completed by an earlier run..." CRESET, skip_count);
+	}
+
+	if (!options.dry_run && 1 < shard.count)
+	{
+		std::println(GRN "Changed {} icon(s) in shard {}!" CRESET, coalesced.size() - skip_count, format_shard(shard));
 	}
-	catch (const std::exception& exception)
+	else if (!options.dry_run)
 	{
-		EndUpdateResourceA(exe_resource, true);
-		throw;
+		std::println(GRN "Changed {} icon(s) from {} job(s)!" CRESET, coalesced.size() - skip_count, jobs.size());
 	}
+}
+
+static sha256::digest hash_stamp_inputs(const std::string_view icon_path,
+                                        const options&         options)
+{
+	const std::array<std::uint8_t, 2> flags = { static_cast<std::uint8_t>(options.stamp.from_executable), static_cast<std::uint8_t>(options.stamp.certificates) };
+	sha256                            hash  = {};
 
-	if (!EndUpdateResourceA(exe_resource, false))
+	hash.update(flags);
+	hash.update(sha256::hash_file(icon_path));
+
+	for (const std::string& cursor_path : options.stamp.cursors)
 	{
-		throw std::runtime_error{ "Failed to commit the changes to the executable!" };
+		hash.update(sha256::hash_file(cursor_path));
 	}
+
+	return hash.finalize();
 }
 
-static void set_images(void* const exe_resource,
-                       icon&       icon)
+static void write_batch_report(const std::string_view          report_path,
+                               const shard_spec&               shard,
+                               const std::uint64_t             partition,
+                               const std::vector<job>&         jobs,
+                               const std::vector<std::string>& errors,
+                               const std::vector<bool>&        skipped,
+                               const bool                      dry_run)
 {
-	assert(nullptr != exe_resource);
+	std::ofstream file   = std::ofstream{ std::filesystem::path{ report_path }, std::ios::binary };
+	std::string   prefix = "{\"shard\":";
+	std::string   report = {};
+	std::size_t   failed = 0;
+	std::size_t   skips  = 0;
 
-	std::size_t id = 0;
+	append_json_string(prefix, format_shard(shard));
 
-	for (std::vector<std::uint8_t>& image : icon.get_images())
+	for (std::size_t index = 0; index < jobs.size(); ++index)
 	{
-		// We rely on the fact that we know IDs start from 1 in the header entries.
-		if (!UpdateResourceA(exe_resource, RT_ICON, reinterpret_cast<char*>(++id), LANG_NEUTRAL, image.data(), image.size()))
+		report += prefix;
+		report += ",\"target\":";
+		append_json_string(report, jobs[index].executable_path);
+		report += ",\"icon\":";
+		append_json_string(report, jobs[index].icon_path);
+
+		if (skipped[index])
+		{
+			report += ",\"status\":\"skipped\"}\n";
+			++skips;
+			continue;
+		}
+
+		if (errors[index].empty())
 		{
-			throw std::runtime_error{ std::format("Failed to add RT_ICON resource with id {} to executable!", id) };
+			report += dry_run ? ",\"status\":\"dry-run\"}\n" : ",\"status\":\"changed\"}\n";
+			continue;
 		}
+
+		report += ",\"status\":\"failed\",\"error\":";
+		append_json_string(report, errors[index]);
+		report += "}\n";
+		++failed;
+	}
+
+	report += prefix;
+	std::format_to(std::back_inserter(report), ",\"partition\":\"{:016x}\",\"updates\":{},\"skipped\":{},\"failed\":{}}}\n", partition, jobs.size(), skips, failed);
+
+	if (!file.write(report.data(), static_cast<std::streamsize>(report.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to write \"{}\"!", report_path) };
 	}
 }
 
-static void set_icon_header(void* const exe_resource,
-                            const icon& icon)
+static void optimize_animated_cursor(const std::string_view input_path,
+                                     const std::string_view output_path)
 {
-	assert(nullptr != exe_resource);
+	const animated_cursor           cursor = animated_cursor{ input_path };
+	const std::vector<std::uint8_t> bytes  = cursor.serialize();
+	std::ofstream                   file   = std::ofstream{ std::filesystem::path{ output_path }, std::ios::binary };
 
-	std::vector<std::uint8_t> header = icon.get_header();
+	if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to write \"{}\"!", output_path) };
+	}
+
+	std::println(GRN "Wrote {} frame(s) and {} step(s) in {} bytes!" CRESET, cursor.get_frames().size(), cursor.get_sequence().size(), bytes.size());
+}
 
-	if (!UpdateResourceA(exe_resource, RT_GROUP_ICON, "MAINICON", LANG_NEUTRAL, header.data(), header.size()))
+static void compact_executable(const std::string_view executable_path)
+{
+	require_file(executable_path);
+
+	const file_lock   lock       = file_lock{ executable_path };
+	pe_image          executable = pe_image{ executable_path };
+	const std::size_t old_size   = executable.get_bytes().size();
+
+	if (executable.has_certificates())
+	{
+		throw std::invalid_argument{ std::format("\"{}\" is signed, compacting it would invalidate the signature!", executable_path) };
+	}
+
+	const std::size_t released = executable.compact_resources();
+
+	executable.save(executable_path);
+	std::println(GRN "Compacted \"{}\" from {} to {} bytes ({} section(s) released)!" CRESET, executable_path, old_size, executable.get_bytes().size(), released);
+}
+
+static void validate_argument_count(const std::int32_t     argument_count,
+                                    const std::string_view program_path)
+{
+	static constexpr std::size_t REQUIRED_ARGUMENT_COUNT = 3;
+
+	if (REQUIRED_ARGUMENT_COUNT == argument_count)
 	{
-		throw std::runtime_error{ "Failed to add RT_GROUP_ICON resource to executable!" };
+		return;
 	}
+
+	std::println("Usage: {} [--dry-run] [--verify] [--digest] [--strip-signature | --keep-signature] [--cursor <path_to_cur_or_ani>]... [--from-exe] [--max-file-memory <MiB>] [--max-memory <MiB>] <path_to_icon_or_cur_or_donor_exe> <path_to_exe>", program_path);
+	std::println("       {} [options] [--shard <i/N>] [--report <report_file>] [--journal <journal_file>] [--metrics <file.prom>] --batch <job_file>", program_path);
+	std::println("       {} --list [--shard <i/N>] <files|directories>", program_path);
+	std::println("       {} --optimize-ani <input_ani> <output_ani>", program_path);
+	std::println("       {} --favicon-bundle <master_bmp> <output_directory>", program_path);
+	std::println("       {} --dpi-icon <master_bmp> <output_ico> [scales] [contexts]", program_path);
+	std::println("       {} --split <icon|directory> <output_directory>", program_path);
+	std::println("       {} --icon-library <directory> <output_dll>", program_path);
+	std::println("       {} --compact <path_to_exe>", program_path);
+	std::println("       {} --calibrate [directory]", program_path);
+
+	if (REQUIRED_ARGUMENT_COUNT > argument_count)
+	{
+		throw std::runtime_error{ std::format("{} parameter(s) missing!", REQUIRED_ARGUMENT_COUNT - argument_count) };
+	}
+
+	std::println(YEL "{} parameter(s) will be ignored..." CRESET, argument_count - REQUIRED_ARGUMENT_COUNT);
+}
+
+static void change_icon(const std::string_view icon_path,
+                        const std::string_view executable_path,
+                        const options&         options)
+{
+	require_file(icon_path);
+	require_file(executable_path);
+	change_icon_s(build_stamp(icon_path, options.stamp), executable_path, options);
+}
+
+static std::optional<stamp_result> change_icon_s(const resource_tree&             stamp,
+                                                 const std::string_view           executable_path,
+                                                 const options&                   options,
+                                                 const bool                       hash_contents,
+                                                 std::pmr::memory_resource* const resource)
+{
+	if (options.dry_run)
+	{
+		memory_backend backend = memory_backend{ executable_path, resource };
+
+		stamp_icon(backend, stamp, executable_path, options.stamp);
+		std::println("{}", backend.to_json(executable_path));
+		return std::nullopt;
+	}
+
+	const stamp_result result = stamp_file(stamp, executable_path, options.stamp, options.print_digest, hash_contents, resource);
+
+	if (options.print_digest)
+	{
+		std::println("{}  {}", sha256::to_string(result.digest.value()), executable_path);
+	}
+
+	return result;
 }
 
 } // namespace icon_changer
@@ -28,8 +28,8 @@ namespace icon_changer
 
 ///
 /// \brief CLI entry point for icon changing.
-/// \details Handles `--version` argument, validates input, and initiates the
-/// icon change.
+/// \details Handles `--version` and `--list` arguments, validates input, and
+/// initiates the icon change.
 /// \param argument_count: Number of arguments.
 /// \param arguments: Argument values.
 ///
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "icon_library.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <map>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ansi_color_codes.hpp"
+#include "icon.hpp"
+#include "logger.hpp"
+#include "parallel.hpp"
+#include "pe_image.hpp"
+#include "resource_tree.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Largest resource ordinal, for both the groups and the images.
+///
+static constexpr std::size_t MAX_ORDINAL = std::numeric_limits<std::uint16_t>::max();
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Finds the ICO files of a directory, recursively.
+/// \param directory: The directory.
+/// \returns The paths, sorted.
+///
+static std::vector<std::filesystem::path> find_icons(std::string_view directory);
+
+///
+/// \brief Points an entry of a group header at another RT_ICON.
+/// \param header: The NEWHEADER + RESDIR bytes.
+/// \param index: The index of the entry.
+/// \param icon_id: The new identifier.
+///
+static void set_icon_id(std::vector<std::uint8_t>& header,
+                        std::size_t                index,
+                        std::uint16_t              icon_id) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+library_report write_icon_library(const std::string_view input_directory,
+                                  const std::string_view output_path)
+{
+	const std::vector<std::filesystem::path> paths   = find_icons(input_directory);
+	std::vector<std::optional<icon>>         icons   = std::vector<std::optional<icon>>(paths.size());
+	std::vector<std::vector<sha256::digest>> digests = std::vector<std::vector<sha256::digest>>(paths.size());
+	std::map<sha256::digest, std::uint16_t>  ids     = {};
+	std::atomic<std::size_t>                 failed  = 0;
+	resource_tree                            tree    = {};
+	pe_image                                 library = pe_image::create_resource_dll();
+	library_report                           report  = { paths.size(), 0, 0, 0 };
+
+	if (paths.empty())
+	{
+		throw std::invalid_argument{ std::format("\"{}\" has no icons!", input_directory) };
+	}
+
+	if (MAX_ORDINAL < paths.size())
+	{
+		throw std::invalid_argument{ std::format("\"{}\" has {} icons, a library holds at most {}!", input_directory, paths.size(), MAX_ORDINAL) };
+	}
+
+	parallel_for(paths.size(), [&paths, &icons, &digests, &failed](const std::size_t index)
+	{
+		try
+		{
+			icons[index].emplace(paths[index].string(), true);
+
+			if (icons[index]->is_cursor())
+			{
+				throw std::invalid_argument{ "Cursors cannot be stored in an icon library!" };
+			}
+
+			for (const file_range& range : icons[index]->get_image_ranges())
+			{
+				digests[index].push_back(sha256::hash(range.get_bytes()));
+			}
+
+			// Files the I/O thresholds say to read have their images in memory.
+			for (const std::pmr::vector<std::uint8_t>& image : icons[index]->get_images())
+			{
+				digests[index].push_back(sha256::hash(image));
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			std::println(RED "{}: {}" CRESET, paths[index].string(), exception.what());
+			failed.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	if (0 != failed)
+	{
+		throw std::runtime_error{ std::format("{} of {} icon(s) failed!", failed.load(), paths.size()) };
+	}
+
+	// Identifiers are handed out in path order, so the library is reproducible.
+	for (std::size_t index = 0; index < paths.size(); ++index)
+	{
+		const std::vector<file_range>&                          ranges = icons[index]->get_image_ranges();
+		const std::pmr::vector<std::pmr::vector<std::uint8_t>>& images = icons[index]->get_images();
+		std::vector<std::uint8_t>                               header = icons[index]->get_header();
+
+		for (std::size_t image = 0; image < digests[index].size(); ++image)
+		{
+			const auto [iterator, inserted] = ids.try_emplace(digests[index][image], static_cast<std::uint16_t>(ids.size() + 1));
+
+			if (inserted)
+			{
+				if (MAX_ORDINAL < ids.size())
+				{
+					throw std::invalid_argument{ std::format("\"{}\" has more than {} distinct images!", input_directory, MAX_ORDINAL) };
+				}
+
+				if (ranges.empty())
+				{
+					tree.set(resource_type::icon, iterator->second, resource_tree::NEUTRAL_LANGUAGE, { images[image].begin(), images[image].end() });
+				}
+				else
+				{
+					tree.set_range(resource_type::icon, iterator->second, resource_tree::NEUTRAL_LANGUAGE, ranges[image]);
+				}
+			}
+
+			set_icon_id(header, image, iterator->second);
+		}
+
+		tree.set(resource_type::group_icon, static_cast<std::uint16_t>(index + 1), resource_tree::NEUTRAL_LANGUAGE, std::move(header));
+		report.images += digests[index].size();
+	}
+
+	LOG("Storing {} group(s) with {} image(s), {} distinct.", paths.size(), report.images, ids.size());
+
+	library.set_resources(tree);
+	library.save(output_path);
+
+	report.unique_images = ids.size();
+	report.size          = library.get_bytes().size();
+
+	return report;
+}
+
+static std::vector<std::filesystem::path> find_icons(const std::string_view directory)
+{
+	std::vector<std::filesystem::path> paths = {};
+
+	if (!std::filesystem::is_directory(directory))
+	{
+		throw std::invalid_argument{ std::format("\"{}\" is not a directory!", directory) };
+	}
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ directory })
+	{
+		std::string extension = entry.path().extension().string();
+
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](const char character)
+		{
+			return 'A' <= character && 'Z' >= character ? static_cast<char>(character - 'A' + 'a') : character;
+		});
+
+		if (entry.is_regular_file() && ".ico" == extension)
+		{
+			paths.push_back(entry.path());
+		}
+	}
+
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+static void set_icon_id(std::vector<std::uint8_t>& header,
+                        const std::size_t          index,
+                        const std::uint16_t        icon_id) noexcept
+{
+	std::memcpy(header.data() + sizeof(icon::header) + index * sizeof(icon::entry) + offsetof(icon::entry, icon_id), &icon_id, sizeof(icon_id));
+}
+
+} // namespace icon_changer
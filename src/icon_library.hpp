@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief What write_icon_library() put into the library.
+///
+struct library_report final
+{
+	std::size_t groups;        ///< RT_GROUP_ICON resources, one per icon file.
+	std::size_t images;        ///< Images referenced by the groups.
+	std::size_t unique_images; ///< RT_ICON resources, after deduplication.
+	std::size_t size;          ///< Size of the library in bytes.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Builds a resource-only icon library (like shell32.dll) from a
+/// directory of ICO files.
+/// \details The directory is searched recursively and the icons are parsed in
+/// parallel. Every icon becomes an RT_GROUP_ICON numbered from 1 in the order
+/// of the sorted paths, so "library.dll,0" is the first one. Identical images
+/// are stored once and shared by the groups. The images are never copied
+/// into memory: they are spliced from the ICO files into the library.
+/// \param input_directory: The directory holding the ICO files.
+/// \param output_path: The path to the library, a PE32+ DLL.
+/// \returns What the library holds.
+///
+extern library_report write_icon_library(std::string_view input_directory,
+                                         std::string_view output_path);
+
+} // namespace icon_changer
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "icon_splitter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <print>
+#include <set>
+#include <span>
+#include <stdexcept>
+
+#include "ansi_color_codes.hpp"
+#include "file_writer.hpp"
+#include "icon.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+///
+/// \brief This data structure corresponds to BITMAPFILEHEADER.
+///
+struct bmp_file_header
+{
+	std::uint16_t type;          ///< "BM".
+	std::uint32_t size;          ///< Size of the whole file.
+	std::uint32_t reserved;      ///< Reserved, 0.
+	std::uint32_t pixels_offset; ///< Offset of the pixels from the beginning of the file.
+};
+
+#pragma pack(pop)
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The 8 bytes every PNG file starts with.
+///
+static constexpr std::array<std::uint8_t, 8> PNG_MAGIC = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+///
+/// \brief Offsets of the IHDR fields in a PNG file.
+///
+static constexpr std::size_t PNG_WIDTH_OFFSET      = 16;
+static constexpr std::size_t PNG_HEIGHT_OFFSET     = 20;
+static constexpr std::size_t PNG_BIT_DEPTH_OFFSET  = 24;
+static constexpr std::size_t PNG_COLOR_TYPE_OFFSET = 25;
+
+///
+/// \brief Number of channels of every PNG color type (0, 2, 3, 4 and 6).
+///
+static constexpr std::array<std::uint32_t, 7> PNG_CHANNELS = { 1, 0, 3, 1, 2, 0, 4 };
+
+///
+/// \brief Offsets of the BITMAPINFOHEADER fields, and the accepted header sizes.
+///
+static constexpr std::size_t   DIB_WIDTH_OFFSET       = 4;
+static constexpr std::size_t   DIB_HEIGHT_OFFSET      = 8;
+static constexpr std::size_t   DIB_BIT_COUNT_OFFSET   = 14;
+static constexpr std::size_t   DIB_COMPRESSION_OFFSET = 16;
+static constexpr std::size_t   DIB_IMAGE_SIZE_OFFSET  = 20;
+static constexpr std::size_t   DIB_COLORS_USED_OFFSET = 32;
+static constexpr std::uint32_t DIB_MIN_HEADER_SIZE    = 40;
+static constexpr std::uint32_t DIB_MAX_HEADER_SIZE    = 124;
+
+///
+/// \brief BI_BITFIELDS, the color masks follow a 40-byte header.
+///
+static constexpr std::uint32_t BITFIELDS_COMPRESSION = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Reads a value from a payload.
+/// \param bytes: The payload.
+/// \param offset: The offset of the value.
+/// \param big_endian: true for PNG fields, false for DIB fields.
+/// \returns The value.
+///
+template<typename T>
+static T read_field(std::span<const std::uint8_t> bytes,
+                    std::size_t                   offset,
+                    bool                          big_endian);
+
+///
+/// \brief Writes a PNG entry verbatim.
+/// \param file: The mapped ICO file.
+/// \param entry: The entry.
+/// \param output_path: The path without extension.
+/// \returns The path of the written file.
+///
+static std::string write_png(const mapped_file&      file,
+                             const icon::icon_entry& entry,
+                             const std::string&      output_path);
+
+///
+/// \brief Writes a DIB entry as a BMP file, without its AND mask.
+/// \param file: The mapped ICO file.
+/// \param entry: The entry.
+/// \param output_path: The path without extension.
+/// \returns The path of the written file.
+///
+static std::string write_bmp(const mapped_file&      file,
+                             const icon::icon_entry& entry,
+                             const std::string&      output_path);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> split_icon(const std::string_view icon_path,
+                                    const std::string_view output_directory,
+                                    const std::string_view name)
+{
+	const mapped_file                   file    = mapped_file{ icon_path };
+	const std::span<const std::uint8_t> bytes   = file.get_bytes();
+	const std::string                   stem    = name.empty() ? std::filesystem::path{ icon_path }.stem().string() : std::string{ name };
+	icon::header                        header  = {};
+	std::vector<std::string>            written = {};
+	std::set<std::string>               names   = {};
+
+	if (bytes.size() < sizeof(header))
+	{
+		throw std::invalid_argument{ std::format("\"{}\" is not an ICO or CUR file!", icon_path) };
+	}
+
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	if (0 != header.reserved || (1 != header.type && 2 != header.type) || bytes.size() < sizeof(header) + header.entries_count * sizeof(icon::icon_entry))
+	{
+		throw std::invalid_argument{ std::format("\"{}\" is not an ICO or CUR file!", icon_path) };
+	}
+
+	std::filesystem::create_directories(output_directory);
+
+	for (std::uint16_t index = 0; index < header.entries_count; ++index)
+	{
+		icon::icon_entry entry = {};
+
+		std::memcpy(&entry, bytes.data() + sizeof(header) + index * sizeof(entry), sizeof(entry));
+
+		if (bytes.size() < entry.image_offset || bytes.size() - entry.image_offset < entry.image_size || DIB_MIN_HEADER_SIZE > entry.image_size)
+		{
+			throw std::invalid_argument{ std::format("Entry {} of \"{}\" is outside of the file!", index, icon_path) };
+		}
+
+		const std::span<const std::uint8_t> payload = bytes.subspan(entry.image_offset, entry.image_size);
+		const bool                          png     = std::equal(PNG_MAGIC.begin(), PNG_MAGIC.end(), payload.begin());
+		const std::uint32_t                 width   = png ? read_field<std::uint32_t>(payload, PNG_WIDTH_OFFSET, true) : read_field<std::uint32_t>(payload, DIB_WIDTH_OFFSET, false);
+		const std::uint32_t                 height  = png ? read_field<std::uint32_t>(payload, PNG_HEIGHT_OFFSET, true) : read_field<std::uint32_t>(payload, DIB_HEIGHT_OFFSET, false) / 2;
+		const std::uint32_t                 depth   = png ? payload[PNG_BIT_DEPTH_OFFSET] * PNG_CHANNELS[std::min<std::size_t>(payload[PNG_COLOR_TYPE_OFFSET], PNG_CHANNELS.size() - 1)]
+		                                                  : read_field<std::uint16_t>(payload, DIB_BIT_COUNT_OFFSET, false);
+		std::string                         file_name = std::format("{}_{}x{}_{}bit", stem, width, height, depth);
+
+		// Several entries with the same size and depth are told apart by their index.
+		if (!names.insert(file_name).second)
+		{
+			file_name = std::format("{}_{}", file_name, index);
+			names.insert(file_name);
+		}
+
+		const std::string output_path = (std::filesystem::path{ output_directory } / file_name).string();
+
+		written.push_back(png ? write_png(file, entry, output_path) : write_bmp(file, entry, output_path));
+	}
+
+	LOG("Split \"{}\" into {} file(s).", icon_path, written.size());
+
+	return written;
+}
+
+void split_icons_cli(const std::string_view input_path,
+                     const std::string_view output_directory)
+{
+	if (!std::filesystem::is_directory(input_path))
+	{
+		const std::vector<std::string> written = split_icon(input_path, output_directory);
+
+		std::println(GRN "Split \"{}\" into {} file(s)!" CRESET, input_path, written.size());
+		return;
+	}
+
+	std::vector<std::filesystem::path>            icons  = {};
+	std::map<std::filesystem::path, std::size_t> stems  = {};
+	std::vector<std::string>                      names  = {};
+	std::atomic<std::size_t>                      files  = 0;
+	std::atomic<std::size_t>                      failed = 0;
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ input_path })
+	{
+		std::string extension = entry.path().extension().string();
+
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](const char character)
+		{
+			return 'A' <= character && 'Z' >= character ? static_cast<char>(character - 'A' + 'a') : character;
+		});
+
+		if (entry.is_regular_file() && (".ico" == extension || ".cur" == extension))
+		{
+			icons.push_back(entry.path());
+		}
+	}
+
+	std::sort(icons.begin(), icons.end());
+
+	// Icons sharing a directory and a stem would write the same files from
+	// different workers, so they are told apart by their extension.
+	for (const std::filesystem::path& icon : icons)
+	{
+		++stems[icon.parent_path() / icon.stem()];
+	}
+
+	for (const std::filesystem::path& icon : icons)
+	{
+		names.push_back(1 == stems[icon.parent_path() / icon.stem()] ? std::string{} : std::format("{}_{}", icon.stem().string(), icon.extension().string().substr(1)));
+	}
+
+	parallel_for(icons.size(), [&icons, &names, &files, &failed, input_path, output_directory](const std::size_t index)
+	{
+		const std::filesystem::path directory = std::filesystem::path{ output_directory } / icons[index].parent_path().lexically_relative(input_path);
+
+		try
+		{
+			files.fetch_add(split_icon(icons[index].string(), directory.string(), names[index]).size(), std::memory_order_relaxed);
+		}
+		catch (const std::exception& exception)
+		{
+			std::println(RED "{}: {}" CRESET, icons[index].string(), exception.what());
+			failed.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	if (0 != failed)
+	{
+		throw std::runtime_error{ std::format("{} of {} icon(s) failed!", failed.load(), icons.size()) };
+	}
+
+	std::println(GRN "Split {} icon(s) into {} file(s)!" CRESET, icons.size(), files.load());
+}
+
+template<typename T>
+static T read_field(const std::span<const std::uint8_t> bytes,
+                    const std::size_t                   offset,
+                    const bool                          big_endian)
+{
+	T value = {};
+
+	if (bytes.size() < offset + sizeof(value))
+	{
+		throw std::invalid_argument{ "Entry header is truncated!" };
+	}
+
+	std::memcpy(&value, bytes.data() + offset, sizeof(value));
+
+	return big_endian ? std::byteswap(value) : value;
+}
+
+static std::string write_png(const mapped_file&      file,
+                             const icon::icon_entry& entry,
+                             const std::string&      output_path)
+{
+	const std::string path   = output_path + ".png";
+	file_writer       writer = file_writer{ path };
+
+	writer.copy(file, entry.image_offset, entry.image_size);
+
+	return path;
+}
+
+static std::string write_bmp(const mapped_file&      file,
+                             const icon::icon_entry& entry,
+                             const std::string&      output_path)
+{
+	const std::span<const std::uint8_t> payload     = file.get_bytes().subspan(entry.image_offset, entry.image_size);
+	const std::uint32_t                 header_size = read_field<std::uint32_t>(payload, 0, false);
+
+	if (DIB_MIN_HEADER_SIZE > header_size || DIB_MAX_HEADER_SIZE < header_size || payload.size() < header_size)
+	{
+		throw std::invalid_argument{ std::format("Entry header size {} is invalid!", header_size) };
+	}
+
+	const std::int32_t  width       = read_field<std::int32_t>(payload, DIB_WIDTH_OFFSET, false);
+	const std::int32_t  height      = read_field<std::int32_t>(payload, DIB_HEIGHT_OFFSET, false) / 2;
+	const std::uint16_t bit_count   = read_field<std::uint16_t>(payload, DIB_BIT_COUNT_OFFSET, false);
+	const std::uint32_t compression = read_field<std::uint32_t>(payload, DIB_COMPRESSION_OFFSET, false);
+	const std::uint32_t colors_used = read_field<std::uint32_t>(payload, DIB_COLORS_USED_OFFSET, false);
+	const std::size_t   masks_size  = BITFIELDS_COMPRESSION == compression && DIB_MIN_HEADER_SIZE == header_size ? 3 * sizeof(std::uint32_t) : 0;
+	const std::size_t   colors      = 0 != colors_used ? colors_used : (8 >= bit_count ? std::size_t{ 1 } << bit_count : 0);
+	const std::size_t   pixels_size = (static_cast<std::size_t>(std::abs(width)) * bit_count + 31) / 32 * 4 * static_cast<std::size_t>(std::abs(height));
+	const std::size_t   body_size   = masks_size + colors * 4 + pixels_size;
+
+	if (payload.size() - header_size < body_size)
+	{
+		throw std::invalid_argument{ std::format("Entry of {} bytes is too small for {}x{} {}-bit pixels!", payload.size(), width, height, bit_count) };
+	}
+
+	const bmp_file_header     file_header = { 0x4D42, static_cast<std::uint32_t>(sizeof(bmp_file_header) + header_size + body_size), 0,
+	                                          static_cast<std::uint32_t>(sizeof(bmp_file_header) + header_size + masks_size + colors * 4) };
+	const std::uint32_t       image_size  = static_cast<std::uint32_t>(pixels_size);
+	std::vector<std::uint8_t> headers     = std::vector<std::uint8_t>(sizeof(file_header) + header_size);
+	const std::string         path        = output_path + ".bmp";
+	file_writer               writer      = file_writer{ path };
+
+	std::memcpy(headers.data(), &file_header, sizeof(file_header));
+	std::memcpy(headers.data() + sizeof(file_header), payload.data(), header_size);
+	std::memcpy(headers.data() + sizeof(file_header) + DIB_HEIGHT_OFFSET, &height, sizeof(height));
+	std::memcpy(headers.data() + sizeof(file_header) + DIB_IMAGE_SIZE_OFFSET, &image_size, sizeof(image_size));
+
+	writer.write(headers);
+	writer.copy(file, entry.image_offset + header_size, body_size);
+
+	return path;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Writes every entry of an ICO or CUR file to its own file.
+/// \details PNG entries are copied verbatim, DIB entries get a BMP file header
+/// and lose their AND mask. Files are named after the icon, the size and the
+/// depth of the entry (e.g. app_48x48_32bit.bmp). The payloads are spliced
+/// from the source file without passing through user space when possible.
+/// \param icon_path: The path to the ICO or CUR file.
+/// \param output_directory: The directory receiving the files, created if
+/// needed.
+/// \param name: The name of the files before the size and depth, the stem of
+/// the icon if empty.
+/// \returns The paths of the written files, in entry order.
+///
+extern std::vector<std::string> split_icon(std::string_view icon_path,
+                                           std::string_view output_directory,
+                                           std::string_view name = {});
+
+///
+/// \brief CLI entry point for `--split`.
+/// \details A directory is searched recursively for ICO and CUR files, which
+/// are split in parallel into the same relative directories below the output
+/// directory. Icons of a directory sharing their stem (e.g. app.ico and
+/// app.cur) also get their extension in the names (app_ico_48x48_32bit.bmp).
+/// A failed icon does not stop the others.
+/// \param input_path: The ICO or CUR file, or a directory.
+/// \param output_directory: The directory receiving the files.
+///
+extern void split_icons_cli(std::string_view input_path,
+                            std::string_view output_directory);
+
+} // namespace icon_changer
@@ -0,0 +1,500 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "io_strategy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/vfs.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Marker of a threshold that is never reached.
+///
+static constexpr std::uint64_t NEVER = std::numeric_limits<std::uint64_t>::max();
+
+///
+/// \brief Names of the file system kinds, indexed by filesystem_kind.
+///
+static constexpr std::array<std::string_view, FILESYSTEM_KIND_COUNT> KIND_NAMES = { "local", "memory", "network", "overlay" };
+
+#ifdef __linux__
+///
+/// \brief statfs() magic numbers of the file systems that are not local disks.
+/// \see linux/magic.h
+///
+static constexpr std::array<std::uint32_t, 2> MEMORY_MAGICS  = { 0x01021994, 0x858458F6 }; // tmpfs, ramfs
+static constexpr std::array<std::uint32_t, 8> NETWORK_MAGICS = {
+	0x00006969, // NFS
+	0x0000517B, // SMB
+	0xFF534D42, // CIFS
+	0xFE534D42, // SMB2
+	0x65735546, // FUSE
+	0x00C36400, // Ceph
+	0x5346414F, // AFS
+	0x01021997, // 9P
+};
+static constexpr std::uint32_t OVERLAY_MAGIC = 0x794C7630;
+#endif
+
+///
+/// \brief File sizes measured by calibrate_io(), 4 KiB to 16 MiB.
+///
+static constexpr std::array<std::uint64_t, 7> CALIBRATION_SIZES = { 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20, 1 << 22, 1 << 24 };
+
+///
+/// \brief Bytes moved per measurement, so small files are timed many times.
+///
+static constexpr std::uint64_t CALIBRATION_BYTES = 16 << 20;
+
+///
+/// \brief Distance between the bytes read to touch a buffer or a mapping.
+///
+static constexpr std::size_t TOUCH_STRIDE = 64;
+
+///
+/// \brief The thresholds of the process, see set_io_thresholds().
+///
+static std::array<std::atomic<std::uint64_t>, FILESYSTEM_KIND_COUNT> map_sizes    = {};
+static std::array<std::atomic<std::uint64_t>, FILESYSTEM_KIND_COUNT> splice_sizes = {};
+static std::atomic<bool>                                             configured   = false;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Sums bytes of a buffer TOUCH_STRIDE apart, so every cache line is
+/// read like a user of the data would.
+/// \param bytes: The bytes.
+/// \returns The sum.
+///
+static std::uint64_t touch(std::span<const std::uint8_t> bytes) noexcept;
+
+///
+/// \brief Times an operation.
+/// \param repetitions: How many times the operation is run.
+/// \param operation: The operation.
+/// \returns The fastest run, in nanoseconds.
+///
+static std::uint64_t time_fastest(std::uint64_t                repetitions,
+                                  const std::function<void()>& operation);
+
+///
+/// \brief Finds the smallest size from which a method stays faster.
+/// \param faster: Whether the method was faster, per CALIBRATION_SIZES.
+/// \returns The size, 0 if it always was, NEVER if it was not at the end.
+///
+static std::uint64_t find_crossover(const std::array<bool, CALIBRATION_SIZES.size()>& faster) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::string_view to_string(const filesystem_kind kind) noexcept
+{
+	return KIND_NAMES[static_cast<std::size_t>(kind)];
+}
+
+filesystem_kind detect_filesystem(const std::string_view file_path) noexcept
+{
+#ifdef _WIN32
+	std::array<char, MAX_PATH + 1> root = {};
+
+	if (FALSE == GetVolumePathNameA(std::string{ file_path }.c_str(), root.data(), static_cast<DWORD>(root.size())))
+	{
+		return filesystem_kind::local;
+	}
+
+	const UINT type = GetDriveTypeA(root.data());
+
+	if (DRIVE_REMOTE == type)
+	{
+		return filesystem_kind::network;
+	}
+
+	return DRIVE_RAMDISK == type ? filesystem_kind::memory : filesystem_kind::local;
+#elif defined(__linux__)
+	struct statfs status = {};
+
+	if (0 != statfs(std::string{ file_path }.c_str(), &status))
+	{
+		return filesystem_kind::local;
+	}
+
+	const std::uint32_t magic = static_cast<std::uint32_t>(status.f_type);
+
+	if (MEMORY_MAGICS.end() != std::find(MEMORY_MAGICS.begin(), MEMORY_MAGICS.end(), magic))
+	{
+		return filesystem_kind::memory;
+	}
+
+	if (NETWORK_MAGICS.end() != std::find(NETWORK_MAGICS.begin(), NETWORK_MAGICS.end(), magic))
+	{
+		return filesystem_kind::network;
+	}
+
+	return OVERLAY_MAGIC == magic ? filesystem_kind::overlay : filesystem_kind::local;
+#else
+	static_cast<void>(file_path);
+	return filesystem_kind::local;
+#endif
+}
+
+read_method select_read_method(const std::string_view file_path) noexcept
+{
+	std::error_code     error = {};
+	const std::uint64_t size  = std::filesystem::file_size(std::filesystem::path{ file_path }, error);
+
+	if (error)
+	{
+		return read_method::buffered;
+	}
+
+	return get_io_thresholds().map_size[static_cast<std::size_t>(detect_filesystem(file_path))] <= size ? read_method::mapped : read_method::buffered;
+}
+
+bool should_splice(const filesystem_kind kind,
+                   const std::uint64_t   size) noexcept
+{
+	return get_io_thresholds().splice_size[static_cast<std::size_t>(kind)] <= size;
+}
+
+io_thresholds get_default_io_thresholds() noexcept
+{
+	// Mapped icons are spliced into executables without passing through
+	// memory. Over the network every page fault is a round trip, so files
+	// there are read. Kernel copies can reflink or copy server side.
+	return { { 0, 0, NEVER, 0 }, { 0, 0, 0, 0 } };
+}
+
+void set_io_thresholds(const io_thresholds& thresholds) noexcept
+{
+	for (std::size_t index = 0; index < FILESYSTEM_KIND_COUNT; ++index)
+	{
+		map_sizes[index]    = thresholds.map_size[index];
+		splice_sizes[index] = thresholds.splice_size[index];
+	}
+
+	configured = true;
+}
+
+io_thresholds get_io_thresholds() noexcept
+{
+	if (!configured)
+	{
+		return get_default_io_thresholds();
+	}
+
+	io_thresholds thresholds = {};
+
+	for (std::size_t index = 0; index < FILESYSTEM_KIND_COUNT; ++index)
+	{
+		thresholds.map_size[index]    = map_sizes[index];
+		thresholds.splice_size[index] = splice_sizes[index];
+	}
+
+	return thresholds;
+}
+
+std::string get_io_config_path()
+{
+	static constexpr std::string_view CONFIG_FILE = "icon-changer/io.conf";
+
+	const char* const override = std::getenv("ICON_CHANGER_IO_CONFIG");
+
+	if (nullptr != override)
+	{
+		return override;
+	}
+
+#ifdef _WIN32
+	const char* const application_data = std::getenv("APPDATA");
+
+	return nullptr == application_data ? std::string{} : (std::filesystem::path{ application_data } / CONFIG_FILE).string();
+#else
+	const char* const config_home = std::getenv("XDG_CONFIG_HOME");
+	const char* const home        = std::getenv("HOME");
+
+	if (nullptr != config_home && '\0' != *config_home)
+	{
+		return (std::filesystem::path{ config_home } / CONFIG_FILE).string();
+	}
+
+	return nullptr == home ? std::string{} : (std::filesystem::path{ home } / ".config" / CONFIG_FILE).string();
+#endif
+}
+
+io_thresholds read_io_thresholds(const std::string_view file_path)
+{
+	std::ifstream file       = std::ifstream{ std::string{ file_path } };
+	io_thresholds thresholds = get_default_io_thresholds();
+	std::string   line       = {};
+	std::size_t   number     = 0;
+
+	if (!file.is_open())
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+	}
+
+	while (std::getline(file, line))
+	{
+		++number;
+
+		if (!line.empty() && '\r' == line.back())
+		{
+			line.pop_back();
+		}
+
+		if (line.empty() || '#' == line.front())
+		{
+			continue;
+		}
+
+		const std::size_t separator = line.find(" = ");
+		const std::size_t dot       = line.find('.');
+
+		if (std::string::npos == separator || std::string::npos == dot || dot > separator)
+		{
+			throw std::invalid_argument{ std::format("Line {} of \"{}\" is not \"<threshold>.<file_system> = <bytes>\"!", number, file_path) };
+		}
+
+		const std::string_view key   = std::string_view{ line }.substr(0, dot);
+		const std::string_view kind  = std::string_view{ line }.substr(dot + 1, separator - dot - 1);
+		const std::string_view value = std::string_view{ line }.substr(separator + 3);
+		const auto             found = std::find(KIND_NAMES.begin(), KIND_NAMES.end(), kind);
+		std::uint64_t          size  = NEVER;
+
+		if ("never" != value)
+		{
+			const std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), size);
+
+			if (std::errc{} != result.ec || value.data() + value.size() != result.ptr)
+			{
+				throw std::invalid_argument{ std::format("Line {} of \"{}\" has an invalid size \"{}\"!", number, file_path, value) };
+			}
+		}
+
+		if (KIND_NAMES.end() == found || ("map_size" != key && "splice_size" != key))
+		{
+			throw std::invalid_argument{ std::format("Line {} of \"{}\" has an unknown threshold \"{}.{}\"!", number, file_path, key, kind) };
+		}
+
+		("map_size" == key ? thresholds.map_size : thresholds.splice_size)[static_cast<std::size_t>(found - KIND_NAMES.begin())] = size;
+	}
+
+	return thresholds;
+}
+
+void write_io_thresholds(const std::string_view file_path,
+                         const io_thresholds&   thresholds)
+{
+	const std::filesystem::path path     = std::filesystem::path{ file_path };
+	std::string                 contents = "# I/O thresholds in bytes, written by icon-changer --calibrate.\n";
+
+	if (path.has_parent_path())
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	for (std::size_t index = 0; index < FILESYSTEM_KIND_COUNT; ++index)
+	{
+		const std::uint64_t map_size    = thresholds.map_size[index];
+		const std::uint64_t splice_size = thresholds.splice_size[index];
+
+		contents += NEVER == map_size ? std::format("map_size.{} = never\n", KIND_NAMES[index]) : std::format("map_size.{} = {}\n", KIND_NAMES[index], map_size);
+		contents += NEVER == splice_size ? std::format("splice_size.{} = never\n", KIND_NAMES[index]) : std::format("splice_size.{} = {}\n", KIND_NAMES[index], splice_size);
+	}
+
+	std::ofstream file = std::ofstream{ path, std::ios::binary };
+
+	if (!file.write(contents.data(), static_cast<std::streamsize>(contents.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to write \"{}\"!", file_path) };
+	}
+}
+
+io_thresholds calibrate_io(const std::string_view directory,
+                           const io_thresholds&   thresholds)
+{
+	const filesystem_kind                      kind         = detect_filesystem(directory);
+	const std::size_t                          index        = static_cast<std::size_t>(kind);
+	const std::filesystem::path                source       = std::filesystem::path{ directory } / "icon-changer-calibration.bin";
+	const std::filesystem::path                target       = std::filesystem::path{ directory } / "icon-changer-calibration.out";
+	const io_thresholds                        saved        = get_io_thresholds();
+	std::array<bool, CALIBRATION_SIZES.size()> mapped_wins  = {};
+	std::array<bool, CALIBRATION_SIZES.size()> spliced_wins = {};
+	io_thresholds                              calibrated   = thresholds;
+	std::atomic<std::uint64_t>                 sink         = 0;
+
+	try
+	{
+		for (std::size_t size_index = 0; size_index < CALIBRATION_SIZES.size(); ++size_index)
+		{
+			const std::uint64_t size        = CALIBRATION_SIZES[size_index];
+			const std::uint64_t repetitions = std::max<std::uint64_t>(3, CALIBRATION_BYTES / size);
+
+			{
+				std::ofstream file = std::ofstream{ source, std::ios::binary };
+
+				file << std::string(static_cast<std::size_t>(size), '\x5A');
+
+				if (!file)
+				{
+					throw std::runtime_error{ std::format("Failed to write \"{}\"!", source.string()) };
+				}
+			}
+
+			const std::uint64_t buffered = time_fastest(repetitions, [&source, size, &sink]()
+			{
+				std::ifstream             file  = std::ifstream{ source, std::ios::binary };
+				std::vector<std::uint8_t> bytes = std::vector<std::uint8_t>(static_cast<std::size_t>(size));
+
+				file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+				sink += touch(bytes);
+			});
+
+			const std::uint64_t mapped = time_fastest(repetitions, [&source, &sink]()
+			{
+				const mapped_file file = mapped_file{ source.string() };
+
+				sink += touch(file.get_bytes());
+			});
+
+			// The same copy, forced through each path of file_writer::copy().
+			const auto copy = [&source, &target, size, &calibrated, index](const std::uint64_t splice_size)
+			{
+				io_thresholds forced = calibrated;
+
+				forced.splice_size[index] = splice_size;
+				set_io_thresholds(forced);
+
+				const mapped_file file   = mapped_file{ source.string() };
+				file_writer       writer = file_writer{ target.string() };
+
+				writer.copy(file, 0, size);
+			};
+
+			const std::uint64_t spliced = time_fastest(repetitions, [&copy]()
+			{
+				copy(0);
+			});
+
+			const std::uint64_t written = time_fastest(repetitions, [&copy]()
+			{
+				copy(NEVER);
+			});
+
+			set_io_thresholds(saved);
+
+			mapped_wins[size_index]  = mapped < buffered;
+			spliced_wins[size_index] = spliced < written;
+
+			LOG("{} bytes: read {} ns, mapped {} ns, spliced {} ns, written {} ns.", size, buffered, mapped, spliced, written);
+		}
+	}
+	catch (...)
+	{
+		std::error_code error = {};
+
+		set_io_thresholds(saved);
+		std::filesystem::remove(source, error);
+		std::filesystem::remove(target, error);
+		throw;
+	}
+
+	std::filesystem::remove(source);
+	std::filesystem::remove(target);
+
+	calibrated.map_size[index]    = find_crossover(mapped_wins);
+	calibrated.splice_size[index] = find_crossover(spliced_wins);
+
+	return calibrated;
+}
+
+static std::uint64_t touch(const std::span<const std::uint8_t> bytes) noexcept
+{
+	std::uint64_t sum = 0;
+
+	for (std::size_t offset = 0; offset < bytes.size(); offset += TOUCH_STRIDE)
+	{
+		sum += bytes[offset];
+	}
+
+	return sum;
+}
+
+static std::uint64_t time_fastest(const std::uint64_t          repetitions,
+                                  const std::function<void()>& operation)
+{
+	std::uint64_t fastest = NEVER;
+
+	for (std::uint64_t repetition = 0; repetition < repetitions; ++repetition)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		operation();
+
+		const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+
+		fastest = std::min<std::uint64_t>(fastest, static_cast<std::uint64_t>(elapsed.count()));
+	}
+
+	return fastest;
+}
+
+static std::uint64_t find_crossover(const std::array<bool, CALIBRATION_SIZES.size()>& faster) noexcept
+{
+	std::uint64_t crossover = NEVER;
+
+	// Walking down from the largest size, as long as the method keeps winning.
+	for (std::size_t index = faster.size(); 0 != index && faster[index - 1]; --index)
+	{
+		crossover = 1 == index ? 0 : CALIBRATION_SIZES[index - 1];
+	}
+
+	return crossover;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief File systems that call for different I/O.
+///
+enum class filesystem_kind
+{
+	local,   ///< Block devices (ext4, XFS, Btrfs, NTFS, ...).
+	memory,  ///< RAM-backed (tmpfs, ramfs, RAM disks): mapping is free.
+	network, ///< NFS, SMB, FUSE: every page fault is a round trip and a file
+	         ///< truncated by another client kills a mapping with SIGBUS.
+	overlay, ///< Container layers (overlayfs).
+};
+
+///
+/// \brief Number of filesystem_kind values.
+///
+inline constexpr std::size_t FILESYSTEM_KIND_COUNT = 4;
+
+///
+/// \brief How a file is read.
+///
+enum class read_method
+{
+	buffered, ///< Read into memory with read().
+	mapped,   ///< Memory mapped, paged in on demand.
+};
+
+///
+/// \brief Sizes from which the I/O changes, per file system kind.
+/// \details Measured by `--calibrate`, see calibrate_io().
+///
+struct io_thresholds final
+{
+	std::array<std::uint64_t, FILESYSTEM_KIND_COUNT> map_size;    ///< Smallest file mapped instead of read, UINT64_MAX for never.
+	std::array<std::uint64_t, FILESYSTEM_KIND_COUNT> splice_size; ///< Smallest range copied in the kernel (copy_file_range) instead of written from its mapping.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Names a file system kind, as in the configuration file.
+/// \param kind: The kind.
+/// \returns "local", "memory", "network" or "overlay".
+///
+extern std::string_view to_string(filesystem_kind kind) noexcept;
+
+///
+/// \brief Finds the kind of file system holding a file (statfs, or the drive
+/// type on Windows).
+/// \param file_path: The path to an existing file or directory.
+/// \returns The kind, local if unknown.
+///
+extern filesystem_kind detect_filesystem(std::string_view file_path) noexcept;
+
+///
+/// \brief Chooses how to read a file from its size and file system.
+/// \param file_path: The path to the file.
+/// \returns The method, buffered if the file cannot be inspected.
+///
+extern read_method select_read_method(std::string_view file_path) noexcept;
+
+///
+/// \brief Chooses whether to copy a range of a file in the kernel.
+/// \param kind: The file system of the file being written.
+/// \param size: The size of the range in bytes.
+/// \returns Whether to use copy_file_range.
+///
+extern bool should_splice(filesystem_kind kind,
+                          std::uint64_t   size) noexcept;
+
+///
+/// \brief Gets the thresholds used without calibration.
+/// \returns The thresholds.
+///
+extern io_thresholds get_default_io_thresholds() noexcept;
+
+///
+/// \brief Sets the thresholds for the whole process.
+/// \param thresholds: The thresholds.
+///
+extern void set_io_thresholds(const io_thresholds& thresholds) noexcept;
+
+///
+/// \brief Gets the thresholds for the whole process.
+/// \returns The thresholds.
+///
+extern io_thresholds get_io_thresholds() noexcept;
+
+///
+/// \brief Gets the path of the configuration file.
+/// \details $ICON_CHANGER_IO_CONFIG if set, otherwise icon-changer/io.conf in
+/// $XDG_CONFIG_HOME, ~/.config or %APPDATA%.
+/// \returns The path, empty if there is no home directory.
+///
+extern std::string get_io_config_path();
+
+///
+/// \brief Reads thresholds from a configuration file.
+/// \details Lines are "map_size.<kind> = <bytes>" or "splice_size.<kind> =
+/// <bytes>", "never" standing for UINT64_MAX; empty lines and lines starting
+/// with '#' are skipped. Missing keys keep their defaults.
+/// \param file_path: The path to the file.
+/// \returns The thresholds.
+///
+extern io_thresholds read_io_thresholds(std::string_view file_path);
+
+///
+/// \brief Writes thresholds to a configuration file, creating its directory.
+/// \param file_path: The path to the file.
+/// \param thresholds: The thresholds.
+///
+extern void write_io_thresholds(std::string_view     file_path,
+                                const io_thresholds& thresholds);
+
+///
+/// \brief Measures where mapping and kernel copies start to pay off on the
+/// file system of a directory.
+/// \details Times buffered reads against mapped reads and kernel copies
+/// against writes from a mapping for files from 4 KiB to 16 MiB, and takes
+/// the smallest size from which the former wins for good. The test files are
+/// removed afterwards.
+/// \param directory: A directory on the file system to be measured.
+/// \param thresholds: The thresholds of the other file systems, kept.
+/// \returns The thresholds, updated for the measured file system.
+///
+extern io_thresholds calibrate_io(std::string_view     directory,
+                                  const io_thresholds& thresholds);
+
+} // namespace icon_changer
@@ -0,0 +1,265 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "journal.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Lines written before they are synced, whichever limit comes first.
+///
+static constexpr std::size_t               SYNC_LINES    = 256;
+static constexpr std::chrono::milliseconds SYNC_INTERVAL = std::chrono::milliseconds{ 500 };
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Parses a digest formatted by sha256::to_string().
+/// \param text: 64 hexadecimal characters.
+/// \returns The digest, nothing if the text is not one.
+///
+static std::optional<sha256::digest> parse_digest(std::string_view text);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+journal::journal(const std::string_view file_path)
+    : path{ file_path }
+    , entries{}
+    , mutex{}
+    , pending{}
+    , count{ 0 }
+    , synced{ std::chrono::steady_clock::now() }
+{
+	std::ifstream     file     = std::ifstream{ path, std::ios::binary };
+	const std::string contents = std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	std::size_t       start    = 0;
+
+	// Lines are "<output>\t<input>\t<size>\t<target>", a torn or foreign line
+	// is skipped: its update is simply redone.
+	for (std::size_t end = contents.find('\n'); std::string::npos != end; start = end + 1, end = contents.find('\n', start))
+	{
+		const std::string_view line   = std::string_view{ contents }.substr(start, end - start);
+		const std::size_t      first  = line.find('\t');
+		const std::size_t      second = std::string_view::npos == first ? first : line.find('\t', first + 1);
+		const std::size_t      third  = std::string_view::npos == second ? second : line.find('\t', second + 1);
+
+		if (std::string_view::npos == third)
+		{
+			continue;
+		}
+
+		const std::optional<sha256::digest> output = parse_digest(line.substr(0, first));
+		const std::optional<sha256::digest> input  = parse_digest(line.substr(first + 1, second - first - 1));
+		std::uint64_t                       size   = 0;
+		const std::from_chars_result        result = std::from_chars(line.data() + second + 1, line.data() + third, size);
+
+		if (!output.has_value() || !input.has_value() || std::errc{} != result.ec || line.data() + third != result.ptr || line.size() - 1 == third)
+		{
+			continue;
+		}
+
+		entries.insert_or_assign(std::string{ line.substr(third + 1) }, entry{ *input, *output, size });
+	}
+
+#ifdef _WIN32
+	handle = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (INVALID_HANDLE_VALUE == handle)
+	{
+		throw std::runtime_error{ std::format("Failed to open \"{}\"!", path) };
+	}
+#else
+	descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+
+	if (-1 == descriptor)
+	{
+		throw std::runtime_error{ std::format("Failed to open \"{}\"!", path) };
+	}
+#endif
+
+	// A torn last line would swallow the next one.
+	if (contents.size() != start)
+	{
+		pending = "\n";
+	}
+}
+
+journal::~journal() noexcept
+{
+	try
+	{
+		flush();
+	}
+	catch (const std::exception&)
+	{
+		// The lines that were not synced only cause their updates to be redone.
+	}
+
+#ifdef _WIN32
+	CloseHandle(handle);
+#else
+	close(descriptor);
+#endif
+}
+
+bool journal::is_complete(const std::string&    target_path,
+                          const sha256::digest& input) const noexcept
+{
+	try
+	{
+		const auto      found = entries.find(target_path);
+		std::error_code error = {};
+
+		if (entries.end() == found || found->second.input != input || found->second.size != std::filesystem::file_size(target_path, error) || error)
+		{
+			return false;
+		}
+
+		return found->second.output == sha256::hash_file(target_path);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+}
+
+void journal::record(const std::string&    target_path,
+                     const sha256::digest& input,
+                     const sha256::digest& output,
+                     const std::uint64_t   size)
+{
+	const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ mutex };
+
+	pending += std::format("{}\t{}\t{}\t{}\n", sha256::to_string(output), sha256::to_string(input), size, target_path);
+	++count;
+
+	if (SYNC_LINES <= count || SYNC_INTERVAL <= std::chrono::steady_clock::now() - synced)
+	{
+		flush_locked();
+	}
+}
+
+void journal::flush()
+{
+	const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ mutex };
+
+	flush_locked();
+}
+
+void journal::flush_locked()
+{
+	std::string_view bytes = pending;
+
+	while (!bytes.empty())
+	{
+#ifdef _WIN32
+		DWORD written = 0;
+
+		if (FALSE == WriteFile(handle, bytes.data(), static_cast<DWORD>(std::min<std::size_t>(bytes.size(), MAXDWORD)), &written, nullptr))
+		{
+			throw std::runtime_error{ std::format("Failed to write \"{}\"!", path) };
+		}
+#else
+		const ssize_t written = ::write(descriptor, bytes.data(), bytes.size());
+
+		if (0 > written && EINTR == errno)
+		{
+			continue;
+		}
+
+		if (0 > written)
+		{
+			throw std::runtime_error{ std::format("Failed to write \"{}\"!", path) };
+		}
+#endif
+
+		bytes.remove_prefix(static_cast<std::size_t>(written));
+	}
+
+	if (0 != count)
+	{
+#ifdef _WIN32
+		const bool failed = FALSE == FlushFileBuffers(handle);
+#else
+		const bool failed = 0 != fdatasync(descriptor);
+#endif
+
+		if (failed)
+		{
+			throw std::runtime_error{ std::format("Failed to sync \"{}\"!", path) };
+		}
+	}
+
+	pending.clear();
+	count  = 0;
+	synced = std::chrono::steady_clock::now();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static std::optional<sha256::digest> parse_digest(const std::string_view text)
+{
+	sha256::digest digest = {};
+
+	if (2 * digest.size() != text.size())
+	{
+		return std::nullopt;
+	}
+
+	for (std::size_t index = 0; index < digest.size(); ++index)
+	{
+		const std::from_chars_result result = std::from_chars(text.data() + 2 * index, text.data() + 2 * index + 2, digest[index], 16);
+
+		if (std::errc{} != result.ec || text.data() + 2 * index + 2 != result.ptr)
+		{
+			return std::nullopt;
+		}
+	}
+
+	return digest;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Append-only journal of the updates a batch completed, see
+/// `--journal`.
+/// \details Every line records a target, the hash of what was stamped into
+/// it and the size and hash of the result. A rerun skips the targets that
+/// still match their line, so an interrupted batch resumes where it stopped
+/// at the cost of a stat and a hash per completed target. Lines are synced
+/// to disk in batches; the ones lost in a crash only cause their updates to
+/// be redone, and a torn last line is ignored.
+///
+class journal final
+{
+public:
+	///
+	/// \brief Constructor to read a journal, created if missing.
+	/// \param file_path: The path to the journal.
+	///
+	explicit journal(std::string_view file_path);
+
+	///
+	/// \brief Destructor to sync the pending lines and close the file.
+	///
+	~journal() noexcept;
+
+	journal(const journal&) = delete;
+
+	journal& operator=(const journal&) = delete;
+
+	///
+	/// \brief Checks whether a target is still as a previous update left it.
+	/// \details Compares the size first, and only hashes the target if it
+	/// matches. A target that cannot be read is not complete, so the update
+	/// is redone and reports the error itself.
+	/// \param target_path: The path to the target, as given in the job.
+	/// \param input: The hash of what would be stamped into the target.
+	/// \returns Whether the update can be skipped.
+	///
+	[[nodiscard]] bool is_complete(const std::string&    target_path,
+	                               const sha256::digest& input) const noexcept;
+
+	///
+	/// \brief Records a completed update, thread-safe.
+	/// \details The target is not read again: the hash and size must be
+	/// those of the file as written, see stamp_file().
+	/// \param target_path: The path to the target, as given in the job.
+	/// \param input: The hash of what was stamped into the target.
+	/// \param output: The hash of the target as written.
+	/// \param size: The size of the target as written.
+	///
+	void record(const std::string&    target_path,
+	            const sha256::digest& input,
+	            const sha256::digest& output,
+	            std::uint64_t         size);
+
+	///
+	/// \brief Writes and syncs the pending lines.
+	///
+	void flush();
+
+private:
+	///
+	/// \brief A completed update.
+	///
+	struct entry final
+	{
+		sha256::digest input;  ///< The hash of what was stamped.
+		sha256::digest output; ///< The hash of the result.
+		std::uint64_t  size;   ///< The size of the result in bytes.
+	};
+
+	///
+	/// \brief Writes and syncs the pending lines, the mutex being held.
+	///
+	void flush_locked();
+
+private:
+	std::string                            path;      ///< The path, for error messages.
+	std::unordered_map<std::string, entry> entries;   ///< The last entry of every target read from the file.
+	std::mutex                             mutex;     ///< Guards what follows.
+	std::string                            pending;   ///< Lines not written yet.
+	std::size_t                            count;     ///< Number of pending lines.
+	std::chrono::steady_clock::time_point  synced;    ///< When the lines were last synced.
+#ifdef _WIN32
+	void* handle; ///< The file handle.
+#else
+	std::int32_t descriptor; ///< The file descriptor.
+#endif
+};
+
+} // namespace icon_changer
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "json.hpp"
+
+#include <format>
+#include <iterator>
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+void append_json_string(std::string&           json,
+                        const std::string_view string)
+{
+	json += '"';
+
+	for (const char character : string)
+	{
+		if ('"' == character || '\\' == character)
+		{
+			json += '\\';
+			json += character;
+		}
+		else if (0x20 > static_cast<unsigned char>(character))
+		{
+			std::format_to(std::back_inserter(json), "\\u{:04x}", static_cast<unsigned char>(character));
+		}
+		else
+		{
+			json += character;
+		}
+	}
+
+	json += '"';
+}
+
+} // namespace icon_changer
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mapped_file.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(const std::string_view file_path)
+    : data{ nullptr }
+    , size{ 0 }
+{
+	const HANDLE  file = CreateFileA(std::string{ file_path }.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER length = {};
+
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+	}
+
+	if (FALSE == GetFileSizeEx(file, &length))
+	{
+		CloseHandle(file);
+		throw std::runtime_error{ std::format("Failed to get the size of \"{}\"!", file_path) };
+	}
+
+	size = static_cast<std::size_t>(length.QuadPart);
+
+	if (0 == size)
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	// The view keeps the mapping alive, so neither handle is needed afterwards.
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	CloseHandle(file);
+
+	if (nullptr == mapping)
+	{
+		throw std::runtime_error{ std::format("Failed to map \"{}\"!", file_path) };
+	}
+
+	data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+
+	if (nullptr == data)
+	{
+		throw std::runtime_error{ std::format("Failed to map \"{}\"!", file_path) };
+	}
+}
+
+mapped_file::~mapped_file() noexcept
+{
+	if (nullptr != data)
+	{
+		UnmapViewOfFile(data);
+	}
+}
+
+#else
+
+mapped_file::mapped_file(const std::string_view file_path)
+    : data{ nullptr }
+    , size{ 0 }
+    , descriptor{ -1 }
+{
+	const std::int32_t file   = open(std::string{ file_path }.c_str(), O_RDONLY | O_CLOEXEC);
+	struct stat        status = {};
+
+	if (-1 == file)
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+	}
+
+	if (-1 == fstat(file, &status))
+	{
+		close(file);
+		throw std::runtime_error{ std::format("Failed to get the size of \"{}\"!", file_path) };
+	}
+
+	size       = static_cast<std::size_t>(status.st_size);
+	descriptor = file;
+
+	if (0 == size)
+	{
+		return;
+	}
+
+	void* const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	if (MAP_FAILED == mapping)
+	{
+		close(file);
+		throw std::runtime_error{ std::format("Failed to map \"{}\"!", file_path) };
+	}
+
+	data = static_cast<const std::uint8_t*>(mapping);
+}
+
+mapped_file::~mapped_file() noexcept
+{
+	if (nullptr != data)
+	{
+		munmap(const_cast<std::uint8_t*>(data), size);
+	}
+
+	close(descriptor);
+}
+
+std::int32_t mapped_file::get_descriptor() const noexcept
+{
+	return descriptor;
+}
+
+#endif
+
+std::span<const std::uint8_t> mapped_file::get_bytes() const noexcept
+{
+	return { data, size };
+}
+
+std::span<const std::uint8_t> file_range::get_bytes() const
+{
+	const std::span<const std::uint8_t> bytes = file->get_bytes();
+
+	if (bytes.size() < offset || bytes.size() - offset < size)
+	{
+		throw std::logic_error{ std::format("Range {}+{} is outside of a {} bytes file!", offset, size, bytes.size()) };
+	}
+
+	return bytes.subspan(static_cast<std::size_t>(offset), size);
+}
+
+} // namespace icon_changer
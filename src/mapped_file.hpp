@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Read-only memory mapping of a whole file.
+/// \details The contents are paged in on demand, so only the parts that are
+/// actually read cost any I/O.
+///
+class mapped_file final
+{
+public:
+	///
+	/// \brief Constructor to map a file.
+	/// \param file_path: The path to the file.
+	///
+	explicit mapped_file(std::string_view file_path);
+
+	///
+	/// \brief Destructor to unmap the file.
+	///
+	~mapped_file() noexcept;
+
+	mapped_file(const mapped_file&) = delete;
+
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	///
+	/// \brief Gets the file contents.
+	/// \returns The mapped bytes, valid as long as the object lives.
+	///
+	[[nodiscard]] std::span<const std::uint8_t> get_bytes() const noexcept;
+
+#ifndef _WIN32
+	///
+	/// \brief Gets the descriptor of the mapped file.
+	/// \details It stays open as long as the object lives, so ranges of the file
+	/// can be copied in the kernel (see file_writer::copy()).
+	/// \returns The file descriptor.
+	///
+	[[nodiscard]] std::int32_t get_descriptor() const noexcept;
+#endif
+
+private:
+	const std::uint8_t* data;       ///< Start of the mapping, nullptr for empty files.
+	std::size_t         size;       ///< Size of the file in bytes.
+#ifndef _WIN32
+	std::int32_t        descriptor; ///< The open file descriptor.
+#endif
+};
+
+///
+/// \brief A range of a mapped file, used to refer to data without copying it.
+///
+struct file_range final
+{
+	std::shared_ptr<const mapped_file> file;   ///< The mapped file, kept alive by the range.
+	std::uint64_t                      offset; ///< Offset of the range in the file.
+	std::uint32_t                      size;   ///< Size of the range in bytes.
+
+	///
+	/// \brief Gets the bytes of the range.
+	/// \returns The mapped bytes.
+	///
+	[[nodiscard]] std::span<const std::uint8_t> get_bytes() const;
+};
+
+} // namespace icon_changer
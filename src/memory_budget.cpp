@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "memory_budget.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Default cap for a single file: 1 GiB.
+///
+static constexpr std::uint64_t DEFAULT_PER_FILE_LIMIT = std::uint64_t{ 1 } << 30;
+
+///
+/// \brief The caps, set once from the command line.
+///
+static std::atomic<std::uint64_t> per_file_limit    = DEFAULT_PER_FILE_LIMIT;
+static std::atomic<std::uint64_t> per_process_limit = 0;
+
+///
+/// \brief Bytes reserved by all the live reservations.
+///
+static std::atomic<std::uint64_t> reserved_bytes = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Adds bytes to the process total, unless that exceeds the cap.
+/// \param bytes: The number of bytes.
+/// \param what: What the memory is for, used in error messages.
+///
+static void acquire(std::uint64_t    bytes,
+                    std::string_view what);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+memory_reservation::memory_reservation() noexcept
+    : size{ 0 }
+{
+}
+
+memory_reservation::memory_reservation(const std::uint64_t    bytes,
+                                       const std::string_view what)
+    : size{ 0 }
+{
+	grow(bytes, what);
+}
+
+memory_reservation::memory_reservation(const memory_reservation& other)
+    : size{ 0 }
+{
+	grow(other.size, "a copy");
+}
+
+memory_reservation::memory_reservation(memory_reservation&& other) noexcept
+    : size{ other.size }
+{
+	other.size = 0;
+}
+
+memory_reservation::~memory_reservation() noexcept
+{
+	reserved_bytes -= size;
+}
+
+memory_reservation& memory_reservation::operator=(const memory_reservation& other)
+{
+	if (this != &other)
+	{
+		memory_reservation copy = other;
+
+		*this = std::move(copy);
+	}
+
+	return *this;
+}
+
+memory_reservation& memory_reservation::operator=(memory_reservation&& other) noexcept
+{
+	if (this != &other)
+	{
+		reserved_bytes -= size;
+		size            = other.size;
+		other.size      = 0;
+	}
+
+	return *this;
+}
+
+void memory_reservation::grow(const std::uint64_t    bytes,
+                              const std::string_view what)
+{
+	const std::uint64_t limit = per_file_limit;
+
+	if (0 != limit && (limit < bytes || limit - bytes < size))
+	{
+		throw std::invalid_argument{ std::format("{} needs {} bytes on top of {}, more than the {} bytes allowed per file!", what, bytes, size, limit) };
+	}
+
+	acquire(bytes, what);
+	size += bytes;
+}
+
+std::uint64_t memory_reservation::get_size() const noexcept
+{
+	return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+void set_memory_limits(const memory_limits& limits) noexcept
+{
+	per_file_limit    = limits.per_file;
+	per_process_limit = limits.per_process;
+}
+
+memory_limits get_memory_limits() noexcept
+{
+	return { per_file_limit, per_process_limit };
+}
+
+std::uint64_t checked_multiply(const std::uint64_t    left,
+                               const std::uint64_t    right,
+                               const std::string_view what)
+{
+	if (0 != left && std::numeric_limits<std::uint64_t>::max() / left < right)
+	{
+		throw std::invalid_argument{ std::format("{} of {} x {} bytes is too large!", what, left, right) };
+	}
+
+	return left * right;
+}
+
+static void acquire(const std::uint64_t    bytes,
+                    const std::string_view what)
+{
+	const std::uint64_t limit    = per_process_limit;
+	std::uint64_t       reserved = reserved_bytes;
+
+	// Reserve only if the total stays within the cap, even with other threads reserving.
+	do
+	{
+		if (0 != limit && (limit < bytes || limit - bytes < reserved))
+		{
+			throw std::runtime_error{ std::format("{} needs {} bytes, but only {} of the {} bytes allowed per process are left!", what, bytes, limit - std::min(limit, reserved),
+			                                      limit) };
+		}
+	}
+	while (!reserved_bytes.compare_exchange_weak(reserved, reserved + bytes));
+}
+
+} // namespace icon_changer
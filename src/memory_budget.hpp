@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Caps on the memory that untrusted files can make the tool allocate.
+///
+struct memory_limits final
+{
+	std::uint64_t per_file;    ///< Bytes a single file may need, 0 for no cap.
+	std::uint64_t per_process; ///< Bytes all the loaded files may need together, 0 for no cap.
+};
+
+///
+/// \brief Memory set aside for the buffers of one file, counted against the
+/// limits for the object's lifetime.
+/// \details Objects that hold buffers sized by a file's declared sizes keep a
+/// reservation next to them, so a parallel batch cannot allocate more than
+/// the process cap. Copying the reservation reserves the memory again, like
+/// copying the buffers does.
+///
+class memory_reservation final
+{
+public:
+	///
+	/// \brief Constructor to reserve nothing.
+	///
+	memory_reservation() noexcept;
+
+	///
+	/// \brief Constructor to reserve memory.
+	/// \param bytes: The number of bytes.
+	/// \param what: What the memory is for, used in error messages.
+	/// \throws std::invalid_argument if the bytes exceed the per-file cap.
+	/// \throws std::runtime_error if the bytes exceed what is left of the
+	/// per-process cap.
+	///
+	memory_reservation(std::uint64_t    bytes,
+	                   std::string_view what);
+
+	///
+	/// \brief Copy constructor to reserve the same amount again.
+	/// \param other: The reservation to be copied.
+	///
+	memory_reservation(const memory_reservation& other);
+
+	///
+	/// \brief Move constructor to take over a reservation.
+	/// \param other: The reservation to be moved, empty afterwards.
+	///
+	memory_reservation(memory_reservation&& other) noexcept;
+
+	///
+	/// \brief Destructor to release the memory.
+	///
+	~memory_reservation() noexcept;
+
+	memory_reservation& operator=(const memory_reservation& other);
+
+	memory_reservation& operator=(memory_reservation&& other) noexcept;
+
+	///
+	/// \brief Reserves more memory for the same file.
+	/// \param bytes: The number of additional bytes.
+	/// \param what: What the memory is for, used in error messages.
+	/// \throws std::invalid_argument if the total exceeds the per-file cap.
+	/// \throws std::runtime_error if the bytes exceed what is left of the
+	/// per-process cap.
+	///
+	void grow(std::uint64_t    bytes,
+	          std::string_view what);
+
+	///
+	/// \brief Gets the reserved memory.
+	/// \returns The number of bytes.
+	///
+	[[nodiscard]] std::uint64_t get_size() const noexcept;
+
+private:
+	std::uint64_t size; ///< The reserved bytes.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Sets the memory caps, for the whole process.
+/// \param limits: The caps.
+///
+extern void set_memory_limits(const memory_limits& limits) noexcept;
+
+///
+/// \brief Gets the memory caps.
+/// \returns The caps, 1 GiB per file and no process cap unless changed.
+///
+extern memory_limits get_memory_limits() noexcept;
+
+///
+/// \brief Multiplies sizes read from a file without overflowing.
+/// \param left: The first factor.
+/// \param right: The second factor.
+/// \param what: What is being sized, used in error messages.
+/// \returns The product.
+/// \throws std::invalid_argument if the product does not fit in 64 bits.
+///
+extern std::uint64_t checked_multiply(std::uint64_t    left,
+                                      std::uint64_t    right,
+                                      std::string_view what);
+
+} // namespace icon_changer
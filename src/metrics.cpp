@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The metrics of one thread.
+/// \details Only its thread writes it, on cache lines of its own, so updates
+/// never contend; readers sum all the shards.
+///
+struct alignas(64) metrics_shard final
+{
+	static constexpr std::size_t BUCKET_COUNT = 14; ///< Number of bounded histogram buckets.
+
+	std::array<std::atomic<std::uint64_t>, COUNTER_COUNT>                             counters; ///< The counters.
+	std::array<std::array<std::atomic<std::uint64_t>, BUCKET_COUNT + 1>, STAGE_COUNT> buckets;  ///< Observations per bucket (not cumulative), the last one unbounded.
+	std::array<std::atomic<std::uint64_t>, STAGE_COUNT>                               sums;     ///< Sum of the observations in nanoseconds.
+};
+
+///
+/// \brief Lends a shard to a thread for its lifetime.
+/// \details Shards are returned when their thread exits and lent again, values
+/// included, so short-lived worker threads do not pile shards up.
+///
+struct shard_lease final
+{
+	shard_lease();
+
+	~shard_lease() noexcept;
+
+	shard_lease(const shard_lease&) = delete;
+
+	shard_lease& operator=(const shard_lease&) = delete;
+
+	metrics_shard* shard; ///< The shard lent.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Upper bounds of the latency histogram buckets, from 0.5 ms to 10 s.
+///
+static constexpr std::array<std::chrono::nanoseconds, metrics_shard::BUCKET_COUNT> BUCKET_BOUNDS = {
+	std::chrono::microseconds{ 500 }, std::chrono::milliseconds{ 1 },    std::chrono::microseconds{ 2500 }, std::chrono::milliseconds{ 5 },
+	std::chrono::milliseconds{ 10 },  std::chrono::milliseconds{ 25 },   std::chrono::milliseconds{ 50 },   std::chrono::milliseconds{ 100 },
+	std::chrono::milliseconds{ 250 }, std::chrono::milliseconds{ 500 },  std::chrono::seconds{ 1 },         std::chrono::milliseconds{ 2500 },
+	std::chrono::seconds{ 5 },        std::chrono::seconds{ 10 },
+};
+
+///
+/// \brief Label values of the stages, indexed by stage.
+///
+static constexpr std::array<std::string_view, STAGE_COUNT> STAGE_NAMES = { "load", "stamp", "journal" };
+
+///
+/// \brief Every shard ever created, and the ones not lent.
+///
+static std::mutex                                  registry_mutex = {};
+static std::vector<std::unique_ptr<metrics_shard>> all_shards     = {};
+static std::vector<metrics_shard*>                 free_shards    = {};
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Gets the shard of the calling thread.
+/// \returns The shard.
+///
+static metrics_shard& get_local_shard();
+
+///
+/// \brief Appends a metric family header.
+/// \param text: The metrics being formatted.
+/// \param name: The metric name.
+/// \param type: The metric type.
+/// \param help: The description.
+///
+static void append_header(std::string&     text,
+                          std::string_view name,
+                          std::string_view type,
+                          std::string_view help);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+shard_lease::shard_lease()
+    : shard{ nullptr }
+{
+	const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ registry_mutex };
+
+	if (free_shards.empty())
+	{
+		all_shards.push_back(std::make_unique<metrics_shard>());
+		free_shards.push_back(all_shards.back().get());
+	}
+
+	shard = free_shards.back();
+	free_shards.pop_back();
+}
+
+shard_lease::~shard_lease() noexcept
+{
+	const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ registry_mutex };
+
+	free_shards.push_back(shard);
+}
+
+stage_timer::stage_timer(const stage timed) noexcept
+    : timed{ timed }
+    , start{ std::chrono::steady_clock::now() }
+{
+}
+
+stage_timer::~stage_timer() noexcept
+{
+	observe(timed, std::chrono::steady_clock::now() - start);
+}
+
+metrics_exporter::metrics_exporter(const std::string_view          file_path,
+                                   const std::chrono::milliseconds interval)
+    : path{ file_path }
+    , mutex{}
+    , stopping{}
+    , thread{}
+{
+	write();
+
+	thread = std::jthread{ [this, interval](const std::stop_token& stop)
+	{
+		std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>{ mutex };
+
+		while (!stopping.wait_for(lock, stop, interval, [&stop]()
+		{
+			return stop.stop_requested();
+		}))
+		{
+			try
+			{
+				write();
+			}
+			catch (const std::exception&)
+			{
+				// Tried again at the next interval.
+			}
+		}
+	} };
+}
+
+metrics_exporter::~metrics_exporter() noexcept
+{
+	thread.request_stop();
+	thread.join();
+
+	try
+	{
+		write();
+	}
+	catch (const std::exception&)
+	{
+		// Nothing left to report it to.
+	}
+}
+
+void metrics_exporter::write() const
+{
+	const std::string           text      = format_metrics();
+	const std::filesystem::path target    = std::filesystem::path{ path };
+	std::filesystem::path       temporary = target;
+
+	temporary += ".tmp";
+
+	{
+		std::ofstream file = std::ofstream{ temporary, std::ios::binary };
+
+		if (!file.write(text.data(), static_cast<std::streamsize>(text.size())))
+		{
+			throw std::runtime_error{ std::format("Failed to write \"{}\"!", temporary.string()) };
+		}
+	}
+
+	std::filesystem::rename(temporary, target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+void add(const counter incremented, const std::uint64_t value) noexcept
+{
+	get_local_shard().counters[static_cast<std::size_t>(incremented)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void observe(const stage timed, const std::chrono::nanoseconds latency) noexcept
+{
+	metrics_shard&    shard  = get_local_shard();
+	const std::size_t bucket = static_cast<std::size_t>(std::lower_bound(BUCKET_BOUNDS.begin(), BUCKET_BOUNDS.end(), latency) - BUCKET_BOUNDS.begin());
+
+	shard.buckets[static_cast<std::size_t>(timed)][bucket].fetch_add(1, std::memory_order_relaxed);
+	shard.sums[static_cast<std::size_t>(timed)].fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(0, latency.count())), std::memory_order_relaxed);
+}
+
+std::uint64_t get_total(const counter read) noexcept
+{
+	const std::lock_guard<std::mutex> lock  = std::lock_guard<std::mutex>{ registry_mutex };
+	std::uint64_t                     total = 0;
+
+	for (const std::unique_ptr<metrics_shard>& shard : all_shards)
+	{
+		total += shard->counters[static_cast<std::size_t>(read)].load(std::memory_order_relaxed);
+	}
+
+	return total;
+}
+
+std::string format_metrics()
+{
+	std::array<std::uint64_t, COUNTER_COUNT>                                            counters = {};
+	std::array<std::array<std::uint64_t, metrics_shard::BUCKET_COUNT + 1>, STAGE_COUNT> buckets  = {};
+	std::array<std::uint64_t, STAGE_COUNT>                                              sums     = {};
+	std::string                                                                         text     = {};
+
+	{
+		const std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>{ registry_mutex };
+
+		for (const std::unique_ptr<metrics_shard>& shard : all_shards)
+		{
+			for (std::size_t index = 0; index < COUNTER_COUNT; ++index)
+			{
+				counters[index] += shard->counters[index].load(std::memory_order_relaxed);
+			}
+
+			for (std::size_t index = 0; index < STAGE_COUNT; ++index)
+			{
+				for (std::size_t bucket = 0; bucket < buckets[index].size(); ++bucket)
+				{
+					buckets[index][bucket] += shard->buckets[index][bucket].load(std::memory_order_relaxed);
+				}
+
+				sums[index] += shard->sums[index].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	const auto get = [&counters](const counter read)
+	{
+		return counters[static_cast<std::size_t>(read)];
+	};
+
+	const std::uint64_t done = get(counter::jobs_changed) + get(counter::jobs_skipped) + get(counter::jobs_failed);
+
+	append_header(text, "icon_changer_batch_jobs_total", "counter", "Batch updates finished, by outcome.");
+	std::format_to(std::back_inserter(text), "icon_changer_batch_jobs_total{{outcome=\"changed\"}} {}\n", get(counter::jobs_changed));
+	std::format_to(std::back_inserter(text), "icon_changer_batch_jobs_total{{outcome=\"skipped\"}} {}\n", get(counter::jobs_skipped));
+	std::format_to(std::back_inserter(text), "icon_changer_batch_jobs_total{{outcome=\"failed\"}} {}\n", get(counter::jobs_failed));
+
+	append_header(text, "icon_changer_batch_queue_depth", "gauge", "Batch updates queued and not finished yet.");
+	std::format_to(std::back_inserter(text), "icon_changer_batch_queue_depth {}\n", get(counter::jobs_queued) - std::min(done, get(counter::jobs_queued)));
+
+	append_header(text, "icon_changer_read_bytes_total", "counter", "Bytes of icons and executables read into memory.");
+	std::format_to(std::back_inserter(text), "icon_changer_read_bytes_total {}\n", get(counter::bytes_read));
+
+	append_header(text, "icon_changer_written_bytes_total", "counter", "Bytes of executables written, kernel copies included.");
+	std::format_to(std::back_inserter(text), "icon_changer_written_bytes_total {}\n", get(counter::bytes_written));
+
+	append_header(text, "icon_changer_stamp_cache_requests_total", "counter", "Batch updates by whether their icon was already loaded.");
+	std::format_to(std::back_inserter(text), "icon_changer_stamp_cache_requests_total{{result=\"hit\"}} {}\n", get(counter::stamp_hits));
+	std::format_to(std::back_inserter(text), "icon_changer_stamp_cache_requests_total{{result=\"miss\"}} {}\n", get(counter::stamp_misses));
+
+	append_header(text, "icon_changer_resource_sections_total", "counter", "Resource sections written, by placement.");
+	std::format_to(std::back_inserter(text), "icon_changer_resource_sections_total{{placement=\"in_place\"}} {}\n", get(counter::sections_in_place));
+	std::format_to(std::back_inserter(text), "icon_changer_resource_sections_total{{placement=\"grown\"}} {}\n", get(counter::sections_grown));
+	std::format_to(std::back_inserter(text), "icon_changer_resource_sections_total{{placement=\"appended\"}} {}\n", get(counter::sections_appended));
+
+	append_header(text, "icon_changer_stage_duration_seconds", "histogram", "Latency of the stages of an update.");
+
+	for (std::size_t index = 0; index < STAGE_COUNT; ++index)
+	{
+		std::uint64_t cumulative = 0;
+
+		for (std::size_t bucket = 0; bucket < BUCKET_BOUNDS.size(); ++bucket)
+		{
+			cumulative += buckets[index][bucket];
+			std::format_to(std::back_inserter(text), "icon_changer_stage_duration_seconds_bucket{{stage=\"{}\",le=\"{}\"}} {}\n", STAGE_NAMES[index],
+			               std::chrono::duration<double>{ BUCKET_BOUNDS[bucket] }.count(), cumulative);
+		}
+
+		cumulative += buckets[index].back();
+		std::format_to(std::back_inserter(text), "icon_changer_stage_duration_seconds_bucket{{stage=\"{}\",le=\"+Inf\"}} {}\n", STAGE_NAMES[index], cumulative);
+		std::format_to(std::back_inserter(text), "icon_changer_stage_duration_seconds_sum{{stage=\"{}\"}} {}\n", STAGE_NAMES[index], static_cast<double>(sums[index]) / 1e9);
+		std::format_to(std::back_inserter(text), "icon_changer_stage_duration_seconds_count{{stage=\"{}\"}} {}\n", STAGE_NAMES[index], cumulative);
+	}
+
+	return text;
+}
+
+static metrics_shard& get_local_shard()
+{
+	thread_local const shard_lease lease = shard_lease{};
+
+	return *lease.shard;
+}
+
+static void append_header(std::string&           text,
+                          const std::string_view name,
+                          const std::string_view type,
+                          const std::string_view help)
+{
+	std::format_to(std::back_inserter(text), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+}
+
+} // namespace icon_changer
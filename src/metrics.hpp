@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Counters of the process, exported as Prometheus counters.
+///
+enum class counter
+{
+	jobs_queued,        ///< Batch updates queued.
+	jobs_changed,       ///< Batch updates done.
+	jobs_skipped,       ///< Batch updates skipped thanks to the journal.
+	jobs_failed,        ///< Batch updates that failed.
+	bytes_read,         ///< Bytes of icons and executables read into memory.
+	bytes_written,      ///< Bytes of executables written, spliced ranges included.
+	stamp_hits,         ///< Batch updates that reused the stamp of an earlier one.
+	stamp_misses,       ///< Batch updates that had to load their icon.
+	sections_in_place,  ///< Resource sections rewritten in place.
+	sections_grown,     ///< Last resource sections grown.
+	sections_appended,  ///< Resource sections appended after the others.
+};
+
+///
+/// \brief Number of counter values.
+///
+inline constexpr std::size_t COUNTER_COUNT = 11;
+
+///
+/// \brief Stages of an update whose latency is recorded, exported as
+/// Prometheus histograms.
+///
+enum class stage
+{
+	load,    ///< Loading an icon into a stamp.
+	stamp,   ///< Stamping one executable, writing included.
+	journal, ///< Checking one target against the journal.
+};
+
+///
+/// \brief Number of stage values.
+///
+inline constexpr std::size_t STAGE_COUNT = 3;
+
+///
+/// \brief Records the latency of a stage for the object's lifetime.
+///
+class stage_timer final
+{
+public:
+	///
+	/// \brief Constructor to start timing.
+	/// \param timed: The stage.
+	///
+	explicit stage_timer(stage timed) noexcept;
+
+	///
+	/// \brief Destructor to record the latency.
+	///
+	~stage_timer() noexcept;
+
+	stage_timer(const stage_timer&) = delete;
+
+	stage_timer& operator=(const stage_timer&) = delete;
+
+private:
+	stage                                 timed; ///< The stage.
+	std::chrono::steady_clock::time_point start; ///< When the stage started.
+};
+
+///
+/// \brief Writes the metrics to a file periodically, for the textfile
+/// collector of the Prometheus node exporter.
+/// \details The file is replaced atomically (written next to it and renamed),
+/// so the collector never reads half of it. Writing only sums the per-thread
+/// shards, it never blocks the threads doing the work.
+///
+class metrics_exporter final
+{
+public:
+	///
+	/// \brief Constructor to start the exporting thread.
+	/// \param file_path: The path to the `.prom` file.
+	/// \param interval: The time between two writes.
+	///
+	metrics_exporter(std::string_view          file_path,
+	                 std::chrono::milliseconds interval);
+
+	///
+	/// \brief Destructor to stop the thread and write the final values.
+	///
+	~metrics_exporter() noexcept;
+
+	metrics_exporter(const metrics_exporter&) = delete;
+
+	metrics_exporter& operator=(const metrics_exporter&) = delete;
+
+	///
+	/// \brief Writes the metrics now.
+	///
+	void write() const;
+
+private:
+	std::string                 path;     ///< The path to the file.
+	std::mutex                  mutex;    ///< Needed by the condition variable.
+	std::condition_variable_any stopping; ///< Wakes the thread up when stopped.
+	std::jthread                thread;   ///< The exporting thread, stopped first on destruction.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Adds to a counter.
+/// \details Only touches the calling thread's shard (a relaxed atomic add on
+/// a cache line no other thread writes), so it is safe on hot paths.
+/// \param incremented: The counter.
+/// \param value: The amount.
+///
+extern void add(counter incremented, std::uint64_t value = 1) noexcept;
+
+///
+/// \brief Records the latency of a stage, see stage_timer.
+/// \param timed: The stage.
+/// \param latency: The latency.
+///
+extern void observe(stage timed, std::chrono::nanoseconds latency) noexcept;
+
+///
+/// \brief Gets the total of a counter across threads.
+/// \param read: The counter.
+/// \returns The total.
+///
+extern std::uint64_t get_total(counter read) noexcept;
+
+///
+/// \brief Formats the metrics in the Prometheus text exposition format.
+/// \see https://prometheus.io/docs/instrumenting/exposition_formats/
+/// \returns The metrics.
+///
+extern std::string format_metrics();
+
+} // namespace icon_changer
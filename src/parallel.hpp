@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Calls a function for every index in [0, count) on all hardware threads.
+/// \details Workers pull the next index from a shared counter, so uneven work
+/// items (e.g. files of very different sizes) keep every thread busy. Returns
+/// once every call has finished. The function must not throw.
+/// \param count: The number of work items.
+/// \param function: Called with the index of each work item.
+///
+template<typename F>
+void parallel_for(const std::size_t count,
+                  F&&               function)
+{
+	const std::size_t         workers = std::min<std::size_t>(count, std::max(1U, std::thread::hardware_concurrency()));
+	std::atomic<std::size_t>  next    = 0;
+	std::vector<std::jthread> threads = {};
+
+	threads.reserve(workers);
+
+	for (std::size_t worker = 0; worker < workers; ++worker)
+	{
+		threads.emplace_back([&next, &function, count]()
+		{
+			for (std::size_t index = next.fetch_add(1, std::memory_order_relaxed); index < count; index = next.fetch_add(1, std::memory_order_relaxed))
+			{
+				function(index);
+			}
+		});
+	}
+}
+
+} // namespace icon_changer
@@ -0,0 +1,1193 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "pe_image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include "file_writer.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+///
+/// \brief This data structure corresponds to IMAGE_FILE_HEADER.
+///
+struct file_header
+{
+	std::uint16_t machine;                 ///< Target architecture.
+	std::uint16_t sections_count;          ///< Number of entries in the section table.
+	std::uint32_t time_date_stamp;         ///< Link time, carried over unchanged.
+	std::uint32_t symbol_table_offset;     ///< Deprecated COFF symbol table offset.
+	std::uint32_t symbols_count;           ///< Deprecated COFF symbol count.
+	std::uint16_t optional_header_size;    ///< Size of the optional header.
+	std::uint16_t characteristics;         ///< IMAGE_FILE_* flags.
+};
+
+///
+/// \brief This data structure corresponds to IMAGE_SECTION_HEADER.
+///
+struct section_header
+{
+	char          name[8];                 ///< Section name, not necessarily null terminated.
+	std::uint32_t virtual_size;            ///< Size of the section when loaded in memory.
+	std::uint32_t virtual_address;         ///< RVA of the section.
+	std::uint32_t raw_size;                ///< Size of the section data in the file.
+	std::uint32_t raw_offset;              ///< File offset of the section data.
+	std::uint32_t relocations_offset;      ///< Zero for executables.
+	std::uint32_t line_numbers_offset;     ///< Deprecated, zero.
+	std::uint16_t relocations_count;       ///< Zero for executables.
+	std::uint16_t line_numbers_count;      ///< Deprecated, zero.
+	std::uint32_t characteristics;         ///< IMAGE_SCN_* flags.
+};
+
+#pragma pack(pop)
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief "MZ" signature of the DOS header.
+///
+static constexpr std::uint16_t DOS_SIGNATURE = 0x5A4D;
+
+///
+/// \brief Offset of e_lfanew in the DOS header.
+///
+static constexpr std::size_t NT_HEADERS_POINTER_OFFSET = 0x3C;
+
+///
+/// \brief "PE\0\0" signature of the NT headers.
+///
+static constexpr std::uint32_t NT_SIGNATURE = 0x00004550;
+
+///
+/// \brief Optional header magic of 32-bit images.
+///
+static constexpr std::uint16_t PE32_MAGIC = 0x010B;
+
+///
+/// \brief Optional header magic of 64-bit images.
+///
+static constexpr std::uint16_t PE32_PLUS_MAGIC = 0x020B;
+
+///
+/// \brief Offsets of the optional header fields shared by PE32 and PE32+.
+///
+static constexpr std::size_t INITIALIZED_DATA_SIZE_OFFSET = 8;
+static constexpr std::size_t SECTION_ALIGNMENT_OFFSET     = 32;
+static constexpr std::size_t FILE_ALIGNMENT_OFFSET        = 36;
+static constexpr std::size_t IMAGE_SIZE_OFFSET            = 56;
+static constexpr std::size_t HEADERS_SIZE_OFFSET          = 60;
+static constexpr std::size_t CHECKSUM_OFFSET              = 64;
+
+///
+/// \brief Offset of NumberOfRvaAndSizes, which differs between PE32 and PE32+.
+///
+static constexpr std::size_t PE32_DIRECTORIES_COUNT_OFFSET      = 92;
+static constexpr std::size_t PE32_PLUS_DIRECTORIES_COUNT_OFFSET = 108;
+
+///
+/// \brief Index of the debug directory in the data directories.
+///
+static constexpr std::size_t DEBUG_DIRECTORY = 6;
+
+///
+/// \brief Size of IMAGE_DEBUG_DIRECTORY and offset of its PointerToRawData.
+///
+static constexpr std::size_t DEBUG_ENTRY_SIZE     = 28;
+static constexpr std::size_t DEBUG_POINTER_OFFSET = 24;
+
+///
+/// \brief Name given to appended resource sections.
+///
+static constexpr std::string_view RESOURCE_SECTION_NAME = ".rsrc";
+
+///
+/// \brief Values of the headers of create_resource_dll().
+///
+static constexpr std::uint16_t AMD64_MACHINE            = 0x8664;
+static constexpr std::uint16_t DLL_FILE_CHARACTERISTICS = 0x2022;      ///< EXECUTABLE_IMAGE | LARGE_ADDRESS_AWARE | DLL.
+static constexpr std::uint16_t DLL_LOAD_CHARACTERISTICS = 0x0500;      ///< NX_COMPAT | NO_SEH, there is no code to protect.
+static constexpr std::uint64_t DLL_IMAGE_BASE           = 0x180000000;
+static constexpr std::uint32_t DLL_SECTION_ALIGNMENT    = 0x1000;
+static constexpr std::uint32_t DLL_FILE_ALIGNMENT       = 0x200;
+static constexpr std::uint16_t DLL_OS_VERSION           = 6;           ///< Windows Vista, the first with PNG icons.
+static constexpr std::uint16_t GUI_SUBSYSTEM            = 2;
+static constexpr std::uint64_t DLL_RESERVE_SIZE         = 0x100000;    ///< Stack and heap reserve.
+static constexpr std::uint64_t DLL_COMMIT_SIZE          = 0x1000;      ///< Stack and heap commit.
+static constexpr std::uint32_t DATA_DIRECTORIES_COUNT   = 16;
+
+///
+/// \brief Offsets of the PE32+ optional header fields not shared with PE32.
+///
+static constexpr std::size_t PE32_PLUS_IMAGE_BASE_OFFSET    = 24;
+static constexpr std::size_t OS_VERSION_OFFSET              = 40;
+static constexpr std::size_t SUBSYSTEM_VERSION_OFFSET       = 48;
+static constexpr std::size_t SUBSYSTEM_OFFSET               = 68;
+static constexpr std::size_t DLL_CHARACTERISTICS_OFFSET     = 70;
+static constexpr std::size_t PE32_PLUS_STACK_RESERVE_OFFSET = 72;
+static constexpr std::size_t PE32_PLUS_STACK_COMMIT_OFFSET  = 80;
+static constexpr std::size_t PE32_PLUS_HEAP_RESERVE_OFFSET  = 88;
+static constexpr std::size_t PE32_PLUS_HEAP_COMMIT_OFFSET   = 96;
+
+///
+/// \brief Characteristics of a resource section: initialized, readable data.
+///
+static constexpr std::uint32_t RESOURCE_SECTION_CHARACTERISTICS = 0x40000040;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Rounds a value up to the next multiple of the alignment.
+/// \param value: The value to be aligned.
+/// \param alignment: The alignment, must not be 0.
+/// \returns The aligned value.
+///
+static constexpr std::uint64_t align_up(std::uint64_t value,
+                                        std::uint64_t alignment) noexcept;
+
+///
+/// \brief Reads a little endian value after checking it is in bounds.
+/// \param bytes: The file contents.
+/// \param offset: The file offset.
+/// \returns The value.
+///
+template<typename T>
+static T read_value(std::span<const std::uint8_t> bytes,
+                    std::size_t                   offset);
+
+///
+/// \brief Writes a little endian value into a buffer.
+/// \param bytes: The buffer, large enough.
+/// \param offset: The offset of the value.
+/// \param value: The value.
+///
+template<typename T>
+static void write_value(std::pmr::vector<std::uint8_t>& bytes,
+                        std::size_t                     offset,
+                        T                               value) noexcept;
+
+///
+/// \brief Adds up the 16-bit words of a file for its checksum.
+/// \param bytes: The file contents.
+/// \param checksum_offset: The offset of the checksum, which is left out.
+/// \returns The sum, folded to 16 bits.
+///
+static std::uint64_t sum_checksum_words(std::span<const std::uint8_t> bytes,
+                                        std::size_t                   checksum_offset) noexcept;
+
+///
+/// \brief Reads a whole file into memory.
+/// \param file_path: The path to the file.
+/// \param reservation: Receives the memory of the contents, reserved before
+/// they are read.
+/// \param resource: Where the contents are allocated.
+/// \returns The file contents.
+///
+static std::pmr::vector<std::uint8_t> read_file(std::string_view           file_path,
+                                                memory_reservation&        reservation,
+                                                std::pmr::memory_resource* resource);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+pe_image::pe_image(const std::string_view           file_path,
+                   std::pmr::memory_resource* const resource)
+    : reservation{}
+    , bytes{ read_file(file_path, reservation, resource) }
+    , sections{ resource }
+    , splices{ resource }
+    , file_header_offset{ 0 }
+    , optional_header_offset{ 0 }
+    , data_directories_offset{ 0 }
+    , data_directories_count{ 0 }
+    , section_table_offset{ 0 }
+    , section_alignment{ 0 }
+    , file_alignment{ 0 }
+{
+	parse_headers();
+}
+
+pe_image::pe_image(std::pmr::vector<std::uint8_t> bytes)
+    : reservation{ bytes.size(), "The executable" }
+    , bytes{ std::move(bytes) }
+    , sections{ this->bytes.get_allocator() }
+    , splices{ this->bytes.get_allocator() }
+    , file_header_offset{ 0 }
+    , optional_header_offset{ 0 }
+    , data_directories_offset{ 0 }
+    , data_directories_count{ 0 }
+    , section_table_offset{ 0 }
+    , section_alignment{ 0 }
+    , file_alignment{ 0 }
+{
+	parse_headers();
+}
+
+pe_image pe_image::create_resource_dll()
+{
+	static constexpr std::size_t NT_HEADERS_OFFSET      = 0x40;
+	static constexpr std::size_t OPTIONAL_HEADER_OFFSET = NT_HEADERS_OFFSET + sizeof(std::uint32_t) + sizeof(file_header);
+	static constexpr std::size_t OPTIONAL_HEADER_SIZE   = PE32_PLUS_DIRECTORIES_COUNT_OFFSET + sizeof(std::uint32_t) + DATA_DIRECTORIES_COUNT * sizeof(data_directory);
+
+	std::pmr::vector<std::uint8_t> bytes  = std::pmr::vector<std::uint8_t>(DLL_FILE_ALIGNMENT, 0x00);
+	file_header                    header = {};
+
+	header.machine              = AMD64_MACHINE;
+	header.optional_header_size = static_cast<std::uint16_t>(OPTIONAL_HEADER_SIZE);
+	header.characteristics      = DLL_FILE_CHARACTERISTICS;
+
+	write_value<std::uint16_t>(bytes, 0, DOS_SIGNATURE);
+	write_value<std::uint32_t>(bytes, NT_HEADERS_POINTER_OFFSET, NT_HEADERS_OFFSET);
+	write_value<std::uint32_t>(bytes, NT_HEADERS_OFFSET, NT_SIGNATURE);
+	write_value(bytes, NT_HEADERS_OFFSET + sizeof(std::uint32_t), header);
+
+	write_value<std::uint16_t>(bytes, OPTIONAL_HEADER_OFFSET, PE32_PLUS_MAGIC);
+	write_value<std::uint64_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_IMAGE_BASE_OFFSET, DLL_IMAGE_BASE);
+	write_value<std::uint32_t>(bytes, OPTIONAL_HEADER_OFFSET + SECTION_ALIGNMENT_OFFSET, DLL_SECTION_ALIGNMENT);
+	write_value<std::uint32_t>(bytes, OPTIONAL_HEADER_OFFSET + FILE_ALIGNMENT_OFFSET, DLL_FILE_ALIGNMENT);
+	write_value<std::uint16_t>(bytes, OPTIONAL_HEADER_OFFSET + OS_VERSION_OFFSET, DLL_OS_VERSION);
+	write_value<std::uint16_t>(bytes, OPTIONAL_HEADER_OFFSET + SUBSYSTEM_VERSION_OFFSET, DLL_OS_VERSION);
+	write_value<std::uint32_t>(bytes, OPTIONAL_HEADER_OFFSET + IMAGE_SIZE_OFFSET, DLL_SECTION_ALIGNMENT);
+	write_value<std::uint32_t>(bytes, OPTIONAL_HEADER_OFFSET + HEADERS_SIZE_OFFSET, DLL_FILE_ALIGNMENT);
+	write_value<std::uint16_t>(bytes, OPTIONAL_HEADER_OFFSET + SUBSYSTEM_OFFSET, GUI_SUBSYSTEM);
+	write_value<std::uint16_t>(bytes, OPTIONAL_HEADER_OFFSET + DLL_CHARACTERISTICS_OFFSET, DLL_LOAD_CHARACTERISTICS);
+	write_value<std::uint64_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_STACK_RESERVE_OFFSET, DLL_RESERVE_SIZE);
+	write_value<std::uint64_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_STACK_COMMIT_OFFSET, DLL_COMMIT_SIZE);
+	write_value<std::uint64_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_HEAP_RESERVE_OFFSET, DLL_RESERVE_SIZE);
+	write_value<std::uint64_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_HEAP_COMMIT_OFFSET, DLL_COMMIT_SIZE);
+	write_value<std::uint32_t>(bytes, OPTIONAL_HEADER_OFFSET + PE32_PLUS_DIRECTORIES_COUNT_OFFSET, DATA_DIRECTORIES_COUNT);
+
+	return pe_image{ std::move(bytes) };
+}
+
+pe_image::resource_view pe_image::find_resources(const std::span<const std::uint8_t> file)
+{
+	if (read_value<std::uint16_t>(file, 0) != DOS_SIGNATURE)
+	{
+		throw std::invalid_argument{ "Executable does not have a DOS header!" };
+	}
+
+	const std::size_t file_header_offset = read_value<std::uint32_t>(file, NT_HEADERS_POINTER_OFFSET) + sizeof(std::uint32_t);
+
+	if (NT_SIGNATURE != read_value<std::uint32_t>(file, file_header_offset - sizeof(std::uint32_t)))
+	{
+		throw std::invalid_argument{ "Executable does not have a PE header!" };
+	}
+
+	const file_header   header                 = read_value<file_header>(file, file_header_offset);
+	const std::size_t   optional_header_offset = file_header_offset + sizeof(file_header);
+	const std::uint16_t magic                  = read_value<std::uint16_t>(file, optional_header_offset);
+
+	if (PE32_MAGIC != magic && PE32_PLUS_MAGIC != magic)
+	{
+		throw std::invalid_argument{ std::format("Optional header magic 0x{:X} is invalid!", magic) };
+	}
+
+	const std::size_t directories_count_offset = PE32_MAGIC == magic ? PE32_DIRECTORIES_COUNT_OFFSET : PE32_PLUS_DIRECTORIES_COUNT_OFFSET;
+	const std::size_t directory_offset         = optional_header_offset + directories_count_offset + sizeof(std::uint32_t) + RESOURCE_DIRECTORY * sizeof(data_directory);
+
+	if (read_value<std::uint32_t>(file, optional_header_offset + directories_count_offset) <= RESOURCE_DIRECTORY ||
+	    header.optional_header_size < directory_offset + sizeof(data_directory) - optional_header_offset)
+	{
+		return { {}, 0 };
+	}
+
+	const std::uint32_t rva = read_value<std::uint32_t>(file, directory_offset);
+
+	if (0 == rva)
+	{
+		return { {}, 0 };
+	}
+
+	for (std::size_t index = 0; index < header.sections_count; ++index)
+	{
+		const section_header raw  = read_value<section_header>(file, optional_header_offset + header.optional_header_size + index * sizeof(section_header));
+		const std::uint32_t  size = std::max(raw.virtual_size, raw.raw_size);
+
+		if (raw.virtual_address > rva || rva - raw.virtual_address >= size)
+		{
+			continue;
+		}
+
+		const std::size_t offset = raw.raw_offset + static_cast<std::size_t>(rva - raw.virtual_address);
+		const std::size_t end    = std::min<std::size_t>(static_cast<std::size_t>(raw.raw_offset) + raw.raw_size, file.size());
+
+		if (end <= offset)
+		{
+			throw std::runtime_error{ "Resource directory is outside the file!" };
+		}
+
+		return { file.subspan(offset, end - offset), rva };
+	}
+
+	throw std::runtime_error{ std::format("Resource directory RVA 0x{:X} is not inside any section!", rva) };
+}
+
+pe_image::resource_view pe_image::verify(const std::span<const std::uint8_t> file)
+{
+	const resource_view resources              = find_resources(file);
+	const std::size_t   file_header_offset     = read_value<std::uint32_t>(file, NT_HEADERS_POINTER_OFFSET) + sizeof(std::uint32_t);
+	const file_header   header                 = read_value<file_header>(file, file_header_offset);
+	const std::size_t   optional_header_offset = file_header_offset + sizeof(file_header);
+	const std::uint32_t section_alignment      = read_value<std::uint32_t>(file, optional_header_offset + SECTION_ALIGNMENT_OFFSET);
+	const std::uint32_t file_alignment         = read_value<std::uint32_t>(file, optional_header_offset + FILE_ALIGNMENT_OFFSET);
+	const std::uint32_t checksum               = read_value<std::uint32_t>(file, optional_header_offset + CHECKSUM_OFFSET);
+
+	if (0 == file_alignment || 0 != (file_alignment & (file_alignment - 1)) || section_alignment < file_alignment)
+	{
+		throw std::invalid_argument{ std::format("Alignments 0x{:X}/0x{:X} are invalid!", section_alignment, file_alignment) };
+	}
+
+	for (std::size_t index = 0; index < header.sections_count; ++index)
+	{
+		const section_header raw = read_value<section_header>(file, optional_header_offset + header.optional_header_size + index * sizeof(section_header));
+
+		if (file.size() < static_cast<std::uint64_t>(raw.raw_offset) + raw.raw_size)
+		{
+			throw std::invalid_argument{ std::format("Section {} data is outside the file!", index) };
+		}
+	}
+
+	if (0 != checksum)
+	{
+		std::uint64_t sum = sum_checksum_words(file, optional_header_offset + CHECKSUM_OFFSET);
+
+		while (0 != (sum >> 16))
+		{
+			sum = (sum & 0xFFFF) + (sum >> 16);
+		}
+
+		const std::uint32_t computed = static_cast<std::uint32_t>(sum + file.size());
+
+		if (checksum != computed)
+		{
+			throw std::runtime_error{ std::format("Checksum 0x{:08X} does not match the contents (0x{:08X})!", checksum, computed) };
+		}
+	}
+
+	return resources;
+}
+
+resource_tree pe_image::get_resources() const
+{
+	if (!splices.empty())
+	{
+		std::pmr::vector<std::uint8_t> materialized = std::pmr::vector<std::uint8_t>{ bytes, bytes.get_allocator() };
+
+		for (const resource_tree::splice& splice : splices)
+		{
+			std::ranges::copy(splice.range.get_bytes(), materialized.begin() + splice.offset);
+		}
+
+		return pe_image{ std::move(materialized) }.get_resources();
+	}
+
+	const resource_view resources = find_resources(bytes);
+
+	if (resources.directory.empty())
+	{
+		return {};
+	}
+
+	return resource_tree::parse(resources.directory, resources.rva, bytes.get_allocator().resource());
+}
+
+pe_image::placement pe_image::set_resources(const resource_tree& resources)
+{
+	const data_directory directory = get_data_directory(RESOURCE_DIRECTORY);
+	const std::uint32_t  size      = resources.get_serialized_size();
+	std::size_t          index     = 0 == directory.rva ? sections.size() : find_section(directory.rva);
+	placement            result    = placement::in_place;
+
+	if (sections.size() != index && sections[index].virtual_address != directory.rva)
+	{
+		// The resources share a section with something else, leave it alone.
+		index = sections.size();
+	}
+
+	if (sections.size() != index && size <= sections[index].raw_size &&
+	    (sections.size() - 1 == index || size <= sections[index + 1].virtual_address - sections[index].virtual_address))
+	{
+		LOG("Rewriting resource section in place ({} of {} bytes).", size, sections[index].raw_size);
+		add(counter::sections_in_place);
+	}
+	else if (sections.size() != index && sections.size() - 1 == index && get_sections_end() == sections[index].raw_offset + sections[index].raw_size)
+	{
+		const std::uint32_t raw_size = static_cast<std::uint32_t>(align_up(size, file_alignment));
+
+		LOG("Growing the last resource section from {} to {} bytes.", sections[index].raw_size, raw_size);
+		add(counter::sections_grown);
+
+		insert_bytes(sections[index].raw_offset + sections[index].raw_size, raw_size - sections[index].raw_size);
+		write<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET,
+		                     read<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET) + raw_size - sections[index].raw_size);
+		sections[index].raw_size = raw_size;
+		result                   = placement::grown;
+	}
+	else
+	{
+		LOG("Appending a new resource section of {} bytes.", size);
+		add(counter::sections_appended);
+
+		index  = append_section(RESOURCE_SECTION_NAME, static_cast<std::uint32_t>(align_up(size, file_alignment)), RESOURCE_SECTION_CHARACTERISTICS);
+		result = placement::appended;
+	}
+
+	section&                                section = sections[index];
+	std::pmr::vector<resource_tree::splice> spliced = std::pmr::vector<resource_tree::splice>{ bytes.get_allocator() };
+
+	// The whole section is cleared, so the bytes after the tree are zero.
+	resources.serialize(std::span<std::uint8_t>{ bytes }.subspan(section.raw_offset, section.raw_size), section.virtual_address, &spliced);
+
+	// Splices of the resources being replaced are dropped, those of an
+	// abandoned section stay so the file keeps its bytes.
+	std::erase_if(splices, [&section](const resource_tree::splice& splice)
+	              { return section.raw_offset <= splice.offset && splice.offset - section.raw_offset < section.raw_size; });
+
+	for (resource_tree::splice& splice : spliced)
+	{
+		splice.offset += section.raw_offset;
+		splices.push_back(std::move(splice));
+	}
+
+	std::ranges::sort(splices, {}, &resource_tree::splice::offset);
+
+	section.virtual_size = size;
+	write_section(index);
+	set_data_directory(RESOURCE_DIRECTORY, { section.virtual_address, size });
+	update_image_size();
+	pad_for_signing();
+	update_checksum();
+
+	return result;
+}
+
+std::size_t pe_image::compact_resources()
+{
+	const data_directory directory = get_data_directory(RESOURCE_DIRECTORY);
+	const std::size_t    index     = 0 == directory.rva ? sections.size() : find_section(directory.rva);
+	std::size_t          released  = 0;
+
+	if (sections.size() == index)
+	{
+		return 0;
+	}
+
+	if (sections[index].virtual_address != directory.rva)
+	{
+		throw std::runtime_error{ "Resources share their section with other data, they cannot be compacted!" };
+	}
+
+	const resource_tree resources = get_resources();
+	const bool          relocate  = sections.size() - 1 != index || get_sections_end() != sections[index].raw_offset + sections[index].raw_size;
+
+	for (std::size_t other = 0; other < sections.size(); ++other)
+	{
+		if ((index == other && relocate) ||
+		    (index != other && RESOURCE_SECTION_NAME == sections[other].name && 0 != sections[other].raw_size && !is_referenced(other)))
+		{
+			release_section(other);
+			++released;
+		}
+	}
+
+	// A released resource section has no room left, so the tree is appended.
+	set_resources(resources);
+
+	if (!relocate)
+	{
+		section&            section  = sections[index];
+		const std::uint32_t raw_size = static_cast<std::uint32_t>(align_up(section.virtual_size, file_alignment));
+
+		if (raw_size < section.raw_size)
+		{
+			LOG("Shrinking the resource section from {} to {} bytes.", section.raw_size, raw_size);
+
+			remove_bytes(section.raw_offset + raw_size, section.raw_size - raw_size);
+			shrink_initialized_data(section.raw_size - raw_size);
+			section.raw_size = raw_size;
+			write_section(index);
+			pad_for_signing();
+			update_checksum();
+		}
+	}
+
+	return released;
+}
+
+void pe_image::save(const std::string_view                       file_path,
+                    sha256* const                                contents,
+                    const std::function<void(std::string_view)>& check) const
+{
+	write_file(file_path, nullptr, contents, check);
+}
+
+sha256::digest pe_image::save_with_digest(const std::string_view                       file_path,
+                                          sha256* const                                contents,
+                                          const std::function<void(std::string_view)>& check) const
+{
+	sha256 hash = {};
+
+	write_file(file_path, &hash, contents, check);
+	return hash.finalize();
+}
+
+sha256::digest pe_image::compute_digest() const
+{
+	sha256 hash = {};
+
+	write_chunks(nullptr, &hash, nullptr);
+	return hash.finalize();
+}
+
+bool pe_image::has_certificates() const
+{
+	return 0 != get_data_directory(SECURITY_DIRECTORY).size;
+}
+
+void pe_image::strip_certificates()
+{
+	const data_directory certificates = get_data_directory(SECURITY_DIRECTORY);
+
+	if (!has_certificates())
+	{
+		return;
+	}
+
+	if (bytes.size() != static_cast<std::uint64_t>(certificates.rva) + certificates.size || get_sections_end() > certificates.rva)
+	{
+		throw std::runtime_error{ "Certificate table is not at the end of the file!" };
+	}
+
+	LOG("Stripping {} bytes of certificates.", certificates.size);
+
+	bytes.resize(certificates.rva);
+	set_data_directory(SECURITY_DIRECTORY, { 0, 0 });
+	pad_for_signing();
+	update_checksum();
+}
+
+const std::pmr::vector<std::uint8_t>& pe_image::get_bytes() const noexcept
+{
+	return bytes;
+}
+
+const std::pmr::vector<pe_image::section>& pe_image::get_sections() const noexcept
+{
+	return sections;
+}
+
+pe_image::data_directory pe_image::get_data_directory(const std::size_t index) const
+{
+	if (data_directories_count <= index)
+	{
+		return { 0, 0 };
+	}
+
+	return { read<std::uint32_t>(data_directories_offset + index * sizeof(data_directory)),
+		     read<std::uint32_t>(data_directories_offset + index * sizeof(data_directory) + sizeof(std::uint32_t)) };
+}
+
+std::uint32_t pe_image::compute_checksum() const
+{
+	std::uint64_t sum = sum_checksum_words(bytes, optional_header_offset + CHECKSUM_OFFSET);
+
+	// The holes left for spliced resources are zero, so their words are
+	// simply added on top.
+	for (const resource_tree::splice& splice : splices)
+	{
+		const std::span<const std::uint8_t> spliced = splice.range.get_bytes();
+
+		for (std::size_t index = 0; index < spliced.size(); ++index)
+		{
+			sum += static_cast<std::uint64_t>(spliced[index]) << ((splice.offset + index) % 2 * 8);
+		}
+	}
+
+	while (0 != (sum >> 16))
+	{
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+
+	return static_cast<std::uint32_t>(sum + bytes.size());
+}
+
+void pe_image::parse_headers()
+{
+	if (bytes.size() < NT_HEADERS_POINTER_OFFSET + sizeof(std::uint32_t) || DOS_SIGNATURE != read<std::uint16_t>(0))
+	{
+		throw std::invalid_argument{ "Executable does not have a DOS header!" };
+	}
+
+	const std::size_t nt_headers_offset = read<std::uint32_t>(NT_HEADERS_POINTER_OFFSET);
+
+	if (bytes.size() < nt_headers_offset + sizeof(std::uint32_t) + sizeof(file_header) || NT_SIGNATURE != read<std::uint32_t>(nt_headers_offset))
+	{
+		throw std::invalid_argument{ "Executable does not have a PE header!" };
+	}
+
+	file_header_offset     = nt_headers_offset + sizeof(std::uint32_t);
+	optional_header_offset = file_header_offset + sizeof(file_header);
+
+	const file_header  header = read<file_header>(file_header_offset);
+	const std::uint16_t magic = read<std::uint16_t>(optional_header_offset);
+
+	if (PE32_MAGIC != magic && PE32_PLUS_MAGIC != magic)
+	{
+		throw std::invalid_argument{ std::format("Optional header magic 0x{:X} is invalid!", magic) };
+	}
+
+	const std::size_t directories_count_offset = PE32_MAGIC == magic ? PE32_DIRECTORIES_COUNT_OFFSET : PE32_PLUS_DIRECTORIES_COUNT_OFFSET;
+
+	if (header.optional_header_size < directories_count_offset + sizeof(std::uint32_t))
+	{
+		throw std::invalid_argument{ std::format("Optional header size {} is too small!", header.optional_header_size) };
+	}
+
+	data_directories_offset = optional_header_offset + directories_count_offset + sizeof(std::uint32_t);
+	data_directories_count  = std::min<std::size_t>(read<std::uint32_t>(optional_header_offset + directories_count_offset),
+	                                                (header.optional_header_size - directories_count_offset - sizeof(std::uint32_t)) / sizeof(data_directory));
+	section_table_offset    = optional_header_offset + header.optional_header_size;
+	section_alignment       = read<std::uint32_t>(optional_header_offset + SECTION_ALIGNMENT_OFFSET);
+	file_alignment          = read<std::uint32_t>(optional_header_offset + FILE_ALIGNMENT_OFFSET);
+
+	if (0 == file_alignment || 0 != (file_alignment & (file_alignment - 1)) || section_alignment < file_alignment)
+	{
+		throw std::invalid_argument{ std::format("Alignments 0x{:X}/0x{:X} are invalid!", section_alignment, file_alignment) };
+	}
+
+	for (std::size_t index = 0; index < header.sections_count; ++index)
+	{
+		const section_header raw = read<section_header>(section_table_offset + index * sizeof(section_header));
+
+		if (bytes.size() < static_cast<std::uint64_t>(raw.raw_offset) + raw.raw_size)
+		{
+			throw std::invalid_argument{ std::format("Section {} data is outside the file!", index) };
+		}
+
+		sections.push_back({ std::string{ raw.name, strnlen(raw.name, sizeof(raw.name)) }, raw.virtual_size, raw.virtual_address, raw.raw_size, raw.raw_offset,
+		                     raw.characteristics });
+	}
+}
+
+void pe_image::write_chunks(file_writer* const file,
+                            sha256* const      hash,
+                            sha256* const      contents) const
+{
+	static constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+	const data_directory certificates = get_data_directory(SECURITY_DIRECTORY);
+	const std::size_t    checksum     = optional_header_offset + CHECKSUM_OFFSET;
+	const std::size_t    security     = data_directories_offset + SECURITY_DIRECTORY * sizeof(data_directory);
+
+	// Regions written but not hashed, in file order.
+	std::vector<std::pair<std::size_t, std::size_t>>        excluded = { { checksum, checksum + sizeof(std::uint32_t) } };
+	std::pmr::vector<resource_tree::splice>::const_iterator splice   = splices.begin();
+	std::size_t                                             offset   = 0;
+
+	if (SECURITY_DIRECTORY < data_directories_count)
+	{
+		excluded.push_back({ security, security + sizeof(data_directory) });
+	}
+
+	if (has_certificates())
+	{
+		excluded.push_back({ certificates.rva, std::min<std::size_t>(bytes.size(), static_cast<std::size_t>(certificates.rva) + certificates.size) });
+	}
+
+	excluded.push_back({ bytes.size(), bytes.size() });
+
+	for (const auto& [begin, end] : excluded)
+	{
+		while (offset < begin)
+		{
+			if (splices.end() != splice && splice->offset == offset)
+			{
+				if (nullptr != file)
+				{
+					file->copy(*splice->range.file, splice->range.offset, splice->range.size);
+				}
+
+				if (nullptr != hash)
+				{
+					hash->update(splice->range.get_bytes());
+				}
+
+				if (nullptr != contents)
+				{
+					contents->update(splice->range.get_bytes());
+				}
+
+				offset += splice->range.size;
+				++splice;
+				continue;
+			}
+
+			const std::size_t                   limit = splices.end() == splice ? begin : std::min<std::size_t>(begin, splice->offset);
+			const std::span<const std::uint8_t> chunk = { bytes.data() + offset, std::min(CHUNK_SIZE, limit - offset) };
+
+			if (nullptr != file)
+			{
+				file->write(chunk);
+			}
+
+			if (nullptr != hash)
+			{
+				hash->update(chunk);
+			}
+
+			if (nullptr != contents)
+			{
+				contents->update(chunk);
+			}
+
+			offset += chunk.size();
+		}
+
+		if (nullptr != file && offset < end)
+		{
+			file->write({ bytes.data() + offset, end - offset });
+		}
+
+		if (nullptr != contents && offset < end)
+		{
+			contents->update({ bytes.data() + offset, end - offset });
+		}
+
+		offset = std::max(offset, end);
+	}
+
+	// Only images that were never updated can still be unaligned, see
+	// pad_for_signing(). The padding is hashed like signing tools would add
+	// it, but not written, so the file does not depend on the digest.
+	if (nullptr != hash && !has_certificates() && 0 != bytes.size() % 8)
+	{
+		const std::array<std::uint8_t, 8> padding = {};
+
+		hash->update({ padding.data(), 8 - bytes.size() % 8 });
+	}
+}
+
+void pe_image::write_file(const std::string_view                       file_path,
+                          sha256* const                                hash,
+                          sha256* const                                contents,
+                          const std::function<void(std::string_view)>& check) const
+{
+	const std::filesystem::path path      = std::filesystem::path{ file_path };
+	std::filesystem::path       temporary = path;
+
+	temporary += ".tmp";
+
+	try
+	{
+		{
+			file_writer file = file_writer{ temporary.string() };
+
+			write_chunks(&file, hash, contents);
+		}
+
+		// A file failing the check never replaces the target.
+		if (check)
+		{
+			check(temporary.string());
+		}
+	}
+	catch (...)
+	{
+		std::error_code error = {};
+
+		std::filesystem::remove(temporary, error);
+		throw;
+	}
+
+	if (std::filesystem::exists(path))
+	{
+		std::filesystem::permissions(temporary, std::filesystem::status(path).permissions());
+	}
+
+	std::filesystem::rename(temporary, path);
+}
+
+void pe_image::pad_for_signing()
+{
+	if (!has_certificates() && 0 != bytes.size() % 8)
+	{
+		bytes.resize(align_up(bytes.size(), 8), 0x00);
+	}
+}
+
+void pe_image::update_checksum()
+{
+	if (0 != read<std::uint32_t>(optional_header_offset + CHECKSUM_OFFSET))
+	{
+		write<std::uint32_t>(optional_header_offset + CHECKSUM_OFFSET, compute_checksum());
+	}
+}
+
+template<typename T>
+T pe_image::read(const std::size_t offset) const
+{
+	return read_value<T>(bytes, offset);
+}
+
+template<typename T>
+void pe_image::write(const std::size_t offset,
+                     const T           value)
+{
+	if (bytes.size() < offset || bytes.size() - offset < sizeof(T))
+	{
+		throw std::logic_error{ std::format("Write at offset 0x{:X} is outside the executable!", offset) };
+	}
+
+	std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+void pe_image::set_data_directory(const std::size_t    index,
+                                  const data_directory directory)
+{
+	if (data_directories_count <= index)
+	{
+		throw std::runtime_error{ std::format("Executable has no data directory {}!", index) };
+	}
+
+	write<std::uint32_t>(data_directories_offset + index * sizeof(data_directory), directory.rva);
+	write<std::uint32_t>(data_directories_offset + index * sizeof(data_directory) + sizeof(std::uint32_t), directory.size);
+}
+
+void pe_image::write_section(const std::size_t index)
+{
+	const section& section = sections[index];
+	section_header raw     = read<section_header>(section_table_offset + index * sizeof(section_header));
+
+	std::memset(raw.name, 0, sizeof(raw.name));
+	std::memcpy(raw.name, section.name.data(), std::min(section.name.size(), sizeof(raw.name)));
+	raw.virtual_size    = section.virtual_size;
+	raw.virtual_address = section.virtual_address;
+	raw.raw_size        = section.raw_size;
+	raw.raw_offset      = section.raw_offset;
+	raw.characteristics = section.characteristics;
+
+	write(section_table_offset + index * sizeof(section_header), raw);
+}
+
+std::size_t pe_image::find_section(const std::uint32_t rva) const noexcept
+{
+	for (std::size_t index = 0; index < sections.size(); ++index)
+	{
+		const std::uint32_t size = std::max(sections[index].virtual_size, sections[index].raw_size);
+
+		if (sections[index].virtual_address <= rva && rva - sections[index].virtual_address < size)
+		{
+			return index;
+		}
+	}
+
+	return sections.size();
+}
+
+std::size_t pe_image::get_sections_end() const noexcept
+{
+	std::size_t end = 0;
+
+	for (const section& section : sections)
+	{
+		end = std::max<std::size_t>(end, section.raw_offset + section.raw_size);
+	}
+
+	return end;
+}
+
+void pe_image::insert_bytes(const std::size_t offset,
+                            const std::size_t count)
+{
+	const data_directory certificates = get_data_directory(SECURITY_DIRECTORY);
+
+	bytes.insert(bytes.begin() + offset, count, 0x00);
+
+	for (resource_tree::splice& splice : splices)
+	{
+		if (offset <= splice.offset)
+		{
+			splice.offset += static_cast<std::uint32_t>(count);
+		}
+	}
+
+	for (std::size_t index = 0; index < sections.size(); ++index)
+	{
+		if (offset <= sections[index].raw_offset && 0 != sections[index].raw_size)
+		{
+			sections[index].raw_offset += static_cast<std::uint32_t>(count);
+			write_section(index);
+		}
+	}
+
+	if (0 != certificates.rva && offset <= certificates.rva)
+	{
+		set_data_directory(SECURITY_DIRECTORY, { static_cast<std::uint32_t>(certificates.rva + count), certificates.size });
+	}
+}
+
+void pe_image::remove_bytes(const std::size_t offset,
+                            const std::size_t count)
+{
+	const data_directory certificates  = get_data_directory(SECURITY_DIRECTORY);
+	const data_directory debug         = get_data_directory(DEBUG_DIRECTORY);
+	const std::size_t    debug_section = 0 == debug.rva ? sections.size() : find_section(debug.rva);
+	const std::size_t    symbols       = file_header_offset + offsetof(file_header, symbol_table_offset);
+	const std::size_t    end           = offset + count;
+
+	// The debug entries and the symbol table are fixed before the bytes move.
+	if (sections.size() != debug_section && 0 != sections[debug_section].raw_size)
+	{
+		const std::size_t table = sections[debug_section].raw_offset + static_cast<std::size_t>(debug.rva - sections[debug_section].virtual_address);
+
+		for (std::size_t entry = 0; entry < debug.size / DEBUG_ENTRY_SIZE; ++entry)
+		{
+			const std::size_t   pointer = table + entry * DEBUG_ENTRY_SIZE + DEBUG_POINTER_OFFSET;
+			const std::uint32_t value   = read<std::uint32_t>(pointer);
+
+			if (end <= value)
+			{
+				write<std::uint32_t>(pointer, static_cast<std::uint32_t>(value - count));
+			}
+		}
+	}
+
+	if (end <= read<std::uint32_t>(symbols))
+	{
+		write<std::uint32_t>(symbols, static_cast<std::uint32_t>(read<std::uint32_t>(symbols) - count));
+	}
+
+	bytes.erase(bytes.begin() + offset, bytes.begin() + end);
+
+	for (std::size_t index = 0; index < sections.size(); ++index)
+	{
+		if (end <= sections[index].raw_offset && 0 != sections[index].raw_size)
+		{
+			sections[index].raw_offset -= static_cast<std::uint32_t>(count);
+			write_section(index);
+		}
+	}
+
+	if (0 != certificates.rva && end <= certificates.rva)
+	{
+		set_data_directory(SECURITY_DIRECTORY, { static_cast<std::uint32_t>(certificates.rva - count), certificates.size });
+	}
+
+	std::erase_if(splices, [offset, end](const resource_tree::splice& splice)
+	              { return offset <= splice.offset && splice.offset < end; });
+
+	for (resource_tree::splice& splice : splices)
+	{
+		if (end <= splice.offset)
+		{
+			splice.offset -= static_cast<std::uint32_t>(count);
+		}
+	}
+}
+
+void pe_image::release_section(const std::size_t index)
+{
+	section&            section = sections[index];
+	const std::uint32_t offset  = section.raw_offset;
+	const std::uint32_t size    = section.raw_size;
+
+	LOG("Dropping the {} bytes of section {} from the file.", size, index);
+
+	// The loader zero-fills the whole virtual size, which must still cover the
+	// memory the section used to take.
+	section.virtual_size = 0 == section.virtual_size ? size : section.virtual_size;
+	section.raw_offset   = 0;
+	section.raw_size     = 0;
+	write_section(index);
+	remove_bytes(offset, size);
+	shrink_initialized_data(size);
+}
+
+void pe_image::shrink_initialized_data(const std::uint32_t size)
+{
+	const std::uint32_t current = read<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET);
+
+	write<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET, current - std::min(current, size));
+}
+
+bool pe_image::is_referenced(const std::size_t index) const
+{
+	for (std::size_t entry = 0; entry < data_directories_count; ++entry)
+	{
+		const data_directory directory = get_data_directory(entry);
+
+		if (SECURITY_DIRECTORY != entry && 0 != directory.rva && find_section(directory.rva) == index)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::size_t pe_image::append_section(const std::string_view name,
+                                     const std::uint32_t    raw_size,
+                                     const std::uint32_t    characteristics)
+{
+	const std::size_t   table_end    = section_table_offset + (sections.size() + 1) * sizeof(section_header);
+	const std::uint32_t headers_size = read<std::uint32_t>(optional_header_offset + HEADERS_SIZE_OFFSET);
+	std::uint64_t       address      = align_up(headers_size, section_alignment);
+	std::size_t         first_data   = headers_size;
+
+	for (const section& section : sections)
+	{
+		address = std::max(address, align_up(section.virtual_address + std::max(section.virtual_size, section.raw_size), section_alignment));
+
+		if (0 != section.raw_size)
+		{
+			first_data = std::min<std::size_t>(first_data, section.raw_offset);
+		}
+	}
+
+	if (std::min<std::size_t>(headers_size, first_data) < table_end)
+	{
+		throw std::runtime_error{ "Executable has no room for another section header!" };
+	}
+
+	// An image without sections has its first one right after the headers.
+	const std::size_t end    = std::max<std::size_t>(get_sections_end(), headers_size);
+	const std::size_t offset = align_up(end, file_alignment);
+
+	insert_bytes(end, offset - end + raw_size);
+	sections.push_back({ std::string{ name }, 0, static_cast<std::uint32_t>(address), raw_size, static_cast<std::uint32_t>(offset), characteristics });
+	write_section(sections.size() - 1);
+
+	write<std::uint16_t>(file_header_offset + offsetof(file_header, sections_count), static_cast<std::uint16_t>(sections.size()));
+	write<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET,
+	                     read<std::uint32_t>(optional_header_offset + INITIALIZED_DATA_SIZE_OFFSET) + raw_size);
+
+	return sections.size() - 1;
+}
+
+void pe_image::update_image_size()
+{
+	std::uint64_t size = align_up(read<std::uint32_t>(optional_header_offset + HEADERS_SIZE_OFFSET), section_alignment);
+
+	for (const section& section : sections)
+	{
+		size = std::max(size, align_up(section.virtual_address + std::max<std::uint64_t>(section.virtual_size, 1), section_alignment));
+	}
+
+	write<std::uint32_t>(optional_header_offset + IMAGE_SIZE_OFFSET, static_cast<std::uint32_t>(size));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr std::uint64_t align_up(const std::uint64_t value,
+                                        const std::uint64_t alignment) noexcept
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+template<typename T>
+static T read_value(const std::span<const std::uint8_t> bytes,
+                    const std::size_t                   offset)
+{
+	T value = {};
+
+	if (bytes.size() < offset || bytes.size() - offset < sizeof(T))
+	{
+		throw std::invalid_argument{ std::format("Executable is truncated at offset 0x{:X}!", offset) };
+	}
+
+	std::memcpy(&value, bytes.data() + offset, sizeof(T));
+	return value;
+}
+
+template<typename T>
+static void write_value(std::pmr::vector<std::uint8_t>& bytes,
+                        const std::size_t               offset,
+                        const T                         value) noexcept
+{
+	std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+static std::uint64_t sum_checksum_words(const std::span<const std::uint8_t> bytes,
+                                        const std::size_t                   checksum_offset) noexcept
+{
+	std::uint64_t sum = 0;
+
+	for (std::size_t offset = 0; offset < bytes.size(); offset += sizeof(std::uint16_t))
+	{
+		if (checksum_offset == offset || checksum_offset + sizeof(std::uint16_t) == offset)
+		{
+			continue;
+		}
+
+		sum += bytes[offset] | (offset + 1 < bytes.size() ? bytes[offset + 1] << 8 : 0);
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+static std::pmr::vector<std::uint8_t> read_file(const std::string_view           file_path,
+                                                memory_reservation&              reservation,
+                                                std::pmr::memory_resource* const resource)
+{
+	std::ifstream                  file  = std::ifstream{ std::string{ file_path }, std::ios::binary | std::ios::ate };
+	std::pmr::vector<std::uint8_t> bytes = std::pmr::vector<std::uint8_t>{ resource };
+
+	if (!file.is_open())
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+	}
+
+	reservation = memory_reservation{ static_cast<std::uint64_t>(file.tellg()), std::format("\"{}\"", file_path) };
+	bytes.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0, std::ios::beg);
+
+	if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+	{
+		throw std::runtime_error{ std::format("Failed to read \"{}\"!", file_path) };
+	}
+
+	add(counter::bytes_read, bytes.size());
+
+	return bytes;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,422 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "memory_budget.hpp"
+#include "resource_tree.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+class file_writer;
+
+///
+/// \brief Portable reader and writer of PE32 and PE32+ executables.
+/// \details Only the parts needed to replace the resource section are
+/// modelled; everything else is carried over byte for byte, so rewriting an
+/// executable with the same resources produces the same file.
+/// \see https://learn.microsoft.com/en-us/windows/win32/debug/pe-format
+///
+class pe_image final
+{
+public:
+	///
+	/// \brief Index of the resource table in the data directories.
+	///
+	static constexpr std::size_t RESOURCE_DIRECTORY = 2;
+
+	///
+	/// \brief Index of the certificate table in the data directories.
+	/// \details Unlike the other entries it holds a file offset, not an RVA.
+	///
+	static constexpr std::size_t SECURITY_DIRECTORY = 4;
+
+	///
+	/// \brief Index of the base relocation table in the data directories.
+	///
+	static constexpr std::size_t BASE_RELOCATION_DIRECTORY = 5;
+
+	///
+	/// \brief A section of the image, decoded from IMAGE_SECTION_HEADER.
+	///
+	struct section final
+	{
+		std::string   name;            ///< Section name, at most 8 characters.
+		std::uint32_t virtual_size;    ///< Size of the section when loaded in memory.
+		std::uint32_t virtual_address; ///< RVA of the section.
+		std::uint32_t raw_size;        ///< Size of the section data in the file.
+		std::uint32_t raw_offset;      ///< File offset of the section data.
+		std::uint32_t characteristics; ///< IMAGE_SCN_* flags.
+	};
+
+	///
+	/// \brief An entry of the optional header data directories.
+	///
+	struct data_directory final
+	{
+		std::uint32_t rva;  ///< RVA of the table (file offset for the certificate table).
+		std::uint32_t size; ///< Size of the table in bytes.
+	};
+
+	///
+	/// \brief Where set_resources() put the new resource section.
+	///
+	enum class placement
+	{
+		in_place, ///< The existing section was rewritten, the file layout is unchanged.
+		grown,    ///< The existing section was the last one and was enlarged.
+		appended, ///< A new section was appended, the old one is left unused.
+	};
+
+	///
+	/// \brief The resource directory located inside an executable that was not
+	/// loaded into a pe_image.
+	///
+	struct resource_view final
+	{
+		std::span<const std::uint8_t> directory; ///< From the root directory to the end of its section, empty if none.
+		std::uint32_t                 rva;       ///< RVA of the root directory.
+	};
+
+public:
+	///
+	/// \brief Constructor to load an executable from a file.
+	/// \param file_path: The path to the executable.
+	/// \param resource: Where the contents, the sections and the resources
+	/// parsed by get_resources() are allocated, it must outlive the image.
+	///
+	explicit pe_image(std::string_view           file_path,
+	                  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	///
+	/// \brief Constructor to load an executable already in memory.
+	/// \param bytes: The whole file contents, their memory resource is used
+	/// for everything else too.
+	///
+	explicit pe_image(std::pmr::vector<std::uint8_t> bytes);
+
+	///
+	/// \brief Creates an empty x64 DLL, to be filled with resources.
+	/// \details The image only has headers: no code, no entry point, no
+	/// imports and no sections until set_resources() appends one, which is all
+	/// LoadLibraryEx(LOAD_LIBRARY_AS_DATAFILE) and the shell need. The time
+	/// stamp is zero so the output is reproducible.
+	/// \returns The PE32+ image.
+	///
+	[[nodiscard]] static pe_image create_resource_dll();
+
+	///
+	/// \brief Locates the resource directory of an executable without copying it.
+	/// \details Only the headers needed to find the directory are validated, so
+	/// it can be used on memory mapped files.
+	/// \param file: The whole file contents.
+	/// \returns The resource directory, referring to the file contents.
+	///
+	[[nodiscard]] static resource_view find_resources(std::span<const std::uint8_t> file);
+
+	///
+	/// \brief Validates an executable without loading it.
+	/// \details The headers are checked like when loading (signatures,
+	/// alignments, section data inside the file) and the checksum is recomputed
+	/// unless it is 0. The checksum reads every page of a mapped file, but
+	/// nothing is copied.
+	/// \param file: The whole file contents.
+	/// \returns The resource directory, see find_resources().
+	///
+	[[nodiscard]] static resource_view verify(std::span<const std::uint8_t> file);
+
+	///
+	/// \brief Parses the resource section.
+	/// \returns The resources, an empty tree if the image has none.
+	///
+	[[nodiscard]] resource_tree get_resources() const;
+
+	///
+	/// \brief Replaces the resource section with the serialized tree.
+	/// \details The section is rewritten in place when the tree fits, grown
+	/// when it is the last section, and otherwise a new section is appended
+	/// and the data directory is pointed at it. Trailing data (e.g. a
+	/// certificate table) is moved along and the checksum is kept valid. An
+	/// unsigned image is padded to a multiple of 8 bytes, like signing tools do.
+	/// Resources added as file ranges are not copied: they are spliced into
+	/// the output when it is written.
+	/// \param resources: The new resources.
+	/// \returns How the section was placed.
+	///
+	placement set_resources(const resource_tree& resources);
+
+	///
+	/// \brief Rebuilds the resource section tightly packed.
+	/// \details The section is shrunk to the serialized tree when it is the
+	/// last one, and moved to the end of the image otherwise, so later updates
+	/// can grow it. The file data of resource sections abandoned by earlier
+	/// updates (see placement::appended) is dropped too. Their headers stay,
+	/// describing zero-filled memory, because the sections after them cannot
+	/// move in memory.
+	/// \returns The number of sections whose file data was dropped.
+	///
+	std::size_t compact_resources();
+
+	///
+	/// \brief Writes the image to a file.
+	/// \details Writes a temporary file next to the target and renames it over
+	/// the target, so a failure never leaves a half written executable.
+	/// \param file_path: The path to the output file.
+	/// \param contents: Receives every byte written, so the file does not need
+	/// to be read again to be hashed. Can be nullptr.
+	/// \param check: Called with the path to the temporary file once it is
+	/// written. If it throws the temporary file is deleted and the target is
+	/// left as it was. Can be empty.
+	///
+	void save(std::string_view                             file_path,
+	          sha256*                                      contents = nullptr,
+	          const std::function<void(std::string_view)>& check    = {}) const;
+
+	///
+	/// \brief Writes the image to a file and computes its Authenticode digest
+	/// on the fly.
+	/// \details Every chunk is hashed right after it is written, so signing
+	/// does not need to read the file again. The file is the same as the one
+	/// written by save(). Updated images are already padded, see
+	/// set_resources(), other unsigned images are hashed as if they were.
+	/// \param file_path: The path to the output file.
+	/// \param contents: Receives every byte written, see save().
+	/// \param check: Checks the temporary file, see save().
+	/// \returns The SHA-256 Authenticode digest of the written file.
+	///
+	[[nodiscard]] sha256::digest save_with_digest(std::string_view                             file_path,
+	                                              sha256*                                      contents = nullptr,
+	                                              const std::function<void(std::string_view)>& check    = {}) const;
+
+	///
+	/// \brief Computes the Authenticode digest without writing anything.
+	/// \details The checksum, the certificate table data directory entry and
+	/// the certificate table itself are excluded from the hash.
+	/// \returns The SHA-256 Authenticode digest of the image.
+	///
+	[[nodiscard]] sha256::digest compute_digest() const;
+
+	///
+	/// \brief Checks whether the image carries a certificate table.
+	/// \returns true if the image is signed, false otherwise.
+	///
+	[[nodiscard]] bool has_certificates() const;
+
+	///
+	/// \brief Removes the certificate table (the Authenticode signatures).
+	/// \details The table must be at the end of the file, as the
+	/// specification requires.
+	///
+	void strip_certificates();
+
+	///
+	/// \brief Gets the file contents.
+	/// \details Resources added as file ranges are still in their files, so
+	/// their bytes are zero here until the image is saved.
+	/// \returns The bytes of the image as they would be saved, but for the
+	/// spliced resources.
+	///
+	[[nodiscard]] const std::pmr::vector<std::uint8_t>& get_bytes() const noexcept;
+
+	///
+	/// \brief Gets the section table.
+	/// \returns The sections, in the order of the section table.
+	///
+	[[nodiscard]] const std::pmr::vector<section>& get_sections() const noexcept;
+
+	///
+	/// \brief Gets a data directory entry.
+	/// \param index: The index of the entry (e.g. RESOURCE_DIRECTORY).
+	/// \returns The entry, zeroed if the image has fewer entries.
+	///
+	[[nodiscard]] data_directory get_data_directory(std::size_t index) const;
+
+	///
+	/// \brief Computes the checksum the same way as CheckSumMappedFile.
+	/// \returns The checksum of the current bytes.
+	///
+	[[nodiscard]] std::uint32_t compute_checksum() const;
+
+private:
+	///
+	/// \brief Parses and validates the DOS, NT and section headers.
+	///
+	void parse_headers();
+
+	///
+	/// \brief Streams the image in chunks to a file and/or a hash.
+	/// \details Regions excluded from the Authenticode digest are written but
+	/// not hashed. Spliced resources are copied from their files.
+	/// \param file: The output file, nullptr to only hash.
+	/// \param hash: The hash to be updated, nullptr to only write.
+	/// \param contents: The hash of every byte written, can be nullptr.
+	///
+	void write_chunks(file_writer* file,
+	                  sha256*      hash,
+	                  sha256*      contents) const;
+
+	///
+	/// \brief Writes a temporary file and renames it over the target.
+	/// \param file_path: The path to the output file.
+	/// \param hash: The hash to be updated while writing, can be nullptr.
+	/// \param contents: The hash of every byte written, can be nullptr.
+	/// \param check: Checks the temporary file before the rename, can be empty.
+	///
+	void write_file(std::string_view                             file_path,
+	                sha256*                                      hash,
+	                sha256*                                      contents,
+	                const std::function<void(std::string_view)>& check) const;
+
+	///
+	/// \brief Pads an unsigned image with zeros to a multiple of 8 bytes.
+	/// \details Signing tools pad the file the same way before appending the
+	/// certificate table, so the output is the same whether its digest is
+	/// computed or not.
+	///
+	void pad_for_signing();
+
+	///
+	/// \brief Recomputes the checksum unless the image opted out with 0.
+	///
+	void update_checksum();
+
+	///
+	/// \brief Reads a little endian value from the image.
+	/// \param offset: The file offset.
+	/// \returns The value.
+	///
+	template<typename T>
+	[[nodiscard]] T read(std::size_t offset) const;
+
+	///
+	/// \brief Writes a little endian value into the image.
+	/// \param offset: The file offset.
+	/// \param value: The value.
+	///
+	template<typename T>
+	void write(std::size_t offset,
+	           T           value);
+
+	///
+	/// \brief Updates a data directory entry.
+	/// \param index: The index of the entry.
+	/// \param directory: The new value.
+	///
+	void set_data_directory(std::size_t    index,
+	                        data_directory directory);
+
+	///
+	/// \brief Writes a section back into the section table.
+	/// \param index: The index of the section.
+	///
+	void write_section(std::size_t index);
+
+	///
+	/// \brief Finds the section containing an RVA.
+	/// \param rva: The RVA.
+	/// \returns The index of the section, sections.size() if none.
+	///
+	[[nodiscard]] std::size_t find_section(std::uint32_t rva) const noexcept;
+
+	///
+	/// \brief Computes the file offset right after the last section data.
+	/// \returns The offset where trailing data starts.
+	///
+	[[nodiscard]] std::size_t get_sections_end() const noexcept;
+
+	///
+	/// \brief Inserts zero bytes and fixes the file offsets that moved.
+	/// \param offset: The file offset where the bytes are inserted.
+	/// \param count: The number of bytes.
+	///
+	void insert_bytes(std::size_t offset,
+	                  std::size_t count);
+
+	///
+	/// \brief Removes bytes and fixes the file offsets that moved.
+	/// \details Besides the section table and the certificate table, the debug
+	/// directory and the COFF symbol table also refer to file offsets.
+	/// \param offset: The file offset of the first removed byte.
+	/// \param count: The number of bytes.
+	///
+	void remove_bytes(std::size_t offset,
+	                  std::size_t count);
+
+	///
+	/// \brief Drops the file data of a section, keeping it in memory as zeros.
+	/// \param index: The index of the section.
+	///
+	void release_section(std::size_t index);
+
+	///
+	/// \brief Subtracts removed section data from SizeOfInitializedData.
+	/// \param size: The number of bytes removed.
+	///
+	void shrink_initialized_data(std::uint32_t size);
+
+	///
+	/// \brief Checks whether a data directory entry points into a section.
+	/// \param index: The index of the section.
+	/// \returns true if some table lives in the section, false otherwise.
+	///
+	[[nodiscard]] bool is_referenced(std::size_t index) const;
+
+	///
+	/// \brief Appends a new section at the end of the image.
+	/// \param name: The section name.
+	/// \param raw_size: The size of the section data in the file.
+	/// \param characteristics: The IMAGE_SCN_* flags.
+	/// \returns The index of the new section.
+	///
+	std::size_t append_section(std::string_view name,
+	                           std::uint32_t    raw_size,
+	                           std::uint32_t    characteristics);
+
+	///
+	/// \brief Recomputes SizeOfImage from the last section.
+	///
+	void update_image_size();
+
+private:
+	memory_reservation                       reservation;             ///< Counts the file contents against the memory limits.
+	std::pmr::vector<std::uint8_t>           bytes;                   ///< The whole file contents.
+	std::pmr::vector<section>                sections;                ///< The decoded section table.
+	std::pmr::vector<resource_tree::splice>  splices;                 ///< Resources left in their files, sorted by file offset.
+	std::size_t                              file_header_offset;      ///< Offset of IMAGE_FILE_HEADER.
+	std::size_t                              optional_header_offset;  ///< Offset of the optional header.
+	std::size_t                              data_directories_offset; ///< Offset of the first data directory.
+	std::size_t                              data_directories_count;  ///< Number of data directories.
+	std::size_t                              section_table_offset;    ///< Offset of the first section header.
+	std::uint32_t                            section_alignment;       ///< Alignment of sections in memory.
+	std::uint32_t                            file_alignment;          ///< Alignment of section data in the file.
+};
+
+} // namespace icon_changer
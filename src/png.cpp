@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "png.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The 8 bytes every PNG file starts with.
+///
+static constexpr std::array<std::uint8_t, 8> PNG_SIGNATURE = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+///
+/// \brief IHDR fields for 8 bits per channel RGBA without interlacing.
+///
+static constexpr std::uint8_t BIT_DEPTH       = 8;
+static constexpr std::uint8_t RGBA_COLOR_TYPE = 6;
+
+///
+/// \brief The largest stored deflate block.
+///
+static constexpr std::size_t MAX_STORED_BLOCK_SIZE = 0xFFFF;
+
+///
+/// \brief The zlib header for deflate with a 32 KiB window and no dictionary.
+///
+static constexpr std::array<std::uint8_t, 2> ZLIB_HEADER = { 0x78, 0x01 };
+
+///
+/// \brief Modulus of the Adler-32 sums, and the number of bytes that can be
+/// summed before the 32-bit sums could overflow.
+///
+static constexpr std::uint32_t ADLER_MODULUS   = 65521;
+static constexpr std::size_t   ADLER_MAX_BYTES = 5552;
+
+///
+/// \brief The CRC-32 lookup table (reflected polynomial 0xEDB88320).
+///
+static constexpr std::array<std::uint32_t, 256> CRC_TABLE = []()
+{
+	std::array<std::uint32_t, 256> table = {};
+
+	for (std::uint32_t index = 0; index < table.size(); ++index)
+	{
+		std::uint32_t value = index;
+
+		for (std::uint32_t bit = 0; bit < 8; ++bit)
+		{
+			value = 0 != (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+		}
+
+		table[index] = value;
+	}
+
+	return table;
+}();
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Appends a big endian 32-bit value.
+/// \param bytes: The file being built.
+/// \param value: The value.
+///
+static void append_big_endian(std::vector<std::uint8_t>& bytes,
+                              std::uint32_t              value);
+
+///
+/// \brief Appends a chunk with its length and CRC.
+/// \param bytes: The file being built.
+/// \param type: The four character chunk type.
+/// \param data: The chunk data.
+///
+static void append_chunk(std::vector<std::uint8_t>&    bytes,
+                         std::string_view              type,
+                         std::span<const std::uint8_t> data);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::uint8_t> encode_png(const std::uint32_t                 width,
+                                     const std::uint32_t                 height,
+                                     const std::span<const std::uint8_t> pixels)
+{
+	const std::size_t row_size = static_cast<std::size_t>(width) * 4;
+
+	if (0 == width || 0 == height || pixels.size() != row_size * height)
+	{
+		throw std::invalid_argument{ std::format("{} bytes are not {}x{} RGBA pixels!", pixels.size(), width, height) };
+	}
+
+	std::vector<std::uint8_t> bytes    = { PNG_SIGNATURE.begin(), PNG_SIGNATURE.end() };
+	std::vector<std::uint8_t> header   = {};
+	std::vector<std::uint8_t> filtered = {};
+	std::vector<std::uint8_t> data     = { ZLIB_HEADER.begin(), ZLIB_HEADER.end() };
+	std::uint32_t             adler_a  = 1;
+	std::uint32_t             adler_b  = 0;
+
+	append_big_endian(header, width);
+	append_big_endian(header, height);
+	header.insert(header.end(), { BIT_DEPTH, RGBA_COLOR_TYPE, 0, 0, 0 });
+
+	// Every row starts with filter type 0 (none).
+	filtered.reserve((row_size + 1) * height);
+
+	for (std::uint32_t row = 0; row < height; ++row)
+	{
+		filtered.push_back(0);
+		filtered.insert(filtered.end(), pixels.begin() + row * row_size, pixels.begin() + (row + 1) * row_size);
+	}
+
+	data.reserve(data.size() + filtered.size() + (filtered.size() / MAX_STORED_BLOCK_SIZE + 1) * 5 + 4);
+
+	for (std::size_t offset = 0; offset < filtered.size(); offset += MAX_STORED_BLOCK_SIZE)
+	{
+		const std::size_t   size  = std::min(MAX_STORED_BLOCK_SIZE, filtered.size() - offset);
+		const std::uint16_t block = static_cast<std::uint16_t>(size);
+
+		data.push_back(filtered.size() == offset + size ? 1 : 0);
+		data.insert(data.end(), { static_cast<std::uint8_t>(block), static_cast<std::uint8_t>(block >> 8),
+		                          static_cast<std::uint8_t>(~block), static_cast<std::uint8_t>(~block >> 8) });
+		data.insert(data.end(), filtered.begin() + offset, filtered.begin() + offset + size);
+	}
+
+	for (std::size_t offset = 0; offset < filtered.size(); offset += ADLER_MAX_BYTES)
+	{
+		const std::size_t end = std::min(filtered.size(), offset + ADLER_MAX_BYTES);
+
+		for (std::size_t index = offset; index < end; ++index)
+		{
+			adler_a += filtered[index];
+			adler_b += adler_a;
+		}
+
+		adler_a %= ADLER_MODULUS;
+		adler_b %= ADLER_MODULUS;
+	}
+
+	append_big_endian(data, (adler_b << 16) | adler_a);
+
+	append_chunk(bytes, "IHDR", header);
+	append_chunk(bytes, "IDAT", data);
+	append_chunk(bytes, "IEND", {});
+
+	return bytes;
+}
+
+std::uint32_t crc32(const std::span<const std::uint8_t> bytes,
+                    const std::uint32_t                 crc) noexcept
+{
+	std::uint32_t value = ~crc;
+
+	for (const std::uint8_t byte : bytes)
+	{
+		value = CRC_TABLE[(value ^ byte) & 0xFF] ^ (value >> 8);
+	}
+
+	return ~value;
+}
+
+static void append_big_endian(std::vector<std::uint8_t>& bytes,
+                              const std::uint32_t        value)
+{
+	bytes.insert(bytes.end(), { static_cast<std::uint8_t>(value >> 24), static_cast<std::uint8_t>(value >> 16),
+	                            static_cast<std::uint8_t>(value >> 8), static_cast<std::uint8_t>(value) });
+}
+
+static void append_chunk(std::vector<std::uint8_t>&          bytes,
+                         const std::string_view              type,
+                         const std::span<const std::uint8_t> data)
+{
+	const std::size_t type_offset = bytes.size() + 4;
+
+	append_big_endian(bytes, static_cast<std::uint32_t>(data.size()));
+	bytes.insert(bytes.end(), type.begin(), type.end());
+	bytes.insert(bytes.end(), data.begin(), data.end());
+	append_big_endian(bytes, crc32(std::span{ bytes }.subspan(type_offset)));
+}
+
+} // namespace icon_changer
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Encodes RGBA8 pixels as a PNG file.
+/// \details The image data is wrapped in stored (uncompressed) deflate blocks,
+/// which every decoder accepts and which costs no time to produce.
+/// \param width: The image width in pixels.
+/// \param height: The image height in pixels.
+/// \param pixels: The pixels, top row first, 4 bytes per pixel.
+/// \returns The bytes of the PNG file.
+/// \see https://www.w3.org/TR/png/
+///
+extern std::vector<std::uint8_t> encode_png(std::uint32_t                 width,
+                                            std::uint32_t                 height,
+                                            std::span<const std::uint8_t> pixels);
+
+///
+/// \brief Computes the CRC-32 used by PNG chunks (and ZIP, gzip).
+/// \param bytes: The bytes to be checked.
+/// \param crc: The CRC of the preceding bytes, to continue a computation.
+/// \returns The CRC-32 of the bytes.
+///
+extern std::uint32_t crc32(std::span<const std::uint8_t> bytes,
+                           std::uint32_t                 crc = 0) noexcept;
+
+} // namespace icon_changer
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "resource_backend.hpp"
+
+#include <format>
+#include <iterator>
+#include <stdexcept>
+
+#include "json.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Gets the name of a placement, as used in the reports.
+/// \param placement: The placement.
+/// \returns The name.
+///
+static std::string_view to_string(pe_image::placement placement) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+resource_backend::resource_backend(pe_image image)
+    : image{ std::move(image) }
+    , resources{ this->image.get_resources() }
+    , check{}
+{
+}
+
+pe_image& resource_backend::get_image() noexcept
+{
+	return image;
+}
+
+const resource_tree& resource_backend::get_resources() const noexcept
+{
+	return resources;
+}
+
+void resource_backend::set(const resource_id&        type,
+                           const resource_id&        name,
+                           const std::uint16_t       language,
+                           std::vector<std::uint8_t> data)
+{
+	resources.set(type, name, language, std::move(data));
+}
+
+void resource_backend::set_range(const resource_id&  type,
+                                 const resource_id&  name,
+                                 const std::uint16_t language,
+                                 file_range          range)
+{
+	resources.set_range(type, name, language, std::move(range));
+}
+
+void resource_backend::merge(const resource_tree& additions)
+{
+	resources.merge(additions);
+}
+
+void resource_backend::set_check(std::function<void(std::string_view)> check)
+{
+	this->check = std::move(check);
+}
+
+file_backend::file_backend(const std::string_view           file_path,
+                           const bool                       compute_digest,
+                           const bool                       hash_contents,
+                           std::pmr::memory_resource* const resource)
+    : resource_backend{ pe_image{ file_path, resource } }
+    , file_path{ file_path }
+    , compute_digest{ compute_digest }
+    , hash_contents{ hash_contents }
+    , digest{}
+    , contents{}
+{
+}
+
+void file_backend::commit()
+{
+	sha256 hash = {};
+
+	image.set_resources(resources);
+
+	if (compute_digest)
+	{
+		digest = image.save_with_digest(file_path, hash_contents ? &hash : nullptr, check);
+	}
+	else
+	{
+		image.save(file_path, hash_contents ? &hash : nullptr, check);
+	}
+
+	if (hash_contents)
+	{
+		contents = hash.finalize();
+	}
+}
+
+const std::optional<sha256::digest>& file_backend::get_digest() const noexcept
+{
+	return digest;
+}
+
+const std::optional<sha256::digest>& file_backend::get_contents_hash() const noexcept
+{
+	return contents;
+}
+
+memory_backend::memory_backend(const std::string_view           file_path,
+                               std::pmr::memory_resource* const resource)
+    : resource_backend{ pe_image{ file_path, resource } }
+    , result{}
+{
+}
+
+memory_backend::memory_backend(std::pmr::vector<std::uint8_t> bytes)
+    : resource_backend{ pe_image{ std::move(bytes) } }
+    , result{}
+{
+}
+
+void memory_backend::commit()
+{
+	const std::size_t         old_size  = image.get_bytes().size();
+	const pe_image::placement placement = image.set_resources(resources);
+	const std::uint32_t       rva       = image.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva;
+
+	for (const pe_image::section& section : image.get_sections())
+	{
+		if (section.virtual_address == rva)
+		{
+			result = report{ old_size, image.get_bytes().size(), placement, section, resources.get_serialized_size() };
+			return;
+		}
+	}
+
+	throw std::logic_error{ "Resource section is missing after the update!" };
+}
+
+const std::optional<memory_backend::report>& memory_backend::get_report() const noexcept
+{
+	return result;
+}
+
+std::string memory_backend::to_json(const std::string_view file_path) const
+{
+	if (!result.has_value())
+	{
+		throw std::logic_error{ "Nothing was committed yet!" };
+	}
+
+	std::string json = "{\"path\":";
+
+	append_json_string(json, file_path);
+	std::format_to(std::back_inserter(json),
+	               ",\"placement\":\"{}\",\"old_size\":{},\"new_size\":{},\"delta\":{},\"section\":{{\"name\":",
+	               to_string(result->placement), result->old_size, result->new_size,
+	               static_cast<std::int64_t>(result->new_size) - static_cast<std::int64_t>(result->old_size));
+	append_json_string(json, result->section.name);
+	std::format_to(std::back_inserter(json),
+	               ",\"virtual_address\":{},\"raw_offset\":{},\"raw_size\":{},\"resources_size\":{}}}}}",
+	               result->section.virtual_address, result->section.raw_offset, result->section.raw_size, result->size);
+
+	return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string_view to_string(const pe_image::placement placement) noexcept
+{
+	if (pe_image::placement::grown == placement)
+	{
+		return "grown";
+	}
+
+	if (pe_image::placement::appended == placement)
+	{
+		return "appended";
+	}
+
+	return "in_place";
+}
+
+} // namespace icon_changer
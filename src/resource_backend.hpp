@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pe_image.hpp"
+#include "resource_tree.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Destination of a resource update.
+/// \details Resources are collected with set() and applied all at once by
+/// commit(), so every update rewrites the executable a single time. The
+/// implementations decide what applying means.
+///
+class resource_backend
+{
+public:
+	///
+	/// \brief Constructor to start an update of an executable.
+	/// \param image: The executable, its current resources are kept.
+	///
+	explicit resource_backend(pe_image image);
+
+	virtual ~resource_backend() = default;
+
+	///
+	/// \brief Gets the executable being updated.
+	/// \returns The image, for changes other than resources (e.g. signatures).
+	///
+	[[nodiscard]] pe_image& get_image() noexcept;
+
+	///
+	/// \brief Gets the resources the executable will have.
+	/// \returns The current resources and those added so far.
+	///
+	[[nodiscard]] const resource_tree& get_resources() const noexcept;
+
+	///
+	/// \brief Adds a resource, replacing the one with the same type, name and
+	/// language if present.
+	/// \param type: The resource type.
+	/// \param name: The resource name.
+	/// \param language: The resource language.
+	/// \param data: The resource bytes.
+	///
+	void set(const resource_id&        type,
+	         const resource_id&        name,
+	         std::uint16_t             language,
+	         std::vector<std::uint8_t> data);
+
+	///
+	/// \brief Adds a resource whose bytes stay in a mapped file until the
+	/// executable is written.
+	/// \param type: The resource type.
+	/// \param name: The resource name.
+	/// \param language: The resource language.
+	/// \param range: The resource bytes.
+	///
+	void set_range(const resource_id& type,
+	               const resource_id& name,
+	               std::uint16_t      language,
+	               file_range         range);
+
+	///
+	/// \brief Adds every resource of a tree, replacing the ones with the same
+	/// type, name and language.
+	/// \param additions: The resources to be added.
+	///
+	void merge(const resource_tree& additions);
+
+	///
+	/// \brief Sets a check of the written executable, run before it replaces
+	/// the original.
+	/// \details If the check throws the update fails and the original stays.
+	/// Backends that write no file do not run it.
+	/// \param check: Called with the path to the written file.
+	///
+	void set_check(std::function<void(std::string_view)> check);
+
+	///
+	/// \brief Applies the collected resources.
+	///
+	virtual void commit() = 0;
+
+protected:
+	pe_image                              image;     ///< The executable being updated.
+	resource_tree                         resources; ///< The resources it will have.
+	std::function<void(std::string_view)> check;     ///< Run on the written file before it is committed.
+};
+
+///
+/// \brief Backend writing the updated executable back to its file.
+///
+class file_backend final : public resource_backend
+{
+public:
+	///
+	/// \brief Constructor to load an executable.
+	/// \param file_path: The path to the executable, also the output path.
+	/// \param compute_digest: Whether the Authenticode digest is computed
+	/// while writing.
+	/// \param hash_contents: Whether the SHA-256 of the whole file is computed
+	/// while writing, e.g. for the journal.
+	/// \param resource: Where the executable and its resources are allocated,
+	/// e.g. an arena released after the update. It must outlive the backend.
+	///
+	file_backend(std::string_view           file_path,
+	             bool                       compute_digest,
+	             bool                       hash_contents = false,
+	             std::pmr::memory_resource* resource      = std::pmr::get_default_resource());
+
+	///
+	/// \brief Writes the executable with the new resources.
+	///
+	void commit() override;
+
+	///
+	/// \brief Gets the digest computed by commit().
+	/// \returns The digest, empty if it was not requested or not committed yet.
+	///
+	[[nodiscard]] const std::optional<sha256::digest>& get_digest() const noexcept;
+
+	///
+	/// \brief Gets the SHA-256 of the file written by commit().
+	/// \returns The hash, empty if it was not requested or not committed yet.
+	///
+	[[nodiscard]] const std::optional<sha256::digest>& get_contents_hash() const noexcept;
+
+private:
+	std::string                   file_path;      ///< The path to the executable.
+	bool                          compute_digest; ///< Whether commit() computes the digest.
+	bool                          hash_contents;  ///< Whether commit() hashes the whole file.
+	std::optional<sha256::digest> digest;         ///< The digest of the written file.
+	std::optional<sha256::digest> contents;       ///< The SHA-256 of the written file.
+};
+
+///
+/// \brief Backend applying the update in memory only, for dry runs and tests.
+/// \details The update goes through exactly the same code as a real one, so
+/// the reported layout and sizes are the ones the file would have.
+///
+class memory_backend final : public resource_backend
+{
+public:
+	///
+	/// \brief What the update would do to the executable.
+	///
+	struct report final
+	{
+		std::size_t         old_size;  ///< File size before the update.
+		std::size_t         new_size;  ///< File size after the update.
+		pe_image::placement placement; ///< How the resource section was placed.
+		pe_image::section   section;   ///< The resource section after the update.
+		std::uint32_t       size;      ///< Size of the serialized resources.
+	};
+
+public:
+	///
+	/// \brief Constructor to load an executable from a file.
+	/// \param file_path: The path to the executable, never written.
+	/// \param resource: Where the executable and its resources are allocated.
+	///
+	explicit memory_backend(std::string_view           file_path,
+	                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	///
+	/// \brief Constructor to use an executable already in memory.
+	/// \param bytes: The whole file contents.
+	///
+	explicit memory_backend(std::pmr::vector<std::uint8_t> bytes);
+
+	///
+	/// \brief Applies the new resources to the image in memory.
+	///
+	void commit() override;
+
+	///
+	/// \brief Gets the outcome of commit().
+	/// \returns The report, empty if not committed yet.
+	///
+	[[nodiscard]] const std::optional<report>& get_report() const noexcept;
+
+	///
+	/// \brief Describes the outcome of commit() as a JSON object.
+	/// \param file_path: The path reported for the executable.
+	/// \returns One line of JSON, without the line feed.
+	///
+	[[nodiscard]] std::string to_json(std::string_view file_path) const;
+
+private:
+	std::optional<report> result; ///< The outcome of commit().
+};
+
+} // namespace icon_changer
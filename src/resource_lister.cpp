@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "resource_lister.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+
+#include "icon.hpp"
+#include "json.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include "pe_image.hpp"
+#include "resource_tree.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Extensions of the files picked up when searching directories.
+///
+static constexpr std::array<std::string_view, 7> EXECUTABLE_EXTENSIONS = { ".exe", ".dll", ".sys", ".ocx", ".cpl", ".scr", ".efi" };
+
+///
+/// \brief Checks whether a file found in a directory looks like an executable.
+/// \param path: The path to the file.
+/// \returns true if the extension is one of EXECUTABLE_EXTENSIONS.
+///
+static bool is_executable(const std::filesystem::path& path);
+
+///
+/// \brief Appends a resource identifier, ordinals as numbers and names as strings.
+/// \param json: The JSON being built.
+/// \param id: The identifier.
+///
+static void append_id(std::string&       json,
+                      const resource_id& id);
+
+///
+/// \brief Appends the RESDIR entries of an RT_GROUP_ICON resource.
+/// \param json: The JSON being built.
+/// \param data: The resource data (NEWHEADER followed by the entries).
+///
+static void append_icon_entries(std::string&                  json,
+                                std::span<const std::uint8_t> data);
+
+///
+/// \brief Appends the RESDIR entries of an RT_GROUP_CURSOR resource.
+/// \param json: The JSON being built.
+/// \param data: The resource data (NEWHEADER followed by the entries).
+///
+static void append_cursor_entries(std::string&                  json,
+                                  std::span<const std::uint8_t> data);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> collect_executables(const std::span<const char* const> paths)
+{
+	std::vector<std::string> executables = {};
+
+	for (const char* const path : paths)
+	{
+		if (!std::filesystem::is_directory(path))
+		{
+			executables.emplace_back(path);
+			continue;
+		}
+
+		const std::size_t first = executables.size();
+
+		for (const std::filesystem::directory_entry& entry :
+		     std::filesystem::recursive_directory_iterator{ path, std::filesystem::directory_options::skip_permission_denied })
+		{
+			std::error_code error = {};
+
+			if (entry.is_regular_file(error) && is_executable(entry.path()))
+			{
+				executables.push_back(entry.path().string());
+			}
+		}
+
+		std::sort(executables.begin() + static_cast<std::ptrdiff_t>(first), executables.end());
+	}
+
+	return executables;
+}
+
+std::string list_resources(const std::string_view file_path)
+{
+	std::string json = "{\"path\":";
+
+	append_json_string(json, file_path);
+
+	try
+	{
+		const mapped_file             file      = mapped_file{ file_path };
+		const pe_image::resource_view resources = pe_image::find_resources(file.get_bytes());
+		std::string                   entries   = {};
+
+		if (!resources.directory.empty())
+		{
+			resource_tree::visit(resources.directory, resources.rva,
+			                     [&entries](const resource_id& type, const resource_id& name, const std::uint16_t language, const std::span<const std::uint8_t> data,
+			                                std::uint32_t)
+			                     {
+				                     entries += entries.empty() ? "{\"type\":" : ",{\"type\":";
+				                     append_id(entries, type);
+				                     entries += ",\"name\":";
+				                     append_id(entries, name);
+				                     std::format_to(std::back_inserter(entries), ",\"language\":{},\"size\":{}", language, data.size());
+
+				                     if (!type.is_named() && static_cast<std::uint16_t>(resource_type::group_icon) == type.get_id())
+				                     {
+					                     append_icon_entries(entries, data);
+				                     }
+
+				                     if (!type.is_named() && static_cast<std::uint16_t>(resource_type::group_cursor) == type.get_id())
+				                     {
+					                     append_cursor_entries(entries, data);
+				                     }
+
+				                     entries += '}';
+			                     });
+		}
+
+		json += ",\"resources\":[";
+		json += entries;
+		json += "]}";
+	}
+	catch (const std::exception& exception)
+	{
+		json += ",\"error\":";
+		append_json_string(json, exception.what());
+		json += '}';
+	}
+
+	return json;
+}
+
+void list_resources_cli(const std::span<const char* const>     paths,
+                        const std::optional<shard_spec>& shard)
+{
+	std::vector<std::string> executables = collect_executables(paths);
+	std::mutex               output      = {};
+
+	if (shard.has_value())
+	{
+		std::vector<std::string> selected = {};
+
+		// Listing changes nothing, so the sizes on disk stay put during the run.
+		for (const std::size_t index : select_shard(executables, get_file_sizes(executables), *shard).indices)
+		{
+			selected.push_back(std::move(executables[index]));
+		}
+
+		executables = std::move(selected);
+	}
+
+	parallel_for(executables.size(),
+	             [&executables, &output](const std::size_t index)
+	             {
+		             std::string line = list_resources(executables[index]);
+
+		             line += '\n';
+
+		             const std::lock_guard lock = std::lock_guard{ output };
+
+		             std::fwrite(line.data(), 1, line.size(), stdout);
+	             });
+
+	std::fflush(stdout);
+}
+
+static bool is_executable(const std::filesystem::path& path)
+{
+	std::string extension = path.extension().string();
+
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](const char character)
+	{
+		return 'A' <= character && 'Z' >= character ? static_cast<char>(character - 'A' + 'a') : character;
+	});
+
+	return EXECUTABLE_EXTENSIONS.end() != std::find(EXECUTABLE_EXTENSIONS.begin(), EXECUTABLE_EXTENSIONS.end(), extension);
+}
+
+static void append_id(std::string&       json,
+                      const resource_id& id)
+{
+	if (id.is_named())
+	{
+		append_json_string(json, id.to_string());
+		return;
+	}
+
+	std::format_to(std::back_inserter(json), "{}", id.get_id());
+}
+
+static void append_icon_entries(std::string&                        json,
+                                const std::span<const std::uint8_t> data)
+{
+	icon::header header = {};
+
+	if (data.size() < sizeof(header))
+	{
+		json += ",\"icons\":null";
+		return;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	// Entries cut off by a truncated resource are left out.
+	const std::size_t count = std::min<std::size_t>(header.entries_count, (data.size() - sizeof(header)) / sizeof(icon::entry));
+
+	json += ",\"icons\":[";
+
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		icon::entry entry = {};
+
+		std::memcpy(&entry, data.data() + sizeof(header) + index * sizeof(entry), sizeof(entry));
+		std::format_to(std::back_inserter(json), "{}{{\"id\":{},\"width\":{},\"height\":{},\"color_count\":{},\"planes\":{},\"bit_count\":{},\"size\":{}}}",
+		               0 == index ? "" : ",", entry.icon_id, 0 == entry.width ? 256 : entry.width, 0 == entry.height ? 256 : entry.height, entry.color_count,
+		               entry.planes, entry.bit_count, entry.resource_size);
+	}
+
+	json += ']';
+}
+
+static void append_cursor_entries(std::string&                        json,
+                                  const std::span<const std::uint8_t> data)
+{
+	icon::header header = {};
+
+	if (data.size() < sizeof(header))
+	{
+		json += ",\"cursors\":null";
+		return;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	const std::size_t count = std::min<std::size_t>(header.entries_count, (data.size() - sizeof(header)) / sizeof(icon::cursor_entry));
+
+	json += ",\"cursors\":[";
+
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		icon::cursor_entry entry = {};
+
+		std::memcpy(&entry, data.data() + sizeof(header) + index * sizeof(entry), sizeof(entry));
+		std::format_to(std::back_inserter(json), "{}{{\"id\":{},\"width\":{},\"height\":{},\"planes\":{},\"bit_count\":{},\"size\":{}}}", 0 == index ? "" : ",",
+		               entry.cursor_id, entry.width, entry.height, entry.planes, entry.bit_count, entry.resource_size);
+	}
+
+	json += ']';
+}
+
+} // namespace icon_changer
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shard.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Expands the paths given on the command line into executables.
+/// \details Files are taken as they are, directories are searched recursively
+/// for PE files (.exe, .dll, ...), sorted to keep the output stable.
+/// \param paths: The files and directories.
+/// \returns The paths of the executables.
+///
+extern std::vector<std::string> collect_executables(std::span<const char* const> paths);
+
+///
+/// \brief Describes the resources of an executable as a JSON object.
+/// \details The file is memory mapped and its resource directory is walked in
+/// place. Failures are reported in an "error" member instead of being thrown.
+/// \param file_path: The path to the executable.
+/// \returns One line of JSON, without the line feed.
+///
+extern std::string list_resources(std::string_view file_path);
+
+///
+/// \brief CLI entry point for `--list`.
+/// \details Prints one JSON line per executable, in the order they finish,
+/// inspecting the executables on all hardware threads.
+/// \param paths: The files and directories to be inspected.
+/// \param shard: The part of the executables inspected here, all if none.
+///
+extern void list_resources_cli(std::span<const char* const>     paths,
+                               const std::optional<shard_spec>& shard);
+
+} // namespace icon_changer
@@ -0,0 +1,732 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "resource_tree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+///
+/// \brief This data structure corresponds to IMAGE_RESOURCE_DIRECTORY.
+///
+struct resource_directory
+{
+	std::uint32_t characteristics;    ///< Reserved, must be 0.
+	std::uint32_t time_date_stamp;    ///< Creation time, always written as 0.
+	std::uint16_t major_version;      ///< Major version, always written as 0.
+	std::uint16_t minor_version;      ///< Minor version, always written as 0.
+	std::uint16_t named_entries_count; ///< Number of entries identified by string.
+	std::uint16_t id_entries_count;    ///< Number of entries identified by ordinal.
+};
+
+///
+/// \brief This data structure corresponds to IMAGE_RESOURCE_DIRECTORY_ENTRY.
+///
+struct resource_directory_entry
+{
+	std::uint32_t name;   ///< Ordinal, or string offset if the high bit is set.
+	std::uint32_t offset; ///< Data entry offset, or subdirectory offset if the high bit is set.
+};
+
+///
+/// \brief This data structure corresponds to IMAGE_RESOURCE_DATA_ENTRY.
+///
+struct resource_data_entry
+{
+	std::uint32_t data_rva;  ///< RVA of the resource bytes.
+	std::uint32_t size;      ///< Size of the resource in bytes.
+	std::uint32_t code_page; ///< Code page used to decode code points.
+	std::uint32_t reserved;  ///< Reserved, must be 0.
+};
+
+#pragma pack(pop)
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief High bit of the directory entry fields (string name or subdirectory).
+///
+static constexpr std::uint32_t HIGH_BIT = 0x80000000;
+
+///
+/// \brief Alignment of every resource in the serialized section.
+///
+static constexpr std::uint32_t DATA_ALIGNMENT = 8;
+
+///
+/// \brief Stack space for the bookkeeping of serialize(), enough for the
+/// directories of a typical executable without touching the heap.
+///
+static constexpr std::size_t SCRATCH_SIZE = 4096;
+
+///
+/// \brief Rounds a value up to the next multiple of the alignment.
+/// \param value: The value to be aligned.
+/// \param alignment: The alignment, must be a power of two.
+/// \returns The aligned value.
+///
+static constexpr std::uint32_t align_up(std::uint32_t value,
+                                        std::uint32_t alignment) noexcept;
+
+///
+/// \brief Reads a packed structure after checking it is in bounds.
+/// \param bytes: The resource directory bytes.
+/// \param offset: The offset of the structure.
+/// \returns The structure.
+///
+template<typename T>
+static T read_struct(std::span<const std::uint8_t> bytes,
+                     std::size_t                   offset);
+
+///
+/// \brief Writes a packed structure into a preallocated buffer.
+/// \param bytes: The section bytes.
+/// \param offset: The offset of the structure.
+/// \param value: The structure.
+///
+template<typename T>
+static void write_struct(std::span<std::uint8_t> bytes,
+                         std::size_t             offset,
+                         const T&                value) noexcept;
+
+///
+/// \brief Decodes the name field of a directory entry.
+/// \param bytes: The resource directory bytes.
+/// \param name: The name field of the directory entry.
+/// \returns The ordinal or the string read from the string table.
+///
+static resource_id read_id(std::span<const std::uint8_t> bytes,
+                           std::uint32_t                 name);
+
+///
+/// \brief Counts the entries of a directory at the given offset.
+/// \param bytes: The resource directory bytes.
+/// \param offset: The offset of the IMAGE_RESOURCE_DIRECTORY.
+/// \returns The number of entries, which are all inside the bytes.
+///
+static std::size_t count_entries(std::span<const std::uint8_t> bytes,
+                                 std::uint32_t                 offset);
+
+///
+/// \brief Reads an entry of a directory checked by count_entries().
+/// \param bytes: The resource directory bytes.
+/// \param offset: The offset of the IMAGE_RESOURCE_DIRECTORY.
+/// \param index: The index of the entry.
+/// \returns The directory entry.
+///
+static resource_directory_entry read_entry(std::span<const std::uint8_t> bytes,
+                                           std::uint32_t                 offset,
+                                           std::size_t                   index) noexcept;
+
+///
+/// \brief Computes the offset of the subdirectory of an entry.
+/// \param entry: The directory entry.
+/// \returns The subdirectory offset.
+///
+static std::uint32_t get_subdirectory(const resource_directory_entry& entry);
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+resource_id::resource_id(const std::uint16_t id) noexcept
+    : id{ id }
+    , name{}
+{
+}
+
+resource_id::resource_id(const resource_type type) noexcept
+    : id{ static_cast<std::uint16_t>(type) }
+    , name{}
+{
+}
+
+resource_id::resource_id(std::u16string name)
+    : id{ 0 }
+    , name{ std::move(name) }
+{
+	if (this->name.empty())
+	{
+		throw std::invalid_argument{ "Resource name must not be empty!" };
+	}
+}
+
+resource_id::resource_id(const std::string_view name)
+    : resource_id{ std::u16string{ name.begin(), name.end() } }
+{
+}
+
+resource_id::resource_id(const char* const name)
+    : resource_id{ std::string_view{ name } }
+{
+}
+
+bool resource_id::is_named() const noexcept
+{
+	return !name.empty();
+}
+
+std::uint16_t resource_id::get_id() const noexcept
+{
+	return id;
+}
+
+const std::u16string& resource_id::get_name() const noexcept
+{
+	return name;
+}
+
+std::string resource_id::to_string() const
+{
+	std::string text = {};
+
+	if (!is_named())
+	{
+		return std::format("{}", id);
+	}
+
+	for (const char16_t character : name)
+	{
+		text.push_back(0x20 <= character && 0x7F > character ? static_cast<char>(character) : '?');
+	}
+
+	return text;
+}
+
+std::strong_ordering resource_id::operator<=>(const resource_id& other) const noexcept
+{
+	static constexpr auto to_upper = [](const char16_t character)
+	{
+		return u'a' <= character && u'z' >= character ? static_cast<char16_t>(character - u'a' + u'A') : character;
+	};
+
+	if (is_named() != other.is_named())
+	{
+		return is_named() ? std::strong_ordering::less : std::strong_ordering::greater;
+	}
+
+	if (!is_named())
+	{
+		return id <=> other.id;
+	}
+
+	for (std::size_t index = 0; index < name.size() && index < other.name.size(); ++index)
+	{
+		const std::strong_ordering order = to_upper(name[index]) <=> to_upper(other.name[index]);
+
+		if (std::strong_ordering::equal != order)
+		{
+			return order;
+		}
+	}
+
+	return name.size() <=> other.name.size();
+}
+
+bool resource_id::operator==(const resource_id& other) const noexcept
+{
+	return std::strong_ordering::equal == (*this <=> other);
+}
+
+resource_tree::leaf::leaf(const allocator_type& allocator)
+    : data{ allocator }
+    , code_page{ 0 }
+    , range{}
+{
+}
+
+resource_tree::leaf::leaf(const leaf& other, const allocator_type& allocator)
+    : data{ other.data, allocator }
+    , code_page{ other.code_page }
+    , range{ other.range }
+{
+}
+
+resource_tree::leaf::leaf(leaf&& other, const allocator_type& allocator)
+    : data{ std::move(other.data), allocator }
+    , code_page{ other.code_page }
+    , range{ std::move(other.range) }
+{
+}
+
+resource_tree::resource_tree(std::pmr::memory_resource* const resource)
+    : types{ resource }
+{
+}
+
+resource_tree resource_tree::parse(const std::span<const std::uint8_t> directory,
+                                   const std::uint32_t                 directory_rva,
+                                   std::pmr::memory_resource* const    resource)
+{
+	resource_tree tree = resource_tree{ resource };
+
+	visit(directory, directory_rva,
+	      [&tree](const resource_id& type, const resource_id& name, const std::uint16_t language, const std::span<const std::uint8_t> data, const std::uint32_t code_page)
+	      {
+		      leaf& leaf = tree.types[type][name][language];
+
+		      leaf.data.assign(data.begin(), data.end());
+		      leaf.code_page = code_page;
+	      });
+
+	return tree;
+}
+
+std::span<const std::uint8_t> resource_tree::leaf::get_bytes() const
+{
+	return range.has_value() ? range->get_bytes() : std::span<const std::uint8_t>(data);
+}
+
+void resource_tree::visit(const std::span<const std::uint8_t> directory,
+                          const std::uint32_t                 directory_rva,
+                          const visitor&                      visitor)
+{
+	const std::size_t       types_count = count_entries(directory, 0);
+	std::set<std::uint32_t> visited     = { 0 };
+
+	// Every subdirectory is walked once, so a crafted directory pointing many
+	// entries at the same subdirectory cannot multiply the resources visited.
+	const auto enter = [&visited](const std::uint32_t offset)
+	{
+		if (!visited.insert(offset).second)
+		{
+			throw std::runtime_error{ std::format("Resource directory at offset 0x{:X} is referenced more than once!", offset) };
+		}
+
+		return offset;
+	};
+
+	for (std::size_t type_index = 0; type_index < types_count; ++type_index)
+	{
+		const resource_directory_entry type_entry  = read_entry(directory, 0, type_index);
+		const resource_id              type        = read_id(directory, type_entry.name);
+		const std::uint32_t            names       = enter(get_subdirectory(type_entry));
+		const std::size_t              names_count = count_entries(directory, names);
+
+		for (std::size_t name_index = 0; name_index < names_count; ++name_index)
+		{
+			const resource_directory_entry name_entry      = read_entry(directory, names, name_index);
+			const resource_id              name            = read_id(directory, name_entry.name);
+			const std::uint32_t            languages       = enter(get_subdirectory(name_entry));
+			const std::size_t              languages_count = count_entries(directory, languages);
+
+			for (std::size_t language_index = 0; language_index < languages_count; ++language_index)
+			{
+				const resource_directory_entry language_entry = read_entry(directory, languages, language_index);
+
+				if (0 != (HIGH_BIT & (language_entry.name | language_entry.offset)))
+				{
+					throw std::runtime_error{ "Resource directory is deeper than 3 levels!" };
+				}
+
+				const resource_data_entry data_entry = read_struct<resource_data_entry>(directory, language_entry.offset);
+
+				if (directory_rva > data_entry.data_rva || directory.size() < data_entry.data_rva - directory_rva ||
+				    directory.size() - (data_entry.data_rva - directory_rva) < data_entry.size)
+				{
+					throw std::runtime_error{ std::format("Resource {}/{}/{} data is out of bounds!", type.to_string(), name.to_string(), language_entry.name) };
+				}
+
+				visitor(type, name, static_cast<std::uint16_t>(language_entry.name), directory.subspan(data_entry.data_rva - directory_rva, data_entry.size),
+				        data_entry.code_page);
+			}
+		}
+	}
+}
+
+void resource_tree::set(const resource_id&        type,
+                        const resource_id&        name,
+                        const std::uint16_t       language,
+                        std::vector<std::uint8_t> data)
+{
+	leaf& leaf = types[type][name][language];
+
+	leaf.data.assign(data.begin(), data.end());
+	leaf.code_page = 0;
+	leaf.range.reset();
+}
+
+void resource_tree::set_range(const resource_id&  type,
+                              const resource_id&  name,
+                              const std::uint16_t language,
+                              file_range          range)
+{
+	leaf& leaf = types[type][name][language];
+
+	leaf.data.clear();
+	leaf.code_page = 0;
+	leaf.range     = std::move(range);
+}
+
+void resource_tree::merge(const resource_tree& other)
+{
+	for (const auto& [type, names] : other.types)
+	{
+		for (const auto& [name, languages] : names)
+		{
+			for (const auto& [language, leaf] : languages)
+			{
+				types[type][name][language] = leaf;
+			}
+		}
+	}
+}
+
+const resource_tree::leaf* resource_tree::find(const resource_id&  type,
+                                               const resource_id&  name,
+                                               const std::uint16_t language) const
+{
+	const type_map::const_iterator type_iterator = types.find(type);
+
+	if (types.end() == type_iterator)
+	{
+		return nullptr;
+	}
+
+	const name_map::const_iterator name_iterator = type_iterator->second.find(name);
+
+	if (type_iterator->second.end() == name_iterator)
+	{
+		return nullptr;
+	}
+
+	const language_map::const_iterator language_iterator = name_iterator->second.find(language);
+
+	return name_iterator->second.end() == language_iterator ? nullptr : &language_iterator->second;
+}
+
+void resource_tree::for_each(const leaf_visitor& visitor) const
+{
+	for (const auto& [type, names] : types)
+	{
+		for (const auto& [name, languages] : names)
+		{
+			for (const auto& [language, leaf] : languages)
+			{
+				visitor(type, name, language, leaf);
+			}
+		}
+	}
+}
+
+std::size_t resource_tree::size() const noexcept
+{
+	std::size_t count = 0;
+
+	for (const auto& [type, names] : types)
+	{
+		for (const auto& [name, languages] : names)
+		{
+			count += languages.size();
+		}
+	}
+
+	return count;
+}
+
+std::uint32_t resource_tree::get_serialized_size() const
+{
+	return compute_layout().size;
+}
+
+std::vector<std::uint8_t> resource_tree::serialize(const std::uint32_t             section_rva,
+                                                   std::pmr::vector<splice>* const splices) const
+{
+	std::vector<std::uint8_t> bytes = std::vector<std::uint8_t>(get_serialized_size());
+
+	serialize(bytes, section_rva, splices);
+
+	return bytes;
+}
+
+void resource_tree::serialize(const std::span<std::uint8_t>   bytes,
+                              const std::uint32_t             section_rva,
+                              std::pmr::vector<splice>* const splices) const
+{
+	std::array<std::byte, SCRATCH_SIZE>                 buffer         = {};
+	std::pmr::monotonic_buffer_resource                 scratch        = std::pmr::monotonic_buffer_resource{ buffer.data(), buffer.size() };
+	const layout                                        layout         = compute_layout();
+	std::pmr::map<std::u16string_view, std::uint32_t>   string_offsets = std::pmr::map<std::u16string_view, std::uint32_t>{ &scratch };
+	std::pmr::vector<std::uint32_t>                     name_dirs      = std::pmr::vector<std::uint32_t>{ &scratch };
+	std::pmr::vector<std::uint32_t>                     language_dirs  = std::pmr::vector<std::uint32_t>{ &scratch };
+	std::uint32_t                                       next_directory = sizeof(resource_directory) + static_cast<std::uint32_t>(types.size() * sizeof(resource_directory_entry));
+	std::uint32_t                                       string_offset  = layout.strings_offset;
+	std::uint32_t                                       data_entry     = layout.data_entries_offset;
+	std::uint32_t                                       data_offset    = layout.data_offset;
+	std::size_t                                         language_index = 0;
+
+	if (bytes.size() < layout.size)
+	{
+		throw std::logic_error{ std::format("Resource section needs {} bytes, got {}!", layout.size, bytes.size()) };
+	}
+
+	std::ranges::fill(bytes, 0x00);
+
+	const auto write_string = [&](const resource_id& id) -> std::uint32_t
+	{
+		if (!id.is_named())
+		{
+			return id.get_id();
+		}
+
+		const auto [iterator, inserted] = string_offsets.try_emplace(std::u16string_view{ id.get_name() }, string_offset);
+
+		if (inserted)
+		{
+			write_struct(bytes, string_offset, static_cast<std::uint16_t>(id.get_name().size()));
+			std::memcpy(&bytes[string_offset + sizeof(std::uint16_t)], id.get_name().data(), id.get_name().size() * sizeof(char16_t));
+			string_offset += sizeof(std::uint16_t) + static_cast<std::uint32_t>(id.get_name().size() * sizeof(char16_t));
+		}
+
+		return HIGH_BIT | iterator->second;
+	};
+
+	const auto write_directory = [&](const std::uint32_t offset,
+	                                 const auto&         children)
+	{
+		resource_directory header = {};
+
+		for (const auto& [id, child] : children)
+		{
+			if constexpr (std::is_same_v<std::remove_cvref_t<decltype(id)>, resource_id>)
+			{
+				++(id.is_named() ? header.named_entries_count : header.id_entries_count);
+			}
+			else
+			{
+				++header.id_entries_count;
+			}
+		}
+
+		write_struct(bytes, offset, header);
+	};
+
+	// Directories are laid out breadth first: the root, then every name
+	// directory, then every language directory, all in sorted order.
+	for (const auto& [type, names] : types)
+	{
+		name_dirs.push_back(next_directory);
+		next_directory += sizeof(resource_directory) + static_cast<std::uint32_t>(names.size() * sizeof(resource_directory_entry));
+	}
+
+	for (const auto& [type, names] : types)
+	{
+		for (const auto& [name, languages] : names)
+		{
+			language_dirs.push_back(next_directory);
+			next_directory += sizeof(resource_directory) + static_cast<std::uint32_t>(languages.size() * sizeof(resource_directory_entry));
+		}
+	}
+
+	write_directory(0, types);
+
+	std::uint32_t type_entry = sizeof(resource_directory);
+
+	for (std::size_t type_index = 0; const auto& [type, names] : types)
+	{
+		write_struct(bytes, type_entry, resource_directory_entry{ write_string(type), HIGH_BIT | name_dirs[type_index] });
+		write_directory(name_dirs[type_index], names);
+		type_entry += sizeof(resource_directory_entry);
+
+		std::uint32_t name_entry = name_dirs[type_index++] + sizeof(resource_directory);
+
+		for (const auto& [name, languages] : names)
+		{
+			write_struct(bytes, name_entry, resource_directory_entry{ write_string(name), HIGH_BIT | language_dirs[language_index] });
+			write_directory(language_dirs[language_index], languages);
+			name_entry += sizeof(resource_directory_entry);
+
+			std::uint32_t language_entry = language_dirs[language_index++] + sizeof(resource_directory);
+
+			for (const auto& [language, leaf] : languages)
+			{
+				const std::uint32_t size = leaf.range.has_value() ? leaf.range->size : static_cast<std::uint32_t>(leaf.data.size());
+
+				write_struct(bytes, language_entry, resource_directory_entry{ language, data_entry });
+				write_struct(bytes, data_entry, resource_data_entry{ section_rva + data_offset, size, leaf.code_page, 0 });
+
+				if (leaf.range.has_value() && 0 != size && nullptr != splices)
+				{
+					splices->push_back({ data_offset, *leaf.range });
+				}
+				else
+				{
+					std::memcpy(&bytes[data_offset], leaf.get_bytes().data(), size);
+				}
+
+				language_entry += sizeof(resource_directory_entry);
+				data_entry += sizeof(resource_data_entry);
+				data_offset = align_up(data_offset + size, DATA_ALIGNMENT);
+			}
+		}
+	}
+}
+
+resource_tree::layout resource_tree::compute_layout() const
+{
+	std::array<std::byte, SCRATCH_SIZE>           buffer      = {};
+	std::pmr::monotonic_buffer_resource           scratch     = std::pmr::monotonic_buffer_resource{ buffer.data(), buffer.size() };
+	std::pmr::set<std::u16string_view>            strings     = std::pmr::set<std::u16string_view>{ &scratch };
+	std::uint64_t                                 directories = sizeof(resource_directory) + types.size() * sizeof(resource_directory_entry);
+	std::uint64_t                                 leaves      = 0;
+	std::uint64_t                                 string_size = 0;
+	std::uint64_t                                 data_size   = 0;
+
+	const auto add_string = [&](const resource_id& id)
+	{
+		if (id.is_named() && strings.insert(std::u16string_view{ id.get_name() }).second)
+		{
+			string_size += sizeof(std::uint16_t) + id.get_name().size() * sizeof(char16_t);
+		}
+	};
+
+	for (const auto& [type, names] : types)
+	{
+		add_string(type);
+		directories += sizeof(resource_directory) + names.size() * sizeof(resource_directory_entry);
+
+		for (const auto& [name, languages] : names)
+		{
+			add_string(name);
+			directories += sizeof(resource_directory) + languages.size() * sizeof(resource_directory_entry);
+			leaves += languages.size();
+
+			for (const auto& [language, leaf] : languages)
+			{
+				data_size += align_up(leaf.range.has_value() ? leaf.range->size : static_cast<std::uint32_t>(leaf.data.size()), DATA_ALIGNMENT);
+			}
+		}
+	}
+
+	const std::uint64_t strings_offset = directories + leaves * sizeof(resource_data_entry);
+	const std::uint64_t data_offset    = align_up(static_cast<std::uint32_t>(strings_offset + string_size), DATA_ALIGNMENT);
+
+	if (UINT32_MAX < data_offset + data_size)
+	{
+		throw std::length_error{ "Resource section would exceed 4 GiB!" };
+	}
+
+	return { static_cast<std::uint32_t>(directories), static_cast<std::uint32_t>(strings_offset), static_cast<std::uint32_t>(data_offset),
+		     static_cast<std::uint32_t>(data_offset + data_size) };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr std::uint32_t align_up(const std::uint32_t value,
+                                        const std::uint32_t alignment) noexcept
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+template<typename T>
+static T read_struct(const std::span<const std::uint8_t> bytes,
+                     const std::size_t                   offset)
+{
+	T value = {};
+
+	if (bytes.size() < offset || bytes.size() - offset < sizeof(T))
+	{
+		throw std::runtime_error{ std::format("Resource directory is truncated at offset 0x{:X}!", offset) };
+	}
+
+	std::memcpy(&value, bytes.data() + offset, sizeof(T));
+	return value;
+}
+
+template<typename T>
+static void write_struct(const std::span<std::uint8_t> bytes,
+                         const std::size_t             offset,
+                         const T&                      value) noexcept
+{
+	std::memcpy(&bytes[offset], &value, sizeof(T));
+}
+
+static resource_id read_id(const std::span<const std::uint8_t> bytes,
+                           const std::uint32_t                 name)
+{
+	if (0 == (HIGH_BIT & name))
+	{
+		return { static_cast<std::uint16_t>(name) };
+	}
+
+	const std::uint32_t offset = name & ~HIGH_BIT;
+	const std::uint16_t length = read_struct<std::uint16_t>(bytes, offset);
+	std::u16string      string = std::u16string(length, u'\0');
+
+	if (bytes.size() - offset - sizeof(std::uint16_t) < length * sizeof(char16_t))
+	{
+		throw std::runtime_error{ std::format("Resource name at offset 0x{:X} is truncated!", offset) };
+	}
+
+	std::memcpy(string.data(), bytes.data() + offset + sizeof(std::uint16_t), length * sizeof(char16_t));
+	return { std::move(string) };
+}
+
+static std::size_t count_entries(const std::span<const std::uint8_t> bytes,
+                                 const std::uint32_t                 offset)
+{
+	const resource_directory header = read_struct<resource_directory>(bytes, offset);
+	const std::size_t        count  = header.named_entries_count + header.id_entries_count;
+
+	if ((bytes.size() - offset - sizeof(resource_directory)) / sizeof(resource_directory_entry) < count)
+	{
+		throw std::runtime_error{ std::format("Resource directory at offset 0x{:X} has too many entries!", offset) };
+	}
+
+	return count;
+}
+
+static resource_directory_entry read_entry(const std::span<const std::uint8_t> bytes,
+                                           const std::uint32_t                 offset,
+                                           const std::size_t                   index) noexcept
+{
+	resource_directory_entry entry = {};
+
+	std::memcpy(&entry, bytes.data() + offset + sizeof(resource_directory) + index * sizeof(entry), sizeof(entry));
+
+	return entry;
+}
+
+static std::uint32_t get_subdirectory(const resource_directory_entry& entry)
+{
+	if (0 == (HIGH_BIT & entry.offset))
+	{
+		throw std::runtime_error{ "Resource directory is shallower than 3 levels!" };
+	}
+
+	return entry.offset & ~HIGH_BIT;
+}
+
+} // namespace icon_changer
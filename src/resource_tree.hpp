@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Predefined resource types used by icon-changer.
+/// \see https://learn.microsoft.com/en-us/windows/win32/menurc/resource-types
+///
+enum class resource_type : std::uint16_t
+{
+	cursor          = 1,  ///< RT_CURSOR, hardware-dependent cursor resource.
+	icon            = 3,  ///< RT_ICON, hardware-dependent icon resource.
+	group_cursor    = 12, ///< RT_GROUP_CURSOR, hardware-independent cursor resource.
+	group_icon      = 14, ///< RT_GROUP_ICON, hardware-independent icon resource.
+	animated_cursor = 21, ///< RT_ANICURSOR, animated cursor resource (an ANI file).
+	animated_icon   = 22, ///< RT_ANIICON, animated icon resource (an ANI file).
+};
+
+///
+/// \brief Identifies a resource type, name or language by ordinal or by string.
+/// \details Ordering follows the PE specification: named entries come first,
+/// sorted case-insensitively, followed by ordinals in ascending order.
+///
+class resource_id final
+{
+public:
+	///
+	/// \brief Constructs an ordinal identifier.
+	/// \param id: The 16-bit ordinal.
+	///
+	resource_id(std::uint16_t id) noexcept;
+
+	///
+	/// \brief Constructs an identifier from a predefined resource type.
+	/// \param type: The resource type.
+	///
+	resource_id(resource_type type) noexcept;
+
+	///
+	/// \brief Constructs a named identifier.
+	/// \param name: The UTF-16 name, as stored in the resource directory.
+	///
+	resource_id(std::u16string name);
+
+	///
+	/// \brief Constructs a named identifier from an ASCII string (e.g. "MAINICON").
+	/// \param name: The ASCII name.
+	///
+	resource_id(std::string_view name);
+
+	///
+	/// \brief Constructs a named identifier from an ASCII string literal.
+	/// \param name: The null terminated ASCII name.
+	///
+	resource_id(const char* name);
+
+	///
+	/// \brief Checks whether the identifier is a string.
+	/// \returns true if named, false if ordinal.
+	///
+	[[nodiscard]] bool is_named() const noexcept;
+
+	///
+	/// \brief Gets the ordinal value.
+	/// \returns The ordinal, 0 for named identifiers.
+	///
+	[[nodiscard]] std::uint16_t get_id() const noexcept;
+
+	///
+	/// \brief Gets the string value.
+	/// \returns The UTF-16 name, empty for ordinal identifiers.
+	///
+	[[nodiscard]] const std::u16string& get_name() const noexcept;
+
+	///
+	/// \brief Formats the identifier for humans, ordinals in decimal.
+	/// \returns The identifier as a narrow string (non-ASCII replaced by '?').
+	///
+	[[nodiscard]] std::string to_string() const;
+
+	std::strong_ordering operator<=>(const resource_id& other) const noexcept;
+
+	bool operator==(const resource_id& other) const noexcept;
+
+private:
+	std::uint16_t  id;   ///< Ordinal value, meaningful when name is empty.
+	std::u16string name; ///< String value, meaningful when not empty.
+};
+
+///
+/// \brief In-memory model of a PE resource section (.rsrc).
+/// \details Resources are keyed by type, name and language like the three
+/// levels of the resource directory. Serialization is deterministic: entries
+/// are sorted, time stamps are zero, padding is zero and the data layout only
+/// depends on the contents, so equal trees always produce equal bytes.
+/// The directories and the resource bytes are allocated from the memory
+/// resource of the tree, so a tree parsed per job can live in a per-job arena.
+/// \see https://learn.microsoft.com/en-us/windows/win32/debug/pe-format#the-rsrc-section
+///
+class resource_tree final
+{
+public:
+	///
+	/// \brief Language identifier used for language neutral resources.
+	///
+	static constexpr std::uint16_t NEUTRAL_LANGUAGE = 0x0000;
+
+	///
+	/// \brief A single resource (leaf of the resource directory).
+	///
+	struct leaf final
+	{
+		using allocator_type = std::pmr::polymorphic_allocator<std::uint8_t>;
+
+		std::pmr::vector<std::uint8_t> data;      ///< The raw resource bytes.
+		std::uint32_t                  code_page; ///< Code page of the data, usually 0.
+		std::optional<file_range>      range;     ///< The bytes left in a mapped file, data is empty when set.
+
+		///
+		/// \brief Constructor to create an empty resource.
+		/// \param allocator: Where the bytes are allocated, the one of the
+		/// tree when the leaf is created by the tree.
+		///
+		explicit leaf(const allocator_type& allocator = {});
+
+		///
+		/// \brief Constructor to copy a resource into another tree.
+		/// \param other: The resource.
+		/// \param allocator: Where the bytes are allocated.
+		///
+		leaf(const leaf& other, const allocator_type& allocator);
+
+		///
+		/// \brief Constructor to move a resource into another tree.
+		/// \param other: The resource.
+		/// \param allocator: Where the bytes are allocated.
+		///
+		leaf(leaf&& other, const allocator_type& allocator);
+
+		leaf(const leaf&) = default;
+
+		leaf(leaf&&) = default;
+
+		leaf& operator=(const leaf&) = default;
+
+		leaf& operator=(leaf&&) = default;
+
+		///
+		/// \brief Gets the resource bytes, wherever they are.
+		/// \returns The bytes of data or of range.
+		///
+		[[nodiscard]] std::span<const std::uint8_t> get_bytes() const;
+	};
+
+	///
+	/// \brief A resource whose bytes serialize() did not copy.
+	///
+	struct splice final
+	{
+		std::uint32_t offset; ///< Offset of the resource in the serialized section.
+		file_range    range;  ///< Where the bytes are.
+	};
+
+	///
+	/// \brief Callback receiving a resource without copying it.
+	/// \details Parameters: type, name, language, data and code page. The data
+	/// points into the directory passed to visit().
+	///
+	using visitor = std::function<void(const resource_id&, const resource_id&, std::uint16_t, std::span<const std::uint8_t>, std::uint32_t)>;
+
+	///
+	/// \brief Callback receiving a resource of a tree.
+	/// \details Parameters: type, name, language and the resource.
+	///
+	using leaf_visitor = std::function<void(const resource_id&, const resource_id&, std::uint16_t, const leaf&)>;
+
+public:
+	///
+	/// \brief Constructs an empty resource tree.
+	///
+	resource_tree() = default;
+
+	///
+	/// \brief Constructs an empty resource tree allocating from a memory resource.
+	/// \param resource: Where the directories and the resource bytes are
+	/// allocated, it must outlive the tree.
+	///
+	explicit resource_tree(std::pmr::memory_resource* resource);
+
+	///
+	/// \brief Parses an existing resource directory.
+	/// \param directory: The bytes starting at the root resource directory.
+	/// \param directory_rva: The RVA of the root directory, used to resolve
+	/// the RVAs of the data entries.
+	/// \param resource: Where the tree is allocated.
+	/// \returns The parsed tree, with every resource copied.
+	///
+	static resource_tree parse(std::span<const std::uint8_t> directory,
+	                           std::uint32_t                 directory_rva,
+	                           std::pmr::memory_resource*    resource = std::pmr::get_default_resource());
+
+	///
+	/// \brief Walks an existing resource directory without building a tree.
+	/// \details Resources are visited in directory order and their data is not
+	/// copied, which makes inspecting many executables cheap. Subdirectories
+	/// referenced more than once are rejected, so the walk stays linear in
+	/// the size of the directory.
+	/// \param directory: The bytes starting at the root resource directory.
+	/// \param directory_rva: The RVA of the root directory.
+	/// \param visitor: Called once for every resource.
+	///
+	static void visit(std::span<const std::uint8_t> directory,
+	                  std::uint32_t                 directory_rva,
+	                  const visitor&                visitor);
+
+	///
+	/// \brief Adds a resource, replacing the one with the same type, name and
+	/// language if present.
+	/// \param type: The resource type.
+	/// \param name: The resource name.
+	/// \param language: The resource language.
+	/// \param data: The resource bytes.
+	///
+	void set(const resource_id&        type,
+	         const resource_id&        name,
+	         std::uint16_t             language,
+	         std::vector<std::uint8_t> data);
+
+	///
+	/// \brief Adds a resource whose bytes stay in a mapped file.
+	/// \details The bytes are only read when serialized, and not even then if
+	/// the caller splices them (see serialize()).
+	/// \param type: The resource type.
+	/// \param name: The resource name.
+	/// \param language: The resource language.
+	/// \param range: The resource bytes.
+	///
+	void set_range(const resource_id& type,
+	               const resource_id& name,
+	               std::uint16_t      language,
+	               file_range         range);
+
+	///
+	/// \brief Adds every resource of another tree, replacing the ones with the
+	/// same type, name and language.
+	/// \details Resources added as file ranges only share their mapping, so a
+	/// tree of mapped resources can be merged into many others cheaply.
+	/// \param other: The resources to be added.
+	///
+	void merge(const resource_tree& other);
+
+	///
+	/// \brief Looks up a resource.
+	/// \param type: The resource type.
+	/// \param name: The resource name.
+	/// \param language: The resource language.
+	/// \returns The resource, nullptr if it is not in the tree.
+	///
+	[[nodiscard]] const leaf* find(const resource_id& type,
+	                               const resource_id& name,
+	                               std::uint16_t      language) const;
+
+	///
+	/// \brief Walks the resources of the tree.
+	/// \details Resources are visited in directory order.
+	/// \param visitor: Called once for every resource.
+	///
+	void for_each(const leaf_visitor& visitor) const;
+
+	///
+	/// \brief Counts the resources in the tree.
+	/// \returns The number of leaves.
+	///
+	[[nodiscard]] std::size_t size() const noexcept;
+
+	///
+	/// \brief Computes the size of the serialized section without serializing it.
+	/// \returns The number of bytes serialize() will return.
+	///
+	[[nodiscard]] std::uint32_t get_serialized_size() const;
+
+	///
+	/// \brief Serializes the tree into a resource section.
+	/// \details Layout: all directories breadth first, all data entries, all
+	/// name strings, then every resource aligned to 8 bytes.
+	/// Resources added as file ranges are copied from their mappings, unless
+	/// splices is given: then their bytes are left zero and reported, so the
+	/// writer can copy them from file to file.
+	/// \param section_rva: The RVA at which the bytes will be mapped.
+	/// \param splices: Receives the resources left out, can be nullptr.
+	/// \returns The section bytes, a multiple of 8 bytes long.
+	///
+	[[nodiscard]] std::vector<std::uint8_t> serialize(std::uint32_t             section_rva,
+	                                                  std::pmr::vector<splice>* splices = nullptr) const;
+
+	///
+	/// \brief Serializes the tree into a buffer, see serialize().
+	/// \details Nothing is allocated for the section itself, so it can be
+	/// written straight into the image.
+	/// \param output: Receives the section, get_serialized_size() bytes long.
+	/// \param section_rva: The RVA at which the bytes will be mapped.
+	/// \param splices: Receives the resources left out, can be nullptr.
+	///
+	void serialize(std::span<std::uint8_t>   output,
+	               std::uint32_t             section_rva,
+	               std::pmr::vector<splice>* splices = nullptr) const;
+
+private:
+	///
+	/// \brief Offsets of the serialized tree regions, relative to its start.
+	///
+	struct layout final
+	{
+		std::uint32_t data_entries_offset; ///< Offset of the first IMAGE_RESOURCE_DATA_ENTRY.
+		std::uint32_t strings_offset;      ///< Offset of the first IMAGE_RESOURCE_DIR_STRING_U.
+		std::uint32_t data_offset;         ///< Offset of the first resource.
+		std::uint32_t size;                ///< Total size in bytes.
+	};
+
+	using language_map = std::pmr::map<std::uint16_t, leaf>;
+	using name_map     = std::pmr::map<resource_id, language_map>;
+	using type_map     = std::pmr::map<resource_id, name_map>;
+
+private:
+	///
+	/// \brief Computes the region offsets of the serialized tree.
+	/// \returns The layout.
+	///
+	[[nodiscard]] layout compute_layout() const;
+
+private:
+	///
+	/// \brief The resources grouped by type, then by name, then by language.
+	///
+	type_map types;
+};
+
+} // namespace icon_changer
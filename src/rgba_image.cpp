@@ -0,0 +1,516 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rgba_image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "icon.hpp"
+#include "memory_budget.hpp"
+#include "png.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// STRUCT DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+///
+/// \brief This data structure corresponds to BITMAPINFOHEADER.
+///
+struct dib_header
+{
+	std::uint32_t size;               ///< Size of this structure, 40.
+	std::int32_t  width;              ///< Width in pixels.
+	std::int32_t  height;             ///< Height in pixels, doubled in ICO/CUR images.
+	std::uint16_t planes;             ///< Color planes, 1.
+	std::uint16_t bit_count;          ///< Bits per pixel.
+	std::uint32_t compression;        ///< BI_RGB (0) for uncompressed pixels.
+	std::uint32_t image_size;         ///< Size of the pixels and the mask in bytes.
+	std::int32_t  x_pixels_per_meter; ///< Horizontal resolution, unused.
+	std::int32_t  y_pixels_per_meter; ///< Vertical resolution, unused.
+	std::uint32_t colors_used;        ///< Palette size, 0 without palette.
+	std::uint32_t colors_important;   ///< Required palette entries, 0 for all.
+};
+
+///
+/// \brief This data structure corresponds to ICONDIRENTRY.
+///
+struct ico_directory_entry
+{
+	std::uint8_t  width;        ///< Image width in pixels, 0 means 256.
+	std::uint8_t  height;       ///< Image height in pixels, 0 means 256.
+	std::uint8_t  color_count;  ///< Number of colors in the color palette.
+	std::uint8_t  reserved;     ///< Reserved byte, must be 0.
+	std::uint16_t planes;       ///< Color planes.
+	std::uint16_t bit_count;    ///< Bits per pixel.
+	std::uint32_t image_size;   ///< Image data size in bytes.
+	std::uint32_t image_offset; ///< Offset of image data from the beginning of file.
+};
+
+#pragma pack(pop)
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief The source pixels that make up one target pixel along one axis.
+///
+struct contribution final
+{
+	std::uint32_t      first;   ///< The first source pixel.
+	std::vector<float> weights; ///< The normalized weights of the source pixels from first on.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief The largest size an ICO entry can describe.
+///
+static constexpr std::uint32_t MAX_ICO_SIZE = 256;
+
+///
+/// \brief Accepted BITMAPINFOHEADER sizes, from BITMAPINFOHEADER to BITMAPV5HEADER.
+///
+static constexpr std::uint32_t MIN_DIB_HEADER_SIZE = 40;
+static constexpr std::uint32_t MAX_DIB_HEADER_SIZE = 124;
+
+///
+/// \brief Uncompressed DIB pixels.
+///
+static constexpr std::uint32_t BI_RGB = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Computes the triangle filter weights for resampling one axis.
+/// \param source_size: The number of source pixels.
+/// \param target_size: The number of target pixels.
+/// \returns One contribution per target pixel.
+///
+static std::vector<contribution> compute_contributions(std::uint32_t source_size,
+                                                       std::uint32_t target_size);
+
+///
+/// \brief Expands a DIB palette into RGBA entries.
+/// \param palette: The RGBQUAD entries.
+/// \returns 256 entries, the missing ones zero.
+///
+static std::array<std::array<std::uint8_t, 4>, 256> read_palette(std::span<const std::uint8_t> palette) noexcept;
+
+///
+/// \brief Decodes one row of DIB pixels into RGBA.
+/// \param source: The DIB row.
+/// \param bit_count: The bits per pixel.
+/// \param palette: The palette of 1-bit, 4-bit and 8-bit rows.
+/// \param target: The RGBA row.
+///
+static void decode_row(std::span<const std::uint8_t>                      source,
+                       std::uint16_t                                      bit_count,
+                       const std::array<std::array<std::uint8_t, 4>, 256>& palette,
+                       std::span<std::uint8_t>                            target) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+rgba_image::rgba_image(const std::uint32_t       width,
+                       const std::uint32_t       height,
+                       std::vector<std::uint8_t> pixels)
+    : width{ width }
+    , height{ height }
+    , pixels{ std::move(pixels) }
+{
+	if (0 == width || 0 == height || this->pixels.size() != static_cast<std::size_t>(width) * height * 4)
+	{
+		throw std::invalid_argument{ std::format("{} bytes are not {}x{} RGBA pixels!", this->pixels.size(), width, height) };
+	}
+}
+
+rgba_image rgba_image::from_bitmap(const bitmap& bitmap)
+{
+	const std::pmr::vector<std::uint8_t>& source          = bitmap.getPixels();
+	const std::size_t                     bytes_per_pixel = static_cast<std::size_t>(bitmap.getBitDepth()) / 8;
+
+	if (0 >= bitmap.getWidth() || 0 >= bitmap.getHeight() || (3 != bytes_per_pixel && 4 != bytes_per_pixel))
+	{
+		throw std::invalid_argument{ std::format("Only 24-bit and 32-bit bitmaps are supported, got a {}x{} {}-bit one!", bitmap.getWidth(), bitmap.getHeight(),
+		                                         bitmap.getBitDepth()) };
+	}
+
+	const std::size_t         count       = static_cast<std::size_t>(bitmap.getWidth()) * static_cast<std::size_t>(bitmap.getHeight());
+	std::vector<std::uint8_t> pixels      = std::vector<std::uint8_t>(count * 4);
+	bool                      transparent = false;
+
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		pixels[index * 4 + 0] = source[index * bytes_per_pixel + 2];
+		pixels[index * 4 + 1] = source[index * bytes_per_pixel + 1];
+		pixels[index * 4 + 2] = source[index * bytes_per_pixel + 0];
+		pixels[index * 4 + 3] = 4 == bytes_per_pixel ? source[index * bytes_per_pixel + 3] : 0xFF;
+		transparent          |= 0 != pixels[index * 4 + 3];
+	}
+
+	if (!transparent)
+	{
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			pixels[index * 4 + 3] = 0xFF;
+		}
+	}
+
+	return { static_cast<std::uint32_t>(bitmap.getWidth()), static_cast<std::uint32_t>(bitmap.getHeight()), std::move(pixels) };
+}
+
+rgba_image rgba_image::from_dib(const std::span<const std::uint8_t> dib)
+{
+	dib_header header = {};
+
+	if (sizeof(header) > dib.size())
+	{
+		throw std::invalid_argument{ std::format("DIB of {} bytes is too small for its header!", dib.size()) };
+	}
+
+	std::memcpy(&header, dib.data(), sizeof(header));
+
+	const std::uint16_t bit_count = header.bit_count;
+
+	if (MIN_DIB_HEADER_SIZE > header.size || MAX_DIB_HEADER_SIZE < header.size || BI_RGB != header.compression || 0 >= header.width || 0 >= header.height
+	    || 0 != header.height % 2 || (1 != bit_count && 4 != bit_count && 8 != bit_count && 24 != bit_count && 32 != bit_count))
+	{
+		throw std::invalid_argument{ std::format("Only uncompressed 1-bit, 4-bit, 8-bit, 24-bit and 32-bit DIBs are supported, got a {}x{} {}-bit one!", header.width,
+		                                         header.height, bit_count) };
+	}
+
+	const std::uint32_t width         = static_cast<std::uint32_t>(header.width);
+	const std::uint32_t height        = static_cast<std::uint32_t>(header.height / 2);
+	const std::size_t   colors        = 8 < bit_count ? 0 : (0 != header.colors_used ? header.colors_used : std::size_t{ 1 } << bit_count);
+	const std::size_t   row_size      = (static_cast<std::size_t>(width) * bit_count + 31) / 32 * 4;
+	const std::size_t   mask_row_size = (static_cast<std::size_t>(width) + 31) / 32 * 4;
+	const std::size_t   pixels_offset = header.size + colors * 4;
+	const std::size_t   mask_offset   = pixels_offset + row_size * height;
+	const bool          has_mask      = dib.size() >= mask_offset + mask_row_size * height;
+
+	// 32-bit entries may omit the mask, since their alpha channel replaces it.
+	if (dib.size() < mask_offset || (32 != bit_count && !has_mask))
+	{
+		throw std::invalid_argument{ std::format("DIB of {} bytes is too small for {}x{} {}-bit pixels!", dib.size(), width, height, bit_count) };
+	}
+
+	const memory_reservation                           reservation = { static_cast<std::uint64_t>(width) * height * 4, "The decoded DIB" };
+	const std::array<std::array<std::uint8_t, 4>, 256> palette     = read_palette(dib.subspan(header.size, colors * 4));
+	std::vector<std::uint8_t>                          pixels      = std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 4);
+	bool                                               alpha       = false;
+
+	// DIBs are stored bottom row first, so row 0 lands at the bottom of the image.
+	for (std::uint32_t row = 0; row < height; ++row)
+	{
+		const std::span<std::uint8_t> target = std::span<std::uint8_t>{ pixels }.subspan(static_cast<std::size_t>(height - 1 - row) * width * 4, static_cast<std::size_t>(width) * 4);
+
+		decode_row(dib.subspan(pixels_offset + row * row_size, row_size), bit_count, palette, target);
+
+		if (32 == bit_count)
+		{
+			for (std::size_t index = 3; index < target.size(); index += 4)
+			{
+				alpha |= 0 != target[index];
+			}
+		}
+	}
+
+	if (alpha || !has_mask)
+	{
+		return { width, height, std::move(pixels) };
+	}
+
+	// Without an alpha channel the AND mask decides: a set bit is transparent.
+	for (std::uint32_t row = 0; row < height; ++row)
+	{
+		const std::uint8_t* const mask   = dib.data() + mask_offset + row * mask_row_size;
+		std::uint8_t* const       target = &pixels[static_cast<std::size_t>(height - 1 - row) * width * 4];
+
+		for (std::uint32_t column = 0; column < width; ++column)
+		{
+			target[column * 4 + 3] = 0 != (mask[column / 8] & (0x80 >> (column % 8))) ? 0 : 0xFF;
+		}
+	}
+
+	return { width, height, std::move(pixels) };
+}
+
+rgba_image rgba_image::resize(const std::uint32_t width,
+                              const std::uint32_t height) const
+{
+	if (this->width == width && this->height == height)
+	{
+		return *this;
+	}
+
+	const std::vector<contribution> columns    = compute_contributions(this->width, width);
+	const std::vector<contribution> rows       = compute_contributions(this->height, height);
+	std::vector<float>              horizontal = std::vector<float>(static_cast<std::size_t>(width) * this->height * 4);
+	std::vector<std::uint8_t>       result     = std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 4);
+
+	// Filter the rows into premultiplied floats, then the columns back into bytes.
+	for (std::uint32_t y = 0; y < this->height; ++y)
+	{
+		for (std::uint32_t x = 0; x < width; ++x)
+		{
+			float* const target = &horizontal[(static_cast<std::size_t>(y) * width + x) * 4];
+
+			for (std::size_t index = 0; index < columns[x].weights.size(); ++index)
+			{
+				const std::uint8_t* const source = &pixels[(static_cast<std::size_t>(y) * this->width + columns[x].first + index) * 4];
+				const float               weight = columns[x].weights[index] * source[3];
+
+				target[0] += weight * source[0];
+				target[1] += weight * source[1];
+				target[2] += weight * source[2];
+				target[3] += weight;
+			}
+		}
+	}
+
+	for (std::uint32_t y = 0; y < height; ++y)
+	{
+		for (std::uint32_t x = 0; x < width; ++x)
+		{
+			float sums[4] = {};
+
+			for (std::size_t index = 0; index < rows[y].weights.size(); ++index)
+			{
+				const float* const source = &horizontal[((rows[y].first + index) * width + x) * 4];
+
+				for (std::size_t channel = 0; channel < 4; ++channel)
+				{
+					sums[channel] += rows[y].weights[index] * source[channel];
+				}
+			}
+
+			std::uint8_t* const target = &result[(static_cast<std::size_t>(y) * width + x) * 4];
+
+			for (std::size_t channel = 0; channel < 3; ++channel)
+			{
+				target[channel] = 0.0F < sums[3] ? static_cast<std::uint8_t>(std::clamp(std::lround(sums[channel] / sums[3]), 0L, 255L)) : 0;
+			}
+
+			target[3] = static_cast<std::uint8_t>(std::clamp(std::lround(sums[3]), 0L, 255L));
+		}
+	}
+
+	return { width, height, std::move(result) };
+}
+
+std::vector<std::uint8_t> rgba_image::to_png() const
+{
+	return encode_png(width, height, pixels);
+}
+
+std::vector<std::uint8_t> rgba_image::to_dib() const
+{
+	const std::size_t         mask_row_size = (width + 31) / 32 * 4;
+	const std::size_t         pixels_size   = static_cast<std::size_t>(width) * height * 4;
+	dib_header                header        = {};
+	std::vector<std::uint8_t> bytes         = std::vector<std::uint8_t>(sizeof(header) + pixels_size + mask_row_size * height);
+
+	header.size       = sizeof(header);
+	header.width      = static_cast<std::int32_t>(width);
+	header.height     = static_cast<std::int32_t>(height * 2);
+	header.planes     = 1;
+	header.bit_count  = 32;
+	header.image_size = static_cast<std::uint32_t>(bytes.size() - sizeof(header));
+
+	std::memcpy(bytes.data(), &header, sizeof(header));
+
+	// DIBs are stored bottom row first, as BGRA.
+	for (std::uint32_t row = 0; row < height; ++row)
+	{
+		const std::uint8_t* const source = &pixels[static_cast<std::size_t>(height - 1 - row) * width * 4];
+		std::uint8_t* const       target = &bytes[sizeof(header) + static_cast<std::size_t>(row) * width * 4];
+		std::uint8_t* const       mask   = &bytes[sizeof(header) + pixels_size + row * mask_row_size];
+
+		for (std::uint32_t column = 0; column < width; ++column)
+		{
+			target[column * 4 + 0] = source[column * 4 + 2];
+			target[column * 4 + 1] = source[column * 4 + 1];
+			target[column * 4 + 2] = source[column * 4 + 0];
+			target[column * 4 + 3] = source[column * 4 + 3];
+
+			if (0 == source[column * 4 + 3])
+			{
+				mask[column / 8] |= static_cast<std::uint8_t>(0x80 >> (column % 8));
+			}
+		}
+	}
+
+	return bytes;
+}
+
+std::vector<std::uint8_t> rgba_image::encode_ico(const std::span<const rgba_image> images)
+{
+	if (images.empty() || 0xFFFF < images.size())
+	{
+		throw std::invalid_argument{ std::format("An ICO file cannot hold {} image(s)!", images.size()) };
+	}
+
+	const icon::header        header = { 0, 1, static_cast<std::uint16_t>(images.size()) };
+	std::vector<std::uint8_t> bytes  = std::vector<std::uint8_t>(sizeof(header) + images.size() * sizeof(ico_directory_entry));
+	std::size_t               offset = sizeof(header);
+
+	std::memcpy(bytes.data(), &header, sizeof(header));
+
+	for (const rgba_image& image : images)
+	{
+		if (MAX_ICO_SIZE < image.width || MAX_ICO_SIZE < image.height)
+		{
+			throw std::invalid_argument{ std::format("A {}x{} image does not fit in an ICO file!", image.width, image.height) };
+		}
+
+		const std::vector<std::uint8_t> data  = MAX_ICO_SIZE == image.width || MAX_ICO_SIZE == image.height ? image.to_png() : image.to_dib();
+		const ico_directory_entry       entry = { static_cast<std::uint8_t>(image.width), static_cast<std::uint8_t>(image.height), 0, 0, 1, 32,
+		                                          static_cast<std::uint32_t>(data.size()), static_cast<std::uint32_t>(bytes.size()) };
+
+		std::memcpy(bytes.data() + offset, &entry, sizeof(entry));
+		bytes.insert(bytes.end(), data.begin(), data.end());
+		offset += sizeof(entry);
+	}
+
+	return bytes;
+}
+
+std::uint32_t rgba_image::get_width() const noexcept
+{
+	return width;
+}
+
+std::uint32_t rgba_image::get_height() const noexcept
+{
+	return height;
+}
+
+const std::vector<std::uint8_t>& rgba_image::get_pixels() const noexcept
+{
+	return pixels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<contribution> compute_contributions(const std::uint32_t source_size,
+                                                       const std::uint32_t target_size)
+{
+	const double              scale         = static_cast<double>(source_size) / target_size;
+	const double              radius        = std::max(1.0, scale);
+	std::vector<contribution> contributions = std::vector<contribution>(target_size);
+
+	for (std::uint32_t target = 0; target < target_size; ++target)
+	{
+		const double center = (target + 0.5) * scale - 0.5;
+		const double first  = std::max(0.0, std::ceil(center - radius));
+		const double last   = std::min(source_size - 1.0, std::floor(center + radius));
+		double       sum    = 0.0;
+
+		contributions[target].first = static_cast<std::uint32_t>(first);
+
+		for (double source = first; source <= last; ++source)
+		{
+			const double weight = std::max(0.0, 1.0 - std::abs(source - center) / radius);
+
+			contributions[target].weights.push_back(static_cast<float>(weight));
+			sum += weight;
+		}
+
+		for (float& weight : contributions[target].weights)
+		{
+			weight = 0.0 < sum ? static_cast<float>(weight / sum) : 1.0F / static_cast<float>(contributions[target].weights.size());
+		}
+	}
+
+	return contributions;
+}
+
+static std::array<std::array<std::uint8_t, 4>, 256> read_palette(const std::span<const std::uint8_t> palette) noexcept
+{
+	std::array<std::array<std::uint8_t, 4>, 256> entries = {};
+
+	// RGBQUAD is BGR plus a reserved byte; palettized pixels are opaque until the mask says otherwise.
+	for (std::size_t index = 0; index < std::min<std::size_t>(palette.size() / 4, entries.size()); ++index)
+	{
+		entries[index] = { palette[index * 4 + 2], palette[index * 4 + 1], palette[index * 4 + 0], 0xFF };
+	}
+
+	return entries;
+}
+
+static void decode_row(const std::span<const std::uint8_t>                source,
+                       const std::uint16_t                                bit_count,
+                       const std::array<std::array<std::uint8_t, 4>, 256>& palette,
+                       const std::span<std::uint8_t>                      target) noexcept
+{
+	const std::size_t width = target.size() / 4;
+
+	if (32 == bit_count)
+	{
+		for (std::size_t column = 0; column < width; ++column)
+		{
+			target[column * 4 + 0] = source[column * 4 + 2];
+			target[column * 4 + 1] = source[column * 4 + 1];
+			target[column * 4 + 2] = source[column * 4 + 0];
+			target[column * 4 + 3] = source[column * 4 + 3];
+		}
+	}
+	else if (24 == bit_count)
+	{
+		for (std::size_t column = 0; column < width; ++column)
+		{
+			target[column * 4 + 0] = source[column * 3 + 2];
+			target[column * 4 + 1] = source[column * 3 + 1];
+			target[column * 4 + 2] = source[column * 3 + 0];
+			target[column * 4 + 3] = 0xFF;
+		}
+	}
+	else
+	{
+		// Palette indices are packed most significant bits first.
+		const std::size_t  per_byte = 8 / bit_count;
+		const std::uint8_t mask     = static_cast<std::uint8_t>((1 << bit_count) - 1);
+
+		for (std::size_t column = 0; column < width; ++column)
+		{
+			const std::size_t  shift = (per_byte - 1 - column % per_byte) * bit_count;
+			const std::uint8_t index = static_cast<std::uint8_t>((source[column / per_byte] >> shift) & mask);
+
+			std::memcpy(&target[column * 4], palette[index].data(), 4);
+		}
+	}
+}
+
+} // namespace icon_changer
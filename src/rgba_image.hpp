@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "bitmap.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief A decoded image with 8-bit red, green, blue and alpha channels.
+/// \details Pixels are stored top row first, which is what PNG expects; the
+/// DIB encoder flips them.
+///
+class rgba_image final
+{
+public:
+	///
+	/// \brief Constructor to wrap decoded pixels.
+	/// \param width: The image width in pixels.
+	/// \param height: The image height in pixels.
+	/// \param pixels: The pixels, width * height * 4 bytes.
+	///
+	rgba_image(std::uint32_t             width,
+	           std::uint32_t             height,
+	           std::vector<std::uint8_t> pixels);
+
+	///
+	/// \brief Converts a loaded 24-bit or 32-bit bitmap.
+	/// \details 32-bit bitmaps whose alpha channel is all zero are treated as
+	/// opaque, since BI_RGB leaves the fourth byte unused.
+	/// \param bitmap: The bitmap.
+	/// \returns The image.
+	///
+	[[nodiscard]] static rgba_image from_bitmap(const bitmap& bitmap);
+
+	///
+	/// \brief Decodes an ICO/CUR DIB entry.
+	/// \details Handles 1-bit, 4-bit and 8-bit palettized and 24-bit entries,
+	/// whose transparency comes from the AND mask, and 32-bit entries, which
+	/// use their alpha channel unless it is all zero. The pixels are read
+	/// straight from the entry bytes.
+	/// \param dib: The entry, a BITMAPINFOHEADER with a doubled height followed
+	/// by the palette, the pixels and the AND mask.
+	/// \returns The image.
+	///
+	[[nodiscard]] static rgba_image from_dib(std::span<const std::uint8_t> dib);
+
+	///
+	/// \brief Resamples the image.
+	/// \details Uses a separable triangle filter on premultiplied alpha: it is
+	/// bilinear when enlarging and widens to cover every source pixel when
+	/// shrinking, so no pixel is skipped and edges do not get dark fringes.
+	/// \param width: The new width in pixels.
+	/// \param height: The new height in pixels.
+	/// \returns The resampled image.
+	///
+	[[nodiscard]] rgba_image resize(std::uint32_t width,
+	                                std::uint32_t height) const;
+
+	///
+	/// \brief Encodes the image as a PNG file.
+	/// \returns The bytes of the PNG file.
+	///
+	[[nodiscard]] std::vector<std::uint8_t> to_png() const;
+
+	///
+	/// \brief Encodes the image as an ICO/CUR image: a 32-bit DIB with a
+	/// doubled height followed by the AND mask.
+	/// \returns The bytes of the image.
+	///
+	[[nodiscard]] std::vector<std::uint8_t> to_dib() const;
+
+	///
+	/// \brief Encodes images into a single ICO file.
+	/// \details Images of 256 pixels and more are stored as PNG, the smaller
+	/// ones as DIB, like the Windows shell expects.
+	/// \param images: The images, at most 256 pixels wide and high.
+	/// \returns The bytes of the ICO file.
+	///
+	[[nodiscard]] static std::vector<std::uint8_t> encode_ico(std::span<const rgba_image> images);
+
+	///
+	/// \brief Gets the image width.
+	/// \returns The width in pixels.
+	///
+	[[nodiscard]] std::uint32_t get_width() const noexcept;
+
+	///
+	/// \brief Gets the image height.
+	/// \returns The height in pixels.
+	///
+	[[nodiscard]] std::uint32_t get_height() const noexcept;
+
+	///
+	/// \brief Gets the pixels.
+	/// \returns The pixels, top row first, 4 bytes per pixel.
+	///
+	[[nodiscard]] const std::vector<std::uint8_t>& get_pixels() const noexcept;
+
+private:
+	std::uint32_t             width;  ///< The width in pixels.
+	std::uint32_t             height; ///< The height in pixels.
+	std::vector<std::uint8_t> pixels; ///< The RGBA pixels, top row first.
+};
+
+} // namespace icon_changer
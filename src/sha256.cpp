@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sha256.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Round constants: first 32 bits of the fractional parts of the cube
+/// roots of the first 64 primes.
+///
+static constexpr std::array<std::uint32_t, 64> ROUND_CONSTANTS = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE,
+	0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA,
+	0x5CB0A9DC, 0x76F988DA, 0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967, 0x27B70A85,
+	0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+	0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070, 0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F,
+	0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// METHOD DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+sha256::sha256() noexcept
+    : state{ 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 }
+    , buffer{}
+    , buffer_size{ 0 }
+    , total_size{ 0 }
+{
+}
+
+void sha256::update(std::span<const std::uint8_t> bytes) noexcept
+{
+	total_size += bytes.size();
+
+	if (0 != buffer_size)
+	{
+		const std::size_t count = std::min(buffer.size() - buffer_size, bytes.size());
+
+		std::memcpy(buffer.data() + buffer_size, bytes.data(), count);
+		buffer_size += count;
+		bytes = bytes.subspan(count);
+
+		if (buffer.size() != buffer_size)
+		{
+			return;
+		}
+
+		transform(buffer.data());
+		buffer_size = 0;
+	}
+
+	while (buffer.size() <= bytes.size())
+	{
+		transform(bytes.data());
+		bytes = bytes.subspan(buffer.size());
+	}
+
+	std::memcpy(buffer.data(), bytes.data(), bytes.size());
+	buffer_size = bytes.size();
+}
+
+sha256::digest sha256::finalize() noexcept
+{
+	const std::uint64_t bit_count = total_size * 8;
+	digest              value     = {};
+
+	buffer[buffer_size++] = 0x80;
+
+	if (buffer.size() - sizeof(bit_count) < buffer_size)
+	{
+		std::memset(buffer.data() + buffer_size, 0x00, buffer.size() - buffer_size);
+		transform(buffer.data());
+		buffer_size = 0;
+	}
+
+	std::memset(buffer.data() + buffer_size, 0x00, buffer.size() - buffer_size);
+
+	for (std::size_t index = 0; index < sizeof(bit_count); ++index)
+	{
+		buffer[buffer.size() - 1 - index] = static_cast<std::uint8_t>(bit_count >> (8 * index));
+	}
+
+	transform(buffer.data());
+
+	for (std::size_t index = 0; index < value.size(); ++index)
+	{
+		value[index] = static_cast<std::uint8_t>(state[index / 4] >> (24 - 8 * (index % 4)));
+	}
+
+	return value;
+}
+
+sha256::digest sha256::hash(const std::span<const std::uint8_t> bytes) noexcept
+{
+	sha256 hash = {};
+
+	hash.update(bytes);
+	return hash.finalize();
+}
+
+sha256::digest sha256::hash_file(const std::string_view file_path)
+{
+	static constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+	std::ifstream             file  = std::ifstream{ std::string{ file_path }, std::ios::binary };
+	std::vector<std::uint8_t> chunk = std::vector<std::uint8_t>(CHUNK_SIZE);
+	sha256                    hash  = {};
+
+	if (!file.is_open())
+	{
+		throw std::invalid_argument{ std::format("Failed to open \"{}\"!", file_path) };
+	}
+
+	while (file)
+	{
+		file.read(reinterpret_cast<char*>(chunk.data()), chunk.size());
+		hash.update({ chunk.data(), static_cast<std::size_t>(file.gcount()) });
+	}
+
+	return hash.finalize();
+}
+
+std::string sha256::to_string(const digest& value)
+{
+	std::string text = {};
+
+	for (const std::uint8_t byte : value)
+	{
+		text += std::format("{:02x}", byte);
+	}
+
+	return text;
+}
+
+void sha256::transform(const std::uint8_t* const block) noexcept
+{
+	std::array<std::uint32_t, 64> schedule = {};
+	std::array<std::uint32_t, 8>  work     = state;
+
+	for (std::size_t index = 0; index < 16; ++index)
+	{
+		schedule[index] = static_cast<std::uint32_t>(block[4 * index]) << 24 | static_cast<std::uint32_t>(block[4 * index + 1]) << 16 |
+		                  static_cast<std::uint32_t>(block[4 * index + 2]) << 8 | static_cast<std::uint32_t>(block[4 * index + 3]);
+	}
+
+	for (std::size_t index = 16; index < schedule.size(); ++index)
+	{
+		const std::uint32_t s0 = std::rotr(schedule[index - 15], 7) ^ std::rotr(schedule[index - 15], 18) ^ (schedule[index - 15] >> 3);
+		const std::uint32_t s1 = std::rotr(schedule[index - 2], 17) ^ std::rotr(schedule[index - 2], 19) ^ (schedule[index - 2] >> 10);
+
+		schedule[index] = schedule[index - 16] + s0 + schedule[index - 7] + s1;
+	}
+
+	for (std::size_t index = 0; index < schedule.size(); ++index)
+	{
+		const std::uint32_t s1     = std::rotr(work[4], 6) ^ std::rotr(work[4], 11) ^ std::rotr(work[4], 25);
+		const std::uint32_t choose = (work[4] & work[5]) ^ (~work[4] & work[6]);
+		const std::uint32_t first  = work[7] + s1 + choose + ROUND_CONSTANTS[index] + schedule[index];
+		const std::uint32_t s0     = std::rotr(work[0], 2) ^ std::rotr(work[0], 13) ^ std::rotr(work[0], 22);
+		const std::uint32_t major  = (work[0] & work[1]) ^ (work[0] & work[2]) ^ (work[1] & work[2]);
+
+		work[7] = work[6];
+		work[6] = work[5];
+		work[5] = work[4];
+		work[4] = work[3] + first;
+		work[3] = work[2];
+		work[2] = work[1];
+		work[1] = work[0];
+		work[0] = first + s0 + major;
+	}
+
+	for (std::size_t index = 0; index < state.size(); ++index)
+	{
+		state[index] += work[index];
+	}
+}
+
+} // namespace icon_changer
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Incremental SHA-256 hash.
+/// \details Bytes can be fed in arbitrary chunks, which allows hashing data
+/// while it is being written.
+/// \see https://csrc.nist.gov/pubs/fips/180-4/upd1/final
+///
+class sha256 final
+{
+public:
+	///
+	/// \brief A SHA-256 digest.
+	///
+	using digest = std::array<std::uint8_t, 32>;
+
+public:
+	///
+	/// \brief Constructs a hash with the initial state.
+	///
+	sha256() noexcept;
+
+	///
+	/// \brief Hashes more bytes.
+	/// \param bytes: The bytes to be hashed.
+	///
+	void update(std::span<const std::uint8_t> bytes) noexcept;
+
+	///
+	/// \brief Pads the message and produces the digest.
+	/// \details The object must not be updated afterwards.
+	/// \returns The digest.
+	///
+	[[nodiscard]] digest finalize() noexcept;
+
+	///
+	/// \brief Hashes a buffer in one go.
+	/// \param bytes: The bytes to be hashed.
+	/// \returns The digest.
+	///
+	[[nodiscard]] static digest hash(std::span<const std::uint8_t> bytes) noexcept;
+
+	///
+	/// \brief Hashes a whole file.
+	/// \param file_path: The path to the file.
+	/// \returns The digest.
+	///
+	[[nodiscard]] static digest hash_file(std::string_view file_path);
+
+	///
+	/// \brief Formats a digest as lowercase hexadecimal.
+	/// \param value: The digest.
+	/// \returns 64 hexadecimal characters.
+	///
+	[[nodiscard]] static std::string to_string(const digest& value);
+
+private:
+	///
+	/// \brief Processes one 64 byte block.
+	/// \param block: The block.
+	///
+	void transform(const std::uint8_t* block) noexcept;
+
+private:
+	std::array<std::uint32_t, 8> state;        ///< The intermediate hash value.
+	std::array<std::uint8_t, 64> buffer;       ///< Bytes not yet processed.
+	std::size_t                  buffer_size;  ///< Number of bytes in the buffer.
+	std::uint64_t                total_size;   ///< Number of bytes hashed so far.
+};
+
+} // namespace icon_changer
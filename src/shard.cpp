@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shard.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL VARIABLES
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Parameters of the 64-bit FNV-1a hash.
+///
+static constexpr std::uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325;
+static constexpr std::uint64_t FNV_PRIME        = 0x00000100000001B3;
+
+///
+/// \brief Limit of the number of shards, far more than machines in a run.
+///
+static constexpr std::uint32_t MAX_SHARD_COUNT = 65536;
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+shard_spec parse_shard(const std::string_view text)
+{
+	const std::size_t separator = text.find('/');
+	std::uint32_t     number    = 0;
+	std::uint32_t     count     = 0;
+
+	if (std::string_view::npos != separator)
+	{
+		const std::from_chars_result number_result = std::from_chars(text.data(), text.data() + separator, number);
+		const std::from_chars_result count_result  = std::from_chars(text.data() + separator + 1, text.data() + text.size(), count);
+
+		if (std::errc{} == number_result.ec && text.data() + separator == number_result.ptr &&
+		    std::errc{} == count_result.ec && text.data() + text.size() == count_result.ptr &&
+		    0 < number && number <= count && MAX_SHARD_COUNT >= count)
+		{
+			return { number - 1, count };
+		}
+	}
+
+	throw std::invalid_argument{ std::format("Shard \"{}\" is invalid, expecting i/N with 1 <= i <= N <= {}!", text, MAX_SHARD_COUNT) };
+}
+
+std::string format_shard(const shard_spec& shard)
+{
+	return std::format("{}/{}", shard.index + 1, shard.count);
+}
+
+std::uint64_t hash_path(const std::string_view path)
+{
+	std::uint64_t hash = FNV_OFFSET_BASIS;
+
+	for (const char character : path)
+	{
+		hash = (hash ^ static_cast<std::uint8_t>(character)) * FNV_PRIME;
+	}
+
+	return hash;
+}
+
+std::vector<std::uint64_t> get_file_sizes(const std::span<const std::string> paths)
+{
+	std::vector<std::uint64_t> sizes = std::vector<std::uint64_t>(paths.size());
+
+	for (std::size_t index = 0; index < paths.size(); ++index)
+	{
+		std::error_code     error = {};
+		const std::uint64_t size  = std::filesystem::file_size(paths[index], error);
+
+		sizes[index] = error ? 0 : size;
+	}
+
+	return sizes;
+}
+
+shard_selection select_shard(const std::span<const std::string>   paths,
+                             const std::span<const std::uint64_t> sizes,
+                             const shard_spec&                    shard)
+{
+	std::vector<std::size_t>   order     = std::vector<std::size_t>(paths.size());
+	std::vector<std::uint64_t> hashes    = std::vector<std::uint64_t>(paths.size());
+	std::vector<std::uint64_t> weights   = std::vector<std::uint64_t>(paths.size());
+	shard_selection            selection = { {}, FNV_OFFSET_BASIS };
+	std::uint64_t              total     = 0;
+
+	if (paths.size() != sizes.size())
+	{
+		throw std::logic_error{ std::format("Got {} size(s) for {} target(s)!", sizes.size(), paths.size()) };
+	}
+
+	for (std::size_t index = 0; index < paths.size(); ++index)
+	{
+		// Empty and missing files still count, so they are spread like the
+		// others and reported by the shard that gets them.
+		order[index]   = index;
+		hashes[index]  = hash_path(paths[index]);
+		weights[index] = sizes[index] + 1;
+		total         += weights[index];
+	}
+
+	std::sort(order.begin(), order.end(), [&paths, &hashes](const std::size_t left, const std::size_t right)
+	{
+		return std::tie(hashes[left], paths[left], left) < std::tie(hashes[right], paths[right], right);
+	});
+
+	// A target belongs to the run of bytes its middle falls into.
+	const std::uint64_t step   = std::max<std::uint64_t>(1, (total + shard.count - 1) / shard.count);
+	std::uint64_t       offset = 0;
+
+	for (const std::size_t index : order)
+	{
+		if (shard.index == (offset + weights[index] / 2) / step)
+		{
+			selection.indices.push_back(index);
+		}
+
+		offset              += weights[index];
+		selection.partition  = (selection.partition ^ hashes[index]) * FNV_PRIME;
+		selection.partition  = (selection.partition ^ weights[index]) * FNV_PRIME;
+	}
+
+	std::sort(selection.indices.begin(), selection.indices.end());
+
+	return selection;
+}
+
+} // namespace icon_changer
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief One part of a run split across machines, see `--shard`.
+///
+struct shard_spec final
+{
+	std::uint32_t index; ///< The part handled here, from 0.
+	std::uint32_t count; ///< The number of parts.
+};
+
+///
+/// \brief The targets of a shard, see select_shard().
+///
+struct shard_selection final
+{
+	std::vector<std::size_t> indices;   ///< The indices of the shard's targets, in the order of the paths.
+	std::uint64_t            partition; ///< Fingerprint of the paths and sizes the partition was computed from.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Parses a shard given as "i/N", i counting from 1.
+/// \param text: The shard.
+/// \returns The shard.
+///
+extern shard_spec parse_shard(std::string_view text);
+
+///
+/// \brief Formats a shard as "i/N", i counting from 1.
+/// \param shard: The shard.
+/// \returns The text.
+///
+extern std::string format_shard(const shard_spec& shard);
+
+///
+/// \brief Hashes a path the same way on every machine (64-bit FNV-1a).
+/// \param path: The path, hashed as written.
+/// \returns The hash.
+///
+extern std::uint64_t hash_path(std::string_view path);
+
+///
+/// \brief Gets the sizes of files, to balance shards of read-only runs.
+/// \details Missing files count as empty.
+/// \param paths: The paths to the files.
+/// \returns The sizes in bytes, in the order of the paths.
+///
+extern std::vector<std::uint64_t> get_file_sizes(std::span<const std::string> paths);
+
+///
+/// \brief Selects the targets of a shard.
+/// \details The targets are ordered by the hash of their path and cut into
+/// runs of about the same number of bytes, so every shard sees the same
+/// partition without talking to the others, big files are spread like small
+/// ones and adding a target only moves the targets next to a cut. Nothing is
+/// read from the disk: all shards must be given the same paths and sizes, so
+/// pass the paths the same way everywhere (they are not made canonical, mount
+/// points differ between machines) and take the sizes from data fixed for
+/// the whole run, never from targets that other shards may be stamping.
+/// Shards that disagree get different fingerprints.
+/// \param paths: The paths to the targets.
+/// \param sizes: The sizes of the targets in bytes, in the order of the paths.
+/// \param shard: The shard.
+/// \returns The shard's targets.
+///
+extern shard_selection select_shard(std::span<const std::string>   paths,
+                                    std::span<const std::uint64_t> sizes,
+                                    const shard_spec&              shard);
+
+} // namespace icon_changer
@@ -0,0 +1,440 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "stamp.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <set>
+#include <span>
+#include <stdexcept>
+
+#include "animated_cursor.hpp"
+#include "executable_icon.hpp"
+#include "file_lock.hpp"
+#include "icon.hpp"
+#include "logger.hpp"
+#include "stamp_verifier.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Moves the cursors of a stamp after those of the target.
+/// \details The stamp numbers its RT_CURSOR images from 1, which would replace
+/// the images of the cursors already in the target. The images of the groups
+/// the stamp replaces are free again, so stamping twice gives the same result.
+/// \param stamp: The resources to be stamped, see build_stamp().
+/// \param target: The resources of the executable.
+/// \returns The stamp with its cursor images and group headers renumbered,
+/// empty if the stamp can be merged as it is.
+///
+static std::optional<resource_tree> place_cursors(const resource_tree& stamp,
+                                                  const resource_tree& target);
+
+///
+/// \brief Reads the RT_CURSOR identifiers of a group cursor header.
+/// \param group: The RT_GROUP_CURSOR resource.
+/// \returns The identifiers, of the entries that are complete.
+///
+static std::vector<std::uint16_t> get_cursor_ids(std::span<const std::uint8_t> group);
+
+///
+/// \brief Adds an icon or a cursor (images and group header) to the executable.
+/// \details The icon is stored as "MAINICON", cursors are named after their
+/// file and numbered after the cursors added before them.
+/// \param resources: The resources to be stamped.
+/// \param icon: The parsed icon or cursor.
+/// \param file_path: The path to the icon or cursor file.
+/// \param next_cursor_id: The first free RT_CURSOR identifier, updated.
+///
+static void add_icon(resource_tree&   resources,
+                     icon&            icon,
+                     std::string_view file_path,
+                     std::uint16_t&   next_cursor_id);
+
+///
+/// \brief Adds an animated cursor as an RT_ANICURSOR resource.
+/// \details The frames are deduplicated first and the resource is named after
+/// the file, like static cursors.
+/// \param resources: The resources to be stamped.
+/// \param file_path: The path to the ANI file.
+///
+static void add_animated_cursor(resource_tree&   resources,
+                                std::string_view file_path);
+
+///
+/// \brief Derives a resource name from a file name.
+/// \param file_path: The path to the file.
+/// \returns The file stem in uppercase.
+///
+static std::string get_resource_name(std::string_view file_path);
+
+///
+/// \brief Adds the individual icon or cursor image resources to the executable.
+/// \details Iterates over all images and adds them with appropriate resource IDs.
+/// \param resources: The resources to be stamped.
+/// \param icon: The parsed icon object containing image data.
+/// \param first_id: The resource ID of the first image.
+///
+static void set_images(resource_tree& resources,
+                       icon&          icon,
+                       std::uint16_t  first_id);
+
+///
+/// \brief Copies the icon of another executable as the main icon.
+/// \details The images stay in the mapped donor and are spliced into the
+/// output when it is written, so they are copied once and never decoded.
+/// \param resources: The resources to be stamped.
+/// \param donor_path: The path to the executable whose icon is copied.
+///
+static void add_executable_icon(resource_tree&   resources,
+                                std::string_view donor_path);
+
+///
+/// \brief Adds the group icon or group cursor header (NEWHEADER + RESDIR) to
+/// the executable.
+/// \param resources: The resources to be stamped.
+/// \param icon: The parsed icon object containing the group header.
+/// \param name: The name of the group resource.
+///
+static void set_icon_header(resource_tree&     resources,
+                            const icon&        icon,
+                            const resource_id& name);
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+void require_file(const std::string_view file_path)
+{
+	if (!std::filesystem::exists(file_path))
+	{
+		throw std::invalid_argument{ std::format("\"{}\" does not exist!", file_path) };
+	}
+}
+
+resource_tree build_stamp(const std::string_view           icon_path,
+                          const stamp_options&             options,
+                          std::pmr::memory_resource* const resource)
+{
+	resource_tree stamp          = {};
+	std::uint16_t next_cursor_id = 1;
+
+	if (options.from_executable)
+	{
+		add_executable_icon(stamp, icon_path);
+	}
+	else
+	{
+		icon icon = { icon_path, true, resource };
+
+		add_icon(stamp, icon, icon_path, next_cursor_id);
+	}
+
+	for (const std::string& cursor_path : options.cursors)
+	{
+		const std::filesystem::path extension = std::filesystem::path{ cursor_path }.extension();
+
+		if (".ani" == extension || ".ANI" == extension)
+		{
+			add_animated_cursor(stamp, cursor_path);
+			continue;
+		}
+
+		icon_changer::icon cursor = { cursor_path, false, resource };
+
+		if (!cursor.is_cursor())
+		{
+			throw std::invalid_argument{ std::format("\"{}\" is not a cursor!", cursor_path) };
+		}
+
+		add_icon(stamp, cursor, cursor_path, next_cursor_id);
+	}
+
+	return stamp;
+}
+
+std::optional<resource_tree> stamp_icon(resource_backend&      backend,
+                                        const resource_tree&   stamp,
+                                        const std::string_view executable_path,
+                                        const stamp_options&   options)
+{
+	if (backend.get_image().has_certificates())
+	{
+		if (certificate_policy::unspecified == options.certificates)
+		{
+			throw std::invalid_argument{ std::format("\"{}\" is signed, pass --strip-signature or --keep-signature!", executable_path) };
+		}
+
+		if (certificate_policy::strip == options.certificates)
+		{
+			backend.get_image().strip_certificates();
+		}
+	}
+
+	const std::optional<resource_tree> placed = place_cursors(stamp, backend.get_resources());
+
+	const resource_tree& stamped = placed.has_value() ? *placed : stamp;
+
+	backend.merge(stamped);
+
+	if (options.verify)
+	{
+		backend.set_check([&stamped](const std::string_view written_path)
+		{
+			verify_stamp(written_path, stamped);
+		});
+	}
+
+	backend.commit();
+
+	return placed;
+}
+
+stamp_result stamp_file(const resource_tree&             stamp,
+                        const std::string_view           executable_path,
+                        const stamp_options&             options,
+                        const bool                       compute_digest,
+                        const bool                       hash_contents,
+                        std::pmr::memory_resource* const resource)
+{
+	const file_lock lock    = file_lock{ executable_path };
+	file_backend    backend = file_backend{ executable_path, compute_digest, hash_contents, resource };
+
+	static_cast<void>(stamp_icon(backend, stamp, executable_path, options));
+
+	return { backend.get_digest(), backend.get_contents_hash(), std::filesystem::file_size(executable_path) };
+}
+
+static std::optional<resource_tree> place_cursors(const resource_tree& stamp,
+                                                  const resource_tree& target)
+{
+	std::set<std::uint16_t> replaced = {};
+	std::set<std::uint16_t> kept     = {};
+	std::uint16_t           stamped  = 0;
+	std::uint16_t           last     = 0;
+
+	stamp.for_each([&stamped](const resource_id& type, const resource_id& name, std::uint16_t, const resource_tree::leaf&)
+	{
+		if (resource_id{ resource_type::cursor } == type && !name.is_named())
+		{
+			stamped = std::max(stamped, name.get_id());
+		}
+	});
+
+	if (0 == stamped)
+	{
+		return std::nullopt;
+	}
+
+	// RT_CURSOR sorts before RT_GROUP_CURSOR, so the groups are read first.
+	target.for_each([&stamp, &replaced, &kept](const resource_id& type, const resource_id& name, const std::uint16_t language, const resource_tree::leaf& leaf)
+	{
+		if (resource_id{ resource_type::group_cursor } == type)
+		{
+			std::set<std::uint16_t>& ids = nullptr == stamp.find(type, name, language) ? kept : replaced;
+
+			for (const std::uint16_t id : get_cursor_ids(leaf.get_bytes()))
+			{
+				ids.insert(id);
+			}
+		}
+	});
+
+	target.for_each([&replaced, &kept, &last](const resource_id& type, const resource_id& name, std::uint16_t, const resource_tree::leaf&)
+	{
+		if (resource_id{ resource_type::cursor } == type && !name.is_named() && (!replaced.contains(name.get_id()) || kept.contains(name.get_id())))
+		{
+			last = std::max(last, name.get_id());
+		}
+	});
+
+	if (0 == last)
+	{
+		return std::nullopt;
+	}
+
+	if (UINT16_MAX - last < stamped)
+	{
+		throw std::runtime_error{ std::format("No room for {} cursor image(s) after RT_CURSOR {}!", stamped, last) };
+	}
+
+	resource_tree placed = {};
+
+	stamp.for_each([&placed, last](const resource_id& type, const resource_id& name, const std::uint16_t language, const resource_tree::leaf& leaf)
+	{
+		if (resource_id{ resource_type::cursor } == type && !name.is_named())
+		{
+			const resource_id id = static_cast<std::uint16_t>(name.get_id() + last);
+
+			if (leaf.range.has_value())
+			{
+				placed.set_range(type, id, language, *leaf.range);
+			}
+			else
+			{
+				placed.set(type, id, language, { leaf.data.begin(), leaf.data.end() });
+			}
+		}
+		else if (resource_id{ resource_type::group_cursor } == type)
+		{
+			const std::span<const std::uint8_t> bytes  = leaf.get_bytes();
+			const std::vector<std::uint16_t>    ids    = get_cursor_ids(bytes);
+			std::vector<std::uint8_t>           header = { bytes.begin(), bytes.end() };
+
+			for (std::size_t index = 0; index < ids.size(); ++index)
+			{
+				const std::uint16_t id = static_cast<std::uint16_t>(ids[index] + last);
+
+				std::memcpy(header.data() + sizeof(icon::header) + index * sizeof(icon::cursor_entry) + offsetof(icon::cursor_entry, cursor_id), &id, sizeof(id));
+			}
+
+			placed.set(type, name, language, std::move(header));
+		}
+		else if (leaf.range.has_value())
+		{
+			placed.set_range(type, name, language, *leaf.range);
+		}
+		else
+		{
+			placed.set(type, name, language, { leaf.data.begin(), leaf.data.end() });
+		}
+	});
+
+	LOG("Moving {} stamped cursor image(s) after RT_CURSOR {}.", stamped, last);
+
+	return placed;
+}
+
+static std::vector<std::uint16_t> get_cursor_ids(const std::span<const std::uint8_t> group)
+{
+	std::vector<std::uint16_t> ids    = {};
+	icon::header               header = {};
+
+	if (group.size() < sizeof(header))
+	{
+		return ids;
+	}
+
+	std::memcpy(&header, group.data(), sizeof(header));
+
+	const std::size_t count = std::min<std::size_t>(header.entries_count, (group.size() - sizeof(header)) / sizeof(icon::cursor_entry));
+
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		icon::cursor_entry entry = {};
+
+		std::memcpy(&entry, group.data() + sizeof(header) + index * sizeof(entry), sizeof(entry));
+		ids.push_back(entry.cursor_id);
+	}
+
+	return ids;
+}
+
+static void add_icon(resource_tree&         resources,
+                     icon&                  icon,
+                     const std::string_view file_path,
+                     std::uint16_t&         next_cursor_id)
+{
+	if (!icon.is_cursor())
+	{
+		set_images(resources, icon, 1);
+		set_icon_header(resources, icon, "MAINICON");
+		return;
+	}
+
+	const std::string name = get_resource_name(file_path);
+
+	icon.renumber(next_cursor_id);
+	set_images(resources, icon, next_cursor_id);
+	set_icon_header(resources, icon, std::string_view{ name });
+
+	next_cursor_id += static_cast<std::uint16_t>(icon.get_images().size());
+}
+
+static void add_animated_cursor(resource_tree&         resources,
+                                const std::string_view file_path)
+{
+	const animated_cursor cursor = animated_cursor{ file_path };
+	const std::string     name   = get_resource_name(file_path);
+
+	resources.set(resource_type::animated_cursor, std::string_view{ name }, resource_tree::NEUTRAL_LANGUAGE, cursor.serialize());
+}
+
+static std::string get_resource_name(const std::string_view file_path)
+{
+	std::string name = std::filesystem::path{ file_path }.stem().string();
+
+	std::transform(name.begin(), name.end(), name.begin(), [](const char character)
+	{
+		return 'a' <= character && 'z' >= character ? static_cast<char>(character - 'a' + 'A') : character;
+	});
+
+	return name;
+}
+
+static void add_executable_icon(resource_tree&         resources,
+                                const std::string_view donor_path)
+{
+	const executable_icon donor = executable_icon{ donor_path };
+	std::uint16_t         id    = 1;
+
+	for (const file_range& image : donor.get_images())
+	{
+		resources.set_range(resource_type::icon, id++, resource_tree::NEUTRAL_LANGUAGE, image);
+	}
+
+	resources.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, donor.get_header());
+}
+
+static void set_images(resource_tree&      resources,
+                       icon&               icon,
+                       const std::uint16_t first_id)
+{
+	const resource_type type = icon.is_cursor() ? resource_type::cursor : resource_type::icon;
+	std::uint16_t       id   = first_id;
+
+	// Images left in a mapped file are spliced into the executable when it is
+	// written, without passing through memory.
+	for (const file_range& range : icon.get_image_ranges())
+	{
+		resources.set_range(type, id++, resource_tree::NEUTRAL_LANGUAGE, range);
+	}
+
+	for (const std::pmr::vector<std::uint8_t>& image : icon.get_images())
+	{
+		// We rely on the fact that the IDs in the header entries start from first_id.
+		resources.set(type, id++, resource_tree::NEUTRAL_LANGUAGE, { image.begin(), image.end() });
+	}
+}
+
+static void set_icon_header(resource_tree&     resources,
+                            const icon&        icon,
+                            const resource_id& name)
+{
+	resources.set(icon.is_cursor() ? resource_type::group_cursor : resource_type::group_icon, name, resource_tree::NEUTRAL_LANGUAGE, icon.get_header());
+}
+
+} // namespace icon_changer
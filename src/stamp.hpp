@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "resource_backend.hpp"
+#include "resource_tree.hpp"
+#include "sha256.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief What to do with the Authenticode signatures of a signed executable.
+/// \details Changing the resources invalidates the signatures, so the user
+/// has to choose explicitly.
+///
+enum class certificate_policy
+{
+	unspecified, ///< No choice was made, signed executables are rejected.
+	preserve,    ///< Keep the certificate table as it is.
+	strip,       ///< Remove the certificate table.
+};
+
+///
+/// \brief What is stamped into an executable and how.
+/// \details Shared by the command line and the asynchronous API, so both
+/// produce the same executables.
+///
+struct stamp_options final
+{
+	std::vector<std::string> cursors;         ///< The cursors stamped along with the icon.
+	bool                     from_executable; ///< The icon path is an executable whose icon is copied.
+	certificate_policy       certificates;    ///< What to do with existing signatures.
+	bool                     verify;          ///< Check every output once written, see verify_stamp().
+};
+
+///
+/// \brief What stamp_file() wrote.
+///
+struct stamp_result final
+{
+	std::optional<sha256::digest> digest;   ///< The Authenticode digest of the output, if requested.
+	std::optional<sha256::digest> contents; ///< The SHA-256 of the output, if requested.
+	std::uint64_t                 size;     ///< The size of the output in bytes.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Throws if a file does not exist.
+/// \param file_path: The path to the file.
+///
+extern void require_file(std::string_view file_path);
+
+///
+/// \brief Loads the resources stamped into every target: the icon (or the
+/// donor's icon with from_executable) and the cursors.
+/// \details The images stay in their mapped files, so the stamp is cheap to
+/// merge into many executables and its payloads are spliced when written.
+/// The cursor images are numbered from 1, see stamp_icon().
+/// \param icon_path: The path to the `.ico` file.
+/// \param options: What is stamped.
+/// \param resource: Where the images read into memory (cursors) are
+/// allocated until they are copied into the stamp.
+/// \returns The resources to be stamped.
+///
+[[nodiscard]] extern resource_tree build_stamp(std::string_view           icon_path,
+                                               const stamp_options&       options,
+                                               std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+///
+/// \brief Stamps an icon through a resource backend.
+/// \details Handles the signatures, moves the cursors of the stamp after
+/// those of the target, merges the stamp and commits the update. With
+/// options.verify the written file is checked before it is committed, so
+/// an output failing verification never replaces the original.
+/// \param backend: The backend of the executable.
+/// \param stamp: The resources to be stamped, see build_stamp().
+/// \param executable_path: The path to the target `.exe` file.
+/// \param options: What is stamped.
+/// \returns The stamp as merged, empty if the stamp was merged as it is.
+///
+extern std::optional<resource_tree> stamp_icon(resource_backend&    backend,
+                                               const resource_tree& stamp,
+                                               std::string_view     executable_path,
+                                               const stamp_options& options);
+
+///
+/// \brief Stamps an icon into an executable file.
+/// \details The executable is only replaced once the new file has been
+/// written completely, and it stays locked meanwhile so concurrent updates
+/// (also from other processes) are serialized. With options.verify the
+/// new file is checked before it replaces the executable, see stamp_icon().
+/// \param stamp: The resources to be stamped, see build_stamp().
+/// \param executable_path: The path to the target `.exe` file.
+/// \param options: What is stamped.
+/// \param compute_digest: Whether the Authenticode digest is computed while
+/// writing.
+/// \param hash_contents: Whether the SHA-256 of the output is computed while
+/// writing, so it describes the file as written under the lock.
+/// \param resource: Where the executable and its resources are loaded.
+/// \returns The hashes requested and the size of the output.
+///
+extern stamp_result stamp_file(const resource_tree&       stamp,
+                               std::string_view           executable_path,
+                               const stamp_options&       options,
+                               bool                       compute_digest,
+                               bool                       hash_contents,
+                               std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+} // namespace icon_changer
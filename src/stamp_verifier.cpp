@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include "stamp_verifier.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include "pe_image.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+void verify_stamp(const std::string_view executable_path,
+                  const resource_tree&   stamp)
+{
+	const mapped_file file     = mapped_file{ executable_path };
+	std::size_t       verified = 0;
+	std::uint64_t     size     = 0;
+
+	try
+	{
+		const pe_image::resource_view resources = pe_image::verify(file.get_bytes());
+
+		if (resources.directory.empty())
+		{
+			throw std::runtime_error{ "Executable has no resources!" };
+		}
+
+		// The stamp is in memory, so its bytes are compared directly instead of
+		// hashing both sides.
+		resource_tree::visit(resources.directory, resources.rva,
+		                     [&stamp, &verified, &size](const resource_id& type, const resource_id& name, const std::uint16_t language,
+		                                                const std::span<const std::uint8_t> data, const std::uint32_t code_page)
+		                     {
+			                     const resource_tree::leaf* const expected = stamp.find(type, name, language);
+
+			                     if (nullptr == expected)
+			                     {
+				                     return;
+			                     }
+
+			                     if (expected->code_page != code_page || !std::ranges::equal(expected->get_bytes(), data))
+			                     {
+				                     throw std::runtime_error{ std::format("Resource {}/{}/{} does not match what was stamped!", type.to_string(), name.to_string(), language) };
+			                     }
+
+			                     ++verified;
+			                     size += data.size();
+		                     });
+	}
+	catch (const std::exception& exception)
+	{
+		throw std::runtime_error{ std::format("\"{}\" failed verification: {}", executable_path, exception.what()) };
+	}
+
+	if (stamp.size() != verified)
+	{
+		throw std::runtime_error{ std::format("\"{}\" failed verification: {} of {} stamped resource(s) are missing!", executable_path, stamp.size() - verified, stamp.size()) };
+	}
+
+	LOG("Verified {} resource(s) ({} bytes) of \"{}\".", verified, size, executable_path);
+}
+
+} // namespace icon_changer
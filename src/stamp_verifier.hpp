@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string_view>
+
+#include "resource_tree.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Checks that an executable written to disk holds what was stamped.
+/// \details The file is memory mapped read-only: its headers and checksum are
+/// validated (see pe_image::verify()) and its resource directory is walked in
+/// place, comparing every stamped resource (the RT_GROUP_ICON header, the
+/// RT_ICON images, the cursors) with the bytes and code page in the file.
+/// Other resources are not touched.
+/// \param executable_path: The path to the executable.
+/// \param stamp: The resources stamped into it.
+///
+extern void verify_stamp(std::string_view     executable_path,
+                         const resource_tree& stamp);
+
+} // namespace icon_changer
@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+namespace icon_changer
+{
+
+///
+/// \brief Lazily started coroutine producing a value.
+/// \details Nothing runs until the task is awaited; it then runs on the
+/// awaiting thread until it suspends (e.g. on executor::schedule()) and
+/// resumes its awaiter when it finishes, rethrowing its exception if any.
+/// \tparam T: The type of the value.
+///
+template<typename T>
+class [[nodiscard]] task final
+{
+public:
+	///
+	/// \brief The coroutine state of a task.
+	///
+	struct promise_type final
+	{
+		///
+		/// \brief Resumes the awaiter once the task has finished.
+		///
+		struct final_awaiter final
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			std::coroutine_handle<> await_suspend(const std::coroutine_handle<promise_type> coroutine) const noexcept
+			{
+				return coroutine.promise().continuation;
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		task get_return_object() noexcept
+		{
+			return task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		final_awaiter final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		template<typename U>
+		void return_value(U&& result)
+		{
+			value.emplace(std::forward<U>(result));
+		}
+
+		void unhandled_exception() noexcept
+		{
+			exception = std::current_exception();
+		}
+
+		std::optional<T>        value;        ///< The result, once returned.
+		std::exception_ptr      exception;    ///< The exception that ended the task, if any.
+		std::coroutine_handle<> continuation; ///< The awaiting coroutine.
+	};
+
+	///
+	/// \brief Starts the task when it is awaited.
+	///
+	struct awaiter final
+	{
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept
+		{
+			coroutine.promise().continuation = awaiting;
+			return coroutine;
+		}
+
+		T await_resume() const
+		{
+			if (nullptr != coroutine.promise().exception)
+			{
+				std::rethrow_exception(coroutine.promise().exception);
+			}
+
+			return std::move(coroutine.promise().value).value();
+		}
+
+		std::coroutine_handle<promise_type> coroutine; ///< The awaited task.
+	};
+
+	task(task&& other) noexcept
+	    : coroutine{ std::exchange(other.coroutine, nullptr) }
+	{
+	}
+
+	task(const task&) = delete;
+
+	task& operator=(const task&) = delete;
+
+	task& operator=(task&&) = delete;
+
+	///
+	/// \brief Destructor to destroy the coroutine state.
+	///
+	~task() noexcept
+	{
+		if (nullptr != coroutine)
+		{
+			coroutine.destroy();
+		}
+	}
+
+	awaiter operator co_await() const & noexcept
+	{
+		return { coroutine };
+	}
+
+	awaiter operator co_await() const && noexcept
+	{
+		return { coroutine };
+	}
+
+private:
+	explicit task(const std::coroutine_handle<promise_type> coroutine) noexcept
+	    : coroutine{ coroutine }
+	{
+	}
+
+	std::coroutine_handle<promise_type> coroutine; ///< The coroutine, nullptr once moved.
+};
+
+///
+/// \brief Coroutine that starts right away and frees itself when it finishes.
+/// \details Only used to bridge tasks and blocking callers, see sync_wait().
+///
+struct detached_task final
+{
+	struct promise_type final
+	{
+		detached_task get_return_object() const noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		void return_void() const noexcept
+		{
+		}
+
+		void unhandled_exception() const noexcept
+		{
+			std::terminate();
+		}
+	};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Runs a task and blocks the calling thread until it finishes.
+/// \details For hosts without an event loop of their own, and for tests.
+/// \param task: The task.
+/// \returns The value of the task, or rethrows its exception.
+///
+template<typename T>
+T sync_wait(task<T> task)
+{
+	std::promise<T> promise = {};
+	std::future<T>  future  = promise.get_future();
+
+	// The promise's shared state outlives this frame, so finishing the
+	// coroutine after the future is ready is safe.
+	[](icon_changer::task<T> task, std::promise<T> promise) -> detached_task
+	{
+		try
+		{
+			promise.set_value(co_await std::move(task));
+		}
+		catch (...)
+		{
+			promise.set_exception(std::current_exception());
+		}
+	}(std::move(task), std::move(promise));
+
+	return future.get();
+}
+
+} // namespace icon_changer
@@ -32,7 +32,10 @@ class icon_mock final
 {
 public:
 	MOCK_METHOD(std::vector<std::uint8_t>, get_header, (), (const));
-	MOCK_METHOD(std::vector<std::vector<std::uint8_t>>&, get_images, (), ());
+	MOCK_METHOD(std::pmr::vector<std::pmr::vector<std::uint8_t>>&, get_images, (), ());
+	MOCK_METHOD(const std::vector<file_range>&, get_image_ranges, (), (const));
+	MOCK_METHOD(bool, is_cursor, (), (const));
+	MOCK_METHOD(void, renumber, (std::uint16_t), ());
 
 	icon_mock()
 	{
@@ -49,7 +52,9 @@ public:
 
 std::unique_ptr<icon_mock> icon_mock::obj = nullptr;
 
-icon::icon(const std::string_view file_path)
+icon::icon(const std::string_view           file_path,
+           const bool                       mapped,
+           std::pmr::memory_resource* const resource)
 {
 }
 
@@ -58,9 +63,24 @@ std::vector<std::uint8_t> icon::get_header() const
 	return icon_mock::obj->get_header();
 }
 
-std::vector<std::vector<std::uint8_t>>& icon::get_images() noexcept
+std::pmr::vector<std::pmr::vector<std::uint8_t>>& icon::get_images() noexcept
 {
 	return icon_mock::obj->get_images();
 }
 
+const std::vector<file_range>& icon::get_image_ranges() const noexcept
+{
+	return icon_mock::obj->get_image_ranges();
+}
+
+bool icon::is_cursor() const noexcept
+{
+	return icon_mock::obj->is_cursor();
+}
+
+void icon::renumber(const std::uint16_t first_id) noexcept
+{
+	icon_mock::obj->renumber(first_id);
+}
+
 } // namespace icon_changer
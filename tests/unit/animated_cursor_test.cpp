@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "animated_cursor.cpp"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(animated_cursor, constructor_success)
+{
+	const animated_cursor cursor = animated_cursor{ TEST_DATA_PATH "busy.ani" };
+
+	ASSERT_EQ(2, cursor.get_frames().size());
+	EXPECT_THAT(cursor.get_sequence(), ElementsAre(0, 1, 0, 1));
+	EXPECT_TRUE(cursor.get_rates().empty());
+	EXPECT_EQ(10, cursor.get_header().display_rate);
+	EXPECT_EQ(2, cursor.get_header().frames_count);
+	EXPECT_EQ(4, cursor.get_header().steps_count);
+	EXPECT_EQ(animated_cursor::ICON_FRAMES_FLAG | animated_cursor::SEQUENCE_FLAG, cursor.get_header().flags);
+}
+
+TEST(animated_cursor, constructor_fail)
+{
+	ASSERT_THAT([]()
+	{
+		animated_cursor{ TEST_DATA_PATH "image1.cur" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("does not have a RIFF header")));
+
+	// The RIFF size does not even cover the form type.
+	std::ofstream{ "undersized.ani", std::ios::binary } << std::string_view{ "RIFF\x02\x00\x00\x00" "ACONanih\x24\x00\x00\x00", 20 };
+
+	ASSERT_THAT([]()
+	{
+		animated_cursor{ "undersized.ani" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("does not have a RIFF header")));
+
+	std::ofstream{ "truncated.ani", std::ios::binary } << std::string_view{ "RIFF\x20\x00\x00\x00" "ACONanih\x24\x00\x00\x00", 20 };
+
+	ASSERT_THAT([]()
+	{
+		animated_cursor{ "truncated.ani" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Chunk \"anih\" is truncated!")));
+}
+
+TEST(animated_cursor, serialize_success)
+{
+	const animated_cursor           cursor = animated_cursor{ TEST_DATA_PATH "busy.ani" };
+	const std::vector<std::uint8_t> bytes  = cursor.serialize();
+
+	std::ofstream{ "optimized.ani", std::ios::binary }.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+	const animated_cursor optimized = animated_cursor{ "optimized.ani" };
+
+	EXPECT_GT(std::filesystem::file_size(TEST_DATA_PATH "busy.ani"), bytes.size());
+	ASSERT_EQ(2, optimized.get_frames().size());
+	EXPECT_TRUE(std::ranges::equal(cursor.get_frames()[1], optimized.get_frames()[1]));
+	EXPECT_THAT(optimized.get_sequence(), ElementsAre(0, 1, 0, 1));
+	EXPECT_EQ(bytes, optimized.serialize());
+}
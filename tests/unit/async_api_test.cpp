@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "async_api.cpp"
+
+#include <vector>
+
+#include "pe_image.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(async_api, load_icon_async_success)
+{
+	thread_pool_executor executor = thread_pool_executor{ 2 };
+	const icon           icon     = sync_wait(load_icon_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico"));
+
+	EXPECT_FALSE(icon.is_cursor());
+	EXPECT_EQ(1, icon.get_image_ranges().size());
+}
+
+TEST(async_api, apply_async_success)
+{
+	thread_pool_executor executor = thread_pool_executor{ 2 };
+
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_middle.exe", "async_1.exe", std::filesystem::copy_options::overwrite_existing);
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_middle.exe", "async_2.exe", std::filesystem::copy_options::overwrite_existing);
+
+	// Both tasks are awaited from one coroutine, each finishing on a thread of the executor.
+	const std::vector<apply_result> results = sync_wait([](thread_pool_executor& executor) -> task<std::vector<apply_result>>
+	{
+		task<apply_result> first  = apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico", "async_1.exe");
+		task<apply_result> second = apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico", "async_2.exe");
+
+		std::vector<apply_result> results = {};
+
+		results.push_back(co_await std::move(first));
+		results.push_back(co_await std::move(second));
+
+		co_return results;
+	}(executor));
+
+	ASSERT_EQ(2, results.size());
+
+	for (const std::string_view path : { std::string_view{ "async_1.exe" }, std::string_view{ "async_2.exe" } })
+	{
+		const resource_tree resources = pe_image{ path }.get_resources();
+
+		EXPECT_NE(nullptr, resources.find(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE));
+		EXPECT_EQ(results[0].new_size, std::filesystem::file_size(path));
+	}
+
+	EXPECT_EQ(std::filesystem::file_size(std::string{ TEST_DATA_PATH } + "rsrc_middle.exe"), results[0].old_size);
+}
+
+TEST(async_api, apply_async_fail)
+{
+	thread_pool_executor executor = thread_pool_executor{ 1 };
+
+	ASSERT_THAT([&executor]()
+	{
+		static_cast<void>(sync_wait(apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico", "missing.exe")));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("\"missing.exe\" does not exist!")));
+
+	ASSERT_THAT([&executor]()
+	{
+		static_cast<void>(sync_wait(apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.cur", std::string{ TEST_DATA_PATH } + "rsrc_middle.exe")));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("is a cursor, not an icon!")));
+}
+
+TEST(async_api, apply_async_options_success)
+{
+	thread_pool_executor executor = thread_pool_executor{ 1 };
+	const stamp_options  options  = { { std::string{ TEST_DATA_PATH } + "image1.cur" }, false, certificate_policy::strip, true };
+
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "signed.exe", "async_signed.exe", std::filesystem::copy_options::overwrite_existing);
+
+	ASSERT_THAT([&executor]()
+	{
+		static_cast<void>(sync_wait(apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico", "async_signed.exe")));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("is signed")));
+
+	// Cursors, the signature policy and the verification work like on the command line.
+	static_cast<void>(sync_wait(apply_async(executor, std::string{ TEST_DATA_PATH } + "image1.ico", "async_signed.exe", options)));
+
+	const pe_image      executable = pe_image{ "async_signed.exe" };
+	const resource_tree resources  = executable.get_resources();
+
+	EXPECT_FALSE(executable.has_certificates());
+	EXPECT_NE(nullptr, resources.find(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE));
+	EXPECT_NE(nullptr, resources.find(resource_type::group_cursor, "IMAGE1", resource_tree::NEUTRAL_LANGUAGE));
+}
+
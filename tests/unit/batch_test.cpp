@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "batch.cpp"
+
+#include <fstream>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(batch, read_jobs_success)
+{
+	std::ofstream{ "jobs.txt" } << "# icon\texecutable\r\n"
+	                               "a.ico\tfirst.exe\r\n"
+	                               "\n"
+	                               "b c.ico\tsecond target.exe\t4096\n";
+
+	const std::vector<job> jobs = read_jobs("jobs.txt");
+
+	ASSERT_EQ(2, jobs.size());
+	EXPECT_EQ("a.ico", jobs[0].icon_path);
+	EXPECT_EQ("first.exe", jobs[0].executable_path);
+	EXPECT_FALSE(jobs[0].size.has_value());
+	EXPECT_EQ("b c.ico", jobs[1].icon_path);
+	EXPECT_EQ("second target.exe", jobs[1].executable_path);
+	EXPECT_EQ(4096, jobs[1].size);
+}
+
+TEST(batch, read_jobs_fail)
+{
+	std::ofstream{ "bad_jobs.txt" } << "a.ico\tfirst.exe\n"
+	                                   "a.ico first.exe\n";
+	std::ofstream{ "bad_sizes.txt" } << "a.ico\tfirst.exe\t12\n"
+	                                    "a.ico\tsecond.exe\t12 KiB\n";
+
+	ASSERT_THAT([]()
+	{
+		read_jobs("bad_jobs.txt");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Line 2 of \"bad_jobs.txt\"")));
+
+	ASSERT_THAT([]()
+	{
+		read_jobs("bad_sizes.txt");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Line 2 of \"bad_sizes.txt\"")));
+
+	ASSERT_THAT([]()
+	{
+		read_jobs("invalid.txt");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Failed to open \"invalid.txt\"!")));
+}
+
+TEST(batch, coalesce_jobs_success)
+{
+	const std::vector<job> coalesced = coalesce_jobs({ { "a.ico", "first.exe", std::nullopt },
+	                                                   { "b.ico", "second.exe", std::nullopt },
+	                                                   { "c.ico", "./dir/../first.exe", std::nullopt },
+	                                                   { "d.ico", "first.exe", std::nullopt } });
+
+	ASSERT_EQ(2, coalesced.size());
+	EXPECT_EQ("d.ico", coalesced[0].icon_path);
+	EXPECT_EQ("first.exe", coalesced[0].executable_path);
+	EXPECT_EQ("b.ico", coalesced[1].icon_path);
+}
+
+TEST(batch, coalesce_jobs_size_success)
+{
+	const std::vector<job> coalesced = coalesce_jobs({ { "a.ico", "first.exe", 100 },
+	                                                   { "b.ico", "second.exe", std::nullopt },
+	                                                   { "c.ico", "first.exe", std::nullopt },
+	                                                   { "d.ico", "second.exe", 200 },
+	                                                   { "e.ico", "second.exe", 300 } });
+
+	// A later job without a size keeps the earlier one, a later size wins.
+	ASSERT_EQ(2, coalesced.size());
+	EXPECT_EQ("c.ico", coalesced[0].icon_path);
+	EXPECT_EQ(100, coalesced[0].size);
+	EXPECT_EQ("e.ico", coalesced[1].icon_path);
+	EXPECT_EQ(300, coalesced[1].size);
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "buffer_pool.cpp"
+
+#include "bitmap.hpp"
+#include "icon.hpp"
+#include "resource_backend.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(buffer_pool, recycle_success)
+{
+	buffer_pool pool = buffer_pool{};
+
+	void* const first = pool.allocate(5000);
+
+	pool.deallocate(first, 5000);
+
+	// Same class (8 KiB): the kept buffer is handed out again.
+	void* const second = pool.allocate(8192);
+
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(1, pool.get_upstream_allocations());
+
+	pool.deallocate(second, 8192);
+
+	// Stricter alignments bypass the pool.
+	void* const aligned = pool.allocate(5000, 8192);
+
+	pool.deallocate(aligned, 5000, 8192);
+	EXPECT_EQ(2, pool.get_upstream_allocations());
+}
+
+TEST(buffer_pool, steady_state_success)
+{
+	buffer_pool pool        = buffer_pool{};
+	std::size_t allocations = 0;
+
+	// Every job loads a cursor and a bitmap into its own arena.
+	for (std::size_t job = 0; job < 4; ++job)
+	{
+		std::pmr::monotonic_buffer_resource arena  = std::pmr::monotonic_buffer_resource{ &pool };
+		icon                                cursor = { TEST_DATA_PATH "image1.cur", false, &arena };
+		bitmap                              master = bitmap{ &arena };
+
+		ASSERT_TRUE(master.loadFromImage(TEST_DATA_PATH "valid_24bit.bmp"));
+		ASSERT_EQ(1, cursor.get_images().size());
+		EXPECT_EQ(&arena, cursor.get_images().front().get_allocator().resource());
+
+		if (0 == job)
+		{
+			allocations = pool.get_upstream_allocations();
+		}
+	}
+
+	EXPECT_EQ(allocations, pool.get_upstream_allocations());
+}
+
+TEST(buffer_pool, target_steady_state_success)
+{
+	buffer_pool pool        = buffer_pool{};
+	std::size_t allocations = 0;
+
+	// Every target is loaded, updated and laid out in its own arena.
+	for (std::size_t job = 0; job < 4; ++job)
+	{
+		std::pmr::monotonic_buffer_resource arena   = std::pmr::monotonic_buffer_resource{ &pool };
+		memory_backend                      backend = memory_backend{ TEST_DATA_PATH "rsrc_last.exe", &arena };
+
+		backend.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, std::vector<std::uint8_t>(0x1000, 0xAB));
+		backend.commit();
+
+		EXPECT_EQ(&arena, backend.get_image().get_bytes().get_allocator().resource());
+		EXPECT_EQ(&arena, backend.get_image().get_resources().find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE)->data.get_allocator().resource());
+
+		if (0 == job)
+		{
+			allocations = pool.get_upstream_allocations();
+		}
+	}
+
+	EXPECT_EQ(allocations, pool.get_upstream_allocations());
+}
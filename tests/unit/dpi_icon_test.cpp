@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "dpi_icon.cpp"
+
+#include "icon.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(dpi_icon, select_icon_sizes_success)
+{
+	const std::vector<std::uint32_t> scales   = parse_scales("100,125,150,200,250,300");
+	const std::vector<shell_context> contexts = parse_contexts("small,large,jumbo");
+
+	EXPECT_THAT(select_icon_sizes(scales, contexts), ElementsAre(16, 20, 24, 32, 40, 48, 64, 80, 96, 256));
+	EXPECT_THAT(select_icon_sizes(parse_scales("175"), parse_contexts("small")), ElementsAre(28));
+	EXPECT_THAT(select_icon_sizes(parse_scales("500"), parse_contexts("large,jumbo")), ElementsAre(160, 256));
+}
+
+TEST(dpi_icon, parse_fail)
+{
+	ASSERT_THAT([]()
+	{
+		parse_scales("100,90");
+	},
+	Throws<std::invalid_argument>());
+
+	ASSERT_THAT([]()
+	{
+		parse_scales("100,");
+	},
+	Throws<std::invalid_argument>());
+
+	ASSERT_THAT([]()
+	{
+		parse_contexts("small,huge");
+	},
+	Throws<std::invalid_argument>());
+}
+
+TEST(dpi_icon, write_dpi_icon_success)
+{
+	const std::vector<std::uint32_t> scales   = { 100, 150 };
+	const std::vector<shell_context> contexts = { shell_context::small, shell_context::large };
+
+	EXPECT_THAT(write_dpi_icon(TEST_DATA_PATH "valid_24bit.bmp", "dpi.ico", scales, contexts), ElementsAre(16, 24, 32, 48));
+	EXPECT_EQ(4, icon{ "dpi.ico" }.get_images().size());
+}
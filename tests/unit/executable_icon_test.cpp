@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "executable_icon.cpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Writes an executable with a single icon group.
+/// \param file_path: The path to the executable.
+/// \param icon_id: The RT_ICON identifier the group refers to.
+///
+static void write_donor(const std::string_view file_path,
+                        const std::uint16_t    icon_id)
+{
+	pe_image                  image  = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+	resource_tree             tree   = image.get_resources();
+	const icon::header        header = { 0, 1, 1 };
+	const icon::entry         entry  = { 32, 32, 0, 0, 1, 32, 3, icon_id };
+	std::vector<std::uint8_t> group  = std::vector<std::uint8_t>(sizeof(header) + sizeof(entry));
+
+	std::memcpy(group.data(), &header, sizeof(header));
+	std::memcpy(group.data() + sizeof(header), &entry, sizeof(entry));
+
+	tree.set(resource_type::icon, 7, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02, 0x03 });
+	tree.set(resource_type::icon, 7, 1033, { 0x04, 0x05, 0x06 });
+	tree.set(resource_type::group_icon, "APP", 1033, group);
+	tree.set(resource_type::group_icon, 9, resource_tree::NEUTRAL_LANGUAGE, { 0x00 });
+	image.set_resources(tree);
+	image.save(file_path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(executable_icon, constructor_success)
+{
+	write_donor("donor.exe", 7);
+
+	const executable_icon donor = executable_icon{ "donor.exe" };
+	icon::entry           entry = {};
+
+	// The named group comes first and its image is taken in its language.
+	ASSERT_EQ(1, donor.get_images().size());
+	EXPECT_THAT(donor.get_images()[0].get_bytes(), ElementsAre(0x04, 0x05, 0x06));
+	ASSERT_EQ(sizeof(icon::header) + sizeof(entry), donor.get_header().size());
+
+	std::memcpy(&entry, donor.get_header().data() + sizeof(icon::header), sizeof(entry));
+	EXPECT_EQ(1, entry.icon_id);
+	EXPECT_EQ(3, entry.resource_size);
+}
+
+TEST(executable_icon, constructor_fail)
+{
+	write_donor("broken_donor.exe", 8);
+
+	ASSERT_THAT([]()
+	{
+		executable_icon{ "broken_donor.exe" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Icon 8 of \"broken_donor.exe\" is missing!")));
+
+	ASSERT_THAT([]()
+	{
+		executable_icon{ TEST_DATA_PATH "rsrc_last.exe" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("has no icon!")));
+
+	ASSERT_THAT([]()
+	{
+		executable_icon{ TEST_DATA_PATH "no_rsrc.exe" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("has no resources!")));
+}
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "favicon_bundle.cpp"
+
+#include <filesystem>
+
+#include "icon.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(favicon_bundle, write_favicon_bundle_success)
+{
+	std::filesystem::remove_all("bundle");
+
+	const bundle_report first = write_favicon_bundle(TEST_DATA_PATH "valid_24bit.bmp", "bundle");
+
+	EXPECT_EQ(7, first.written);
+	EXPECT_EQ(0, first.unchanged);
+	EXPECT_EQ(3, icon{ "bundle/favicon.ico" }.get_images().size());
+	EXPECT_TRUE(std::filesystem::exists("bundle/android-chrome-512x512.png"));
+	EXPECT_TRUE(std::filesystem::exists("bundle/site.webmanifest"));
+
+	std::filesystem::resize_file("bundle/apple-touch-icon.png", 10);
+
+	const bundle_report second = write_favicon_bundle(TEST_DATA_PATH "valid_24bit.bmp", "bundle");
+
+	EXPECT_EQ(1, second.written);
+	EXPECT_EQ(6, second.unchanged);
+}
+
+TEST(favicon_bundle, write_favicon_bundle_fail)
+{
+	ASSERT_THAT([]()
+	{
+		write_favicon_bundle(TEST_DATA_PATH "invalid.bmp", "bundle");
+	},
+	Throws<std::invalid_argument>());
+}
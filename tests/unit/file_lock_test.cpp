@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "file_lock.cpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <thread>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(file_lock, constructor_open_fail)
+{
+	ASSERT_THAT([]()
+	{
+		const file_lock lock = file_lock{ "invalid.exe" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Failed to open \"invalid.exe\"!")));
+}
+
+TEST(file_lock, read_while_locked_success)
+{
+	std::ofstream{ "read_locked.exe" } << "contents";
+
+	const file_lock lock = file_lock{ "read_locked.exe" };
+	std::string     seen = {};
+
+	// The holder reads and rewrites the target through handles of its own.
+	std::getline(std::ifstream{ "read_locked.exe", std::ios::binary }, seen);
+
+	EXPECT_EQ("contents", seen);
+}
+
+TEST(file_lock, exclusive_success)
+{
+	std::ofstream{ "locked.exe" } << "old";
+
+	std::optional<file_lock> lock    = std::optional<file_lock>{ std::in_place, "locked.exe" };
+	std::atomic<bool>        entered = false;
+	std::string              seen    = {};
+
+	std::jthread waiter = std::jthread{ [&entered, &seen]()
+	{
+		const file_lock lock = file_lock{ "locked.exe" };
+
+		entered = true;
+		std::getline(std::ifstream{ "locked.exe" }, seen);
+	} };
+
+	std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+	EXPECT_FALSE(entered);
+
+	// Replace the file the same way saving does, the waiter must lock the new one.
+	std::ofstream{ "locked.exe.tmp" } << "new";
+	std::filesystem::rename("locked.exe.tmp", "locked.exe");
+	lock.reset();
+	waiter.join();
+
+	EXPECT_TRUE(entered);
+	EXPECT_EQ("new", seen);
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "file_writer.cpp"
+
+#include <fstream>
+#include <iterator>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(file_writer, copy_success)
+{
+	std::ofstream{ "source.bin", std::ios::binary } << "0123456789";
+
+	{
+		const mapped_file       source = mapped_file{ "source.bin" };
+		file_writer             writer = file_writer{ "target.bin" };
+		const std::vector<char> prefix = { 'a', 'b' };
+
+		writer.write({ reinterpret_cast<const std::uint8_t*>(prefix.data()), prefix.size() });
+		writer.copy(source, 3, 4);
+		writer.copy(source, 0, 1);
+	}
+
+	std::ifstream file = std::ifstream{ "target.bin", std::ios::binary };
+
+	EXPECT_EQ("ab34560", std::string(std::istreambuf_iterator<char>{ file }, {}));
+}
+
+TEST(file_writer, copy_fail)
+{
+	std::ofstream{ "source.bin", std::ios::binary } << "0123456789";
+
+	ASSERT_THAT([]()
+	{
+		const mapped_file source = mapped_file{ "source.bin" };
+		file_writer       writer = file_writer{ "target.bin" };
+
+		writer.copy(source, 8, 4);
+	},
+	ThrowsMessage<std::logic_error>(HasSubstr("Range 8+4 is outside of the source")));
+
+	ASSERT_THAT([]()
+	{
+		file_writer{ "missing/target.bin" };
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("Failed to create \"missing/target.bin\"!")));
+}
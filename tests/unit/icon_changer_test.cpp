@@ -90,6 +90,34 @@ TEST(icon_changer, change_icon_cli_inexistent_exe_fail)
 	ThrowsMessage<std::invalid_argument>(HasSubstr(std::format("\"{}\" does not exist!", EXE_PATH))));
 }
 
+TEST(icon_changer, change_icon_cli_broken_io_config_success)
+{
+	const std::string icon_path   = std::string{ TEST_DATA_PATH } + "image1.ico";
+	const char*       arguments[] = { "icon-changer.exe", icon_path.c_str(), "inexistent.exe" };
+
+	std::ofstream{ "broken_io.conf" } << "not a threshold\n";
+#ifdef _WIN32
+	_putenv_s("ICON_CHANGER_IO_CONFIG", "broken_io.conf");
+#else
+	setenv("ICON_CHANGER_IO_CONFIG", "broken_io.conf", 1);
+#endif
+
+	// The configuration is ignored, the mode runs and reports its own error.
+	ASSERT_THAT([&]()
+	{
+		change_icon_cli(sizeof(arguments) / sizeof(arguments[0]), arguments);
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("\"inexistent.exe\" does not exist!")));
+
+	EXPECT_EQ(get_default_io_thresholds().map_size, get_io_thresholds().map_size);
+
+#ifdef _WIN32
+	_putenv_s("ICON_CHANGER_IO_CONFIG", "");
+#else
+	unsetenv("ICON_CHANGER_IO_CONFIG");
+#endif
+}
+
 TEST(icon_changer, change_icon_gui)
 {
 	ASSERT_THAT([]()
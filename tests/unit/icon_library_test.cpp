@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "icon_library.cpp"
+
+#include <filesystem>
+#include <limits>
+
+#include "io_strategy.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(icon_library, write_icon_library_success)
+{
+	std::filesystem::remove_all("icon_library");
+	std::filesystem::create_directories("icon_library/nested");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "icon_library/b.ico");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "icon_library/nested/a.ICO");
+	std::filesystem::copy_file(TEST_DATA_PATH "valid_24bit.bmp", "icon_library/ignored.bmp");
+
+	const library_report report    = write_icon_library("icon_library", "icon_library.dll");
+	const pe_image       library   = pe_image{ "icon_library.dll" };
+	const resource_tree  resources = library.get_resources();
+	icon::entry          entry     = {};
+
+	EXPECT_EQ(2, report.groups);
+	EXPECT_EQ(2, report.images);
+	EXPECT_EQ(1, report.unique_images);
+	EXPECT_EQ(std::filesystem::file_size("icon_library.dll"), report.size);
+
+	ASSERT_EQ(3, resources.size());
+	ASSERT_NE(nullptr, resources.find(resource_type::group_icon, 2, resource_tree::NEUTRAL_LANGUAGE));
+	std::memcpy(&entry, resources.find(resource_type::group_icon, 2, resource_tree::NEUTRAL_LANGUAGE)->data.data() + sizeof(icon::header), sizeof(entry));
+	EXPECT_EQ(1, entry.icon_id);
+	EXPECT_EQ(0x10A8, resources.find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE)->data.size());
+	EXPECT_EQ(".rsrc", library.get_sections().front().name);
+	EXPECT_EQ(0x1000, library.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva);
+
+	// The library only depends on the icons.
+	write_icon_library("icon_library", "icon_library_2.dll");
+
+	EXPECT_EQ(sha256::to_string(sha256::hash_file("icon_library.dll")), sha256::to_string(sha256::hash_file("icon_library_2.dll")));
+}
+
+TEST(icon_library, write_icon_library_read_success)
+{
+	std::filesystem::remove_all("read_library");
+	std::filesystem::create_directories("read_library");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "read_library/a.ico");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "read_library/b.ico");
+
+	const library_report mapped = write_icon_library("read_library", "read_library_mapped.dll");
+
+	// No file is small enough to be mapped, so the images are read.
+	io_thresholds thresholds = get_default_io_thresholds();
+
+	thresholds.map_size.fill(std::numeric_limits<std::uint64_t>::max());
+	set_io_thresholds(thresholds);
+
+	const library_report read = write_icon_library("read_library", "read_library_read.dll");
+
+	set_io_thresholds(get_default_io_thresholds());
+
+	EXPECT_EQ(mapped.images, read.images);
+	EXPECT_EQ(mapped.unique_images, read.unique_images);
+	EXPECT_EQ(0x10A8, pe_image{ "read_library_read.dll" }.get_resources().find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE)->data.size());
+	EXPECT_EQ(sha256::to_string(sha256::hash_file("read_library_mapped.dll")), sha256::to_string(sha256::hash_file("read_library_read.dll")));
+}
+
+TEST(icon_library, write_icon_library_fail)
+{
+	std::filesystem::remove_all("empty_library");
+	std::filesystem::create_directories("empty_library");
+
+	ASSERT_THAT([]()
+	{
+		write_icon_library("empty_library", "empty_library.dll");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("\"empty_library\" has no icons!")));
+
+	std::filesystem::copy_file(TEST_DATA_PATH "image_incomplete.ico", "empty_library/broken.ico");
+
+	ASSERT_THAT([]()
+	{
+		write_icon_library("empty_library", "empty_library.dll");
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("1 of 1 icon(s) failed!")));
+}
@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "icon_splitter.cpp"
+
+#include <fstream>
+
+#include "bitmap.hpp"
+#include "rgba_image.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(icon_splitter, split_icon_success)
+{
+	std::filesystem::remove_all("split");
+
+	const std::vector<std::string> written = split_icon(TEST_DATA_PATH "image1.ico", "split");
+	bitmap                         bmp     = {};
+
+	ASSERT_THAT(written, ElementsAre((std::filesystem::path{ "split" } / "image1_32x32_32bit.bmp").string()));
+	ASSERT_TRUE(bmp.loadFromImage(written[0]));
+	EXPECT_EQ(32, bmp.getWidth());
+	EXPECT_EQ(32, bmp.getHeight());
+	EXPECT_EQ(32 * 32 * 4, bmp.getPixels().size());
+}
+
+TEST(icon_splitter, split_icon_png_success)
+{
+	const std::vector<rgba_image>   images = { rgba_image{ 256, 256, std::vector<std::uint8_t>(256 * 256 * 4, 0x40) },
+	                                           rgba_image{ 256, 256, std::vector<std::uint8_t>(256 * 256 * 4, 0x80) } };
+	const std::vector<std::uint8_t> ico    = rgba_image::encode_ico(images);
+
+	std::ofstream{ "large.ico", std::ios::binary }.write(reinterpret_cast<const char*>(ico.data()), static_cast<std::streamsize>(ico.size()));
+
+	const std::vector<std::string> written = split_icon("large.ico", "split");
+
+	ASSERT_EQ(2, written.size());
+	EXPECT_THAT(written[0], EndsWith("large_256x256_32bit.png"));
+	EXPECT_THAT(written[1], EndsWith("large_256x256_32bit_1.png"));
+	EXPECT_EQ(images[1].to_png().size(), std::filesystem::file_size(written[1]));
+}
+
+TEST(icon_splitter, split_icon_fail)
+{
+	ASSERT_THAT([]()
+	{
+		split_icon(TEST_DATA_PATH "header_type_ffff.ico", "split");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("is not an ICO or CUR file!")));
+
+	ASSERT_THAT([]()
+	{
+		split_icon(TEST_DATA_PATH "image_incomplete.ico", "split");
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("is outside of the file!")));
+}
+
+TEST(icon_splitter, split_icons_cli_success)
+{
+	std::filesystem::remove_all("library");
+	std::filesystem::remove_all("split_library");
+	std::filesystem::create_directories("library/nested");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "library/first.ico");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.cur", "library/nested/second.CUR");
+
+	split_icons_cli("library", "split_library");
+
+	EXPECT_TRUE(std::filesystem::exists("split_library/first_32x32_32bit.bmp"));
+	EXPECT_TRUE(std::filesystem::exists("split_library/nested/second_32x32_32bit.bmp"));
+}
+
+TEST(icon_splitter, split_icons_cli_same_stem_success)
+{
+	std::filesystem::remove_all("same_stem");
+	std::filesystem::remove_all("split_same_stem");
+	std::filesystem::create_directories("same_stem");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.ico", "same_stem/app.ico");
+	std::filesystem::copy_file(TEST_DATA_PATH "image1.cur", "same_stem/app.cur");
+
+	split_icons_cli("same_stem", "split_same_stem");
+
+	EXPECT_TRUE(std::filesystem::exists("split_same_stem/app_ico_32x32_32bit.bmp"));
+	EXPECT_TRUE(std::filesystem::exists("split_same_stem/app_cur_32x32_32bit.bmp"));
+	EXPECT_FALSE(std::filesystem::exists("split_same_stem/app_32x32_32bit.bmp"));
+}
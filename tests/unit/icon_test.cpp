@@ -20,8 +20,11 @@
 
 #include "icon.cpp"
 
+#include <fstream>
 #include <stdexcept>
 
+#include "rgba_image.hpp"
+
 using namespace testing;
 using namespace icon_changer;
 
@@ -64,7 +67,7 @@ TEST(icon, constructor_header_cur_fail)
 	{
 		icon icon = { std::string{ TEST_DATA_PATH } + "header_cur.ico" };
 	},
-	ThrowsMessage<std::invalid_argument>(HasSubstr("Image is of CUR type, not ICO!")));
+	ThrowsMessage<std::runtime_error>(HasSubstr("Failed to read icon entry data from file.")));
 }
 
 TEST(icon, constructor_header_type_fail)
@@ -123,10 +126,10 @@ TEST(icon, constructor_image_incomplete_fail)
 
 TEST(icon, get_success)
 {
-	icon                                    icon            = { std::string{ TEST_DATA_PATH } + "image1.ico" };
-	const std::vector<std::uint8_t>         header          = icon.get_header();
-	std::vector<std::vector<std::uint8_t>>& images          = icon.get_images();
-	const std::vector<std::uint8_t>         expected_header = { 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x20, 0x20, 0x00, 0x00, 0x01, 0x00,
+	icon                                              icon            = { std::string{ TEST_DATA_PATH } + "image1.ico" };
+	const std::vector<std::uint8_t>                   header          = icon.get_header();
+	std::pmr::vector<std::pmr::vector<std::uint8_t>>& images          = icon.get_images();
+	const std::vector<std::uint8_t>                   expected_header = { 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x20, 0x20, 0x00, 0x00, 0x01, 0x00,
 																0x20, 0x00, 0xA8, 0x10, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
 
 	EXPECT_EQ(22, header.size());
@@ -136,3 +139,83 @@ TEST(icon, get_success)
 	EXPECT_EQ(0x10A8, images.front().size());
 	// TODO: check the content of the image
 }
+
+TEST(icon, get_mapped_success)
+{
+	icon       copied = { std::string{ TEST_DATA_PATH } + "image1.ico" };
+	const icon mapped = { std::string{ TEST_DATA_PATH } + "image1.ico", true };
+
+	ASSERT_EQ(1, mapped.get_image_ranges().size());
+	EXPECT_EQ(copied.get_header(), mapped.get_header());
+	EXPECT_EQ(sizeof(icon::header) + sizeof(icon::icon_entry), mapped.get_image_ranges().front().offset);
+	EXPECT_THAT(mapped.get_image_ranges().front().get_bytes(), ElementsAreArray(copied.get_images().front()));
+	EXPECT_TRUE((icon{ std::string{ TEST_DATA_PATH } + "image1.cur", true }.get_image_ranges().empty()));
+}
+
+TEST(icon, get_reordered_success)
+{
+	icon                                 first   = { std::string{ TEST_DATA_PATH } + "image1.ico" };
+	icon                                 copied  = { std::string{ TEST_DATA_PATH } + "image_reordered.ico" };
+	const icon                           mapped  = { std::string{ TEST_DATA_PATH } + "image_reordered.ico", true };
+	const std::pmr::vector<std::uint8_t> payload = first.get_images().front();
+
+	// The payloads are stored in the opposite order of their entries.
+	ASSERT_EQ(2, copied.get_images().size());
+	ASSERT_EQ(2, mapped.get_image_ranges().size());
+	EXPECT_THAT(copied.get_images()[0], ElementsAreArray(payload));
+	EXPECT_THAT(mapped.get_image_ranges()[0].get_bytes(), ElementsAreArray(payload));
+	EXPECT_EQ(payload.back() ^ 0xFF, copied.get_images()[1].back());
+	EXPECT_THAT(mapped.get_image_ranges()[1].get_bytes(), ElementsAreArray(copied.get_images()[1]));
+}
+
+TEST(icon, get_cursor_success)
+{
+	icon                                              cursor = { std::string{ TEST_DATA_PATH } + "image1.cur" };
+	const std::vector<std::uint8_t>                   header = cursor.get_header();
+	std::pmr::vector<std::pmr::vector<std::uint8_t>>& images = cursor.get_images();
+	icon::cursor_entry                                entry  = {};
+
+	ASSERT_TRUE(cursor.is_cursor());
+	ASSERT_EQ(sizeof(icon::header) + sizeof(entry), header.size());
+	std::memcpy(&entry, header.data() + sizeof(icon::header), sizeof(entry));
+
+	EXPECT_EQ(0x0002, header[2]);
+	EXPECT_EQ(32, entry.width);
+	EXPECT_EQ(64, entry.height);
+	EXPECT_EQ(1, entry.planes);
+	EXPECT_EQ(32, entry.bit_count);
+	EXPECT_EQ(0x10A8 + sizeof(icon::hotspot), entry.resource_size);
+	EXPECT_EQ(1, entry.cursor_id);
+
+	ASSERT_EQ(1, images.size());
+	ASSERT_EQ(0x10A8 + sizeof(icon::hotspot), images.front().size());
+	EXPECT_EQ((std::vector<std::uint8_t>{ 0x05, 0x00, 0x07, 0x00, 0x28 }), std::vector<std::uint8_t>(images.front().begin(), images.front().begin() + 5));
+
+	cursor.renumber(7);
+	std::memcpy(&entry, cursor.get_header().data() + sizeof(icon::header), sizeof(entry));
+	EXPECT_EQ(7, entry.cursor_id);
+}
+
+TEST(icon, find_best_entry_success)
+{
+	const std::vector<rgba_image> images = { rgba_image{ 16, 16, std::vector<std::uint8_t>(16 * 16 * 4, 0xFF) },
+	                                         rgba_image{ 16, 16, std::vector<std::uint8_t>(16 * 16 * 4, 0xFF) },
+	                                         rgba_image{ 32, 32, std::vector<std::uint8_t>(32 * 32 * 4, 0xFF) },
+	                                         rgba_image{ 256, 256, std::vector<std::uint8_t>(256 * 256 * 4, 0xFF) } };
+	std::vector<std::uint8_t>     bytes  = rgba_image::encode_ico(images);
+
+	// The first entry claims 8 bits per pixel, the 256 pixels one is a PNG with no size in its entry.
+	bytes[sizeof(icon::header) + offsetof(icon::icon_entry, bit_count)] = 8;
+	std::ofstream{ "best_entry.ico", std::ios::binary }.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+	const icon read   = { "best_entry.ico" };
+	const icon mapped = { "best_entry.ico", true };
+
+	EXPECT_EQ(1, read.find_best_entry(16, 16));
+	EXPECT_EQ(0, read.find_best_entry(16, 16, 8));
+	EXPECT_EQ(2, read.find_best_entry(24, 24));
+	EXPECT_EQ(2, read.find_best_entry(48, 48));
+	EXPECT_EQ(3, read.find_best_entry(200, 200));
+	EXPECT_EQ(3, mapped.find_best_entry(256, 256));
+	EXPECT_EQ(0, icon{ std::string{ TEST_DATA_PATH } + "image1.cur" }.find_best_entry(16, 16));
+}
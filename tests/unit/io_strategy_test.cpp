@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "io_strategy.cpp"
+
+#include "bitmap.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(io_strategy, thresholds_success)
+{
+	const std::string   valid_path = std::string{ TEST_DATA_PATH } + "valid_24bit.bmp";
+	const std::size_t   kind       = static_cast<std::size_t>(detect_filesystem(valid_path));
+	const std::uint64_t size       = std::filesystem::file_size(valid_path);
+	io_thresholds       thresholds = get_default_io_thresholds();
+	bitmap              mapped     = {};
+	bitmap              buffered   = {};
+
+	thresholds.map_size[kind]    = size;
+	thresholds.splice_size[kind] = 4096;
+	set_io_thresholds(thresholds);
+
+	EXPECT_EQ(read_method::mapped, select_read_method(valid_path));
+	EXPECT_EQ(read_method::buffered, select_read_method("missing.bmp"));
+	EXPECT_TRUE(should_splice(static_cast<filesystem_kind>(kind), 4096));
+	EXPECT_FALSE(should_splice(static_cast<filesystem_kind>(kind), 4095));
+	ASSERT_TRUE(mapped.loadFromImage(valid_path));
+
+	thresholds.map_size[kind] = size + 1;
+	set_io_thresholds(thresholds);
+
+	EXPECT_EQ(read_method::buffered, select_read_method(valid_path));
+	ASSERT_TRUE(buffered.loadFromImage(valid_path));
+
+	// Both methods read the same pixels.
+	EXPECT_EQ(mapped.getPixels(), buffered.getPixels());
+
+	set_io_thresholds(get_default_io_thresholds());
+}
+
+TEST(io_strategy, config_success)
+{
+	io_thresholds thresholds = get_default_io_thresholds();
+
+	thresholds.map_size[static_cast<std::size_t>(filesystem_kind::local)]      = 262144;
+	thresholds.splice_size[static_cast<std::size_t>(filesystem_kind::overlay)] = UINT64_MAX;
+
+	write_io_thresholds("io_config/io.conf", thresholds);
+
+	const io_thresholds read = read_io_thresholds("io_config/io.conf");
+
+	EXPECT_EQ(thresholds.map_size, read.map_size);
+	EXPECT_EQ(thresholds.splice_size, read.splice_size);
+
+	// Missing keys keep their defaults.
+	std::ofstream{ "io_config/partial.conf" } << "# Comment\n\nmap_size.network = 1024\n";
+
+	EXPECT_EQ(1024, read_io_thresholds("io_config/partial.conf").map_size[static_cast<std::size_t>(filesystem_kind::network)]);
+	EXPECT_EQ(get_default_io_thresholds().map_size[0], read_io_thresholds("io_config/partial.conf").map_size[0]);
+
+	std::filesystem::remove_all("io_config");
+}
+
+TEST(io_strategy, config_fail)
+{
+	std::filesystem::create_directories("io_config");
+
+	std::ofstream{ "io_config/kind.conf" } << "map_size.floppy = 1024\n";
+	std::ofstream{ "io_config/size.conf" } << "splice_size.local = big\n";
+
+	ASSERT_THAT([]()
+	{
+		static_cast<void>(read_io_thresholds("io_config/kind.conf"));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("unknown threshold \"map_size.floppy\"!")));
+
+	ASSERT_THAT([]()
+	{
+		static_cast<void>(read_io_thresholds("io_config/size.conf"));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("invalid size \"big\"!")));
+
+	std::filesystem::remove_all("io_config");
+}
+
+TEST(io_strategy, calibrate_io_success)
+{
+	static constexpr std::array<std::uint64_t, 9> VALID = { 0, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20, 1 << 22, 1 << 24, UINT64_MAX };
+
+	const io_thresholds defaults   = get_default_io_thresholds();
+	const std::size_t   kind       = static_cast<std::size_t>(detect_filesystem("."));
+	const io_thresholds calibrated = calibrate_io(".", defaults);
+
+	EXPECT_THAT(VALID, Contains(calibrated.map_size[kind]));
+	EXPECT_THAT(VALID, Contains(calibrated.splice_size[kind]));
+
+	// Other file systems are kept, the process thresholds restored and the test files removed.
+	for (std::size_t index = 0; index < FILESYSTEM_KIND_COUNT; ++index)
+	{
+		if (kind != index)
+		{
+			EXPECT_EQ(defaults.map_size[index], calibrated.map_size[index]);
+		}
+	}
+
+	EXPECT_EQ(defaults.splice_size, get_io_thresholds().splice_size);
+	EXPECT_FALSE(std::filesystem::exists("icon-changer-calibration.bin"));
+	EXPECT_FALSE(std::filesystem::exists("icon-changer-calibration.out"));
+}
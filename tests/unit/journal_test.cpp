@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "journal.cpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Writes a file.
+/// \param file_path: The path to the file.
+/// \param contents: The contents.
+///
+static void write_file(const std::string_view file_path,
+                       const std::string_view contents)
+{
+	std::ofstream{ std::string{ file_path }, std::ios::binary } << contents;
+}
+
+///
+/// \brief Records a target as it is on disk.
+/// \param completed: The journal.
+/// \param target_path: The path to the target.
+/// \param input: The hash of what was stamped into the target.
+///
+static void record_file(journal&              completed,
+                        const std::string&    target_path,
+                        const sha256::digest& input)
+{
+	completed.record(target_path, input, sha256::hash_file(target_path), std::filesystem::file_size(target_path));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(journal, resume_success)
+{
+	const sha256::digest input = sha256::hash(std::vector<std::uint8_t>{ 1, 2, 3 });
+	const sha256::digest other = sha256::hash(std::vector<std::uint8_t>{ 4, 5, 6 });
+
+	std::filesystem::remove("resume.journal");
+	write_file("resume_1.exe", "stamped 1");
+	write_file("resume_2.exe", "stamped 2");
+
+	{
+		journal completed = journal{ "resume.journal" };
+
+		EXPECT_FALSE(completed.is_complete("resume_1.exe", input));
+
+		record_file(completed, "resume_1.exe", input);
+		record_file(completed, "resume_2.exe", input);
+	}
+
+	// The second target is changed after its update, the third never done.
+	write_file("resume_2.exe", "stamped 2 and changed");
+
+	const journal reopened = journal{ "resume.journal" };
+
+	EXPECT_TRUE(reopened.is_complete("resume_1.exe", input));
+	EXPECT_FALSE(reopened.is_complete("resume_1.exe", other));
+	EXPECT_FALSE(reopened.is_complete("resume_2.exe", input));
+	EXPECT_FALSE(reopened.is_complete("resume_3.exe", input));
+}
+
+TEST(journal, torn_line_success)
+{
+	const sha256::digest input = sha256::hash(std::vector<std::uint8_t>{ 1, 2, 3 });
+
+	write_file("torn_1.exe", "stamped 1");
+	write_file("torn_2.exe", "stamped 2");
+
+	{
+		journal completed = journal{ "torn.journal" };
+
+		record_file(completed, "torn_1.exe", input);
+	}
+
+	// A crash in the middle of a line.
+	std::ofstream{ "torn.journal", std::ios::binary | std::ios::app } << sha256::to_string(input).substr(0, 20);
+
+	{
+		journal completed = journal{ "torn.journal" };
+
+		EXPECT_TRUE(completed.is_complete("torn_1.exe", input));
+
+		record_file(completed, "torn_2.exe", input);
+	}
+
+	const journal reopened = journal{ "torn.journal" };
+
+	EXPECT_TRUE(reopened.is_complete("torn_1.exe", input));
+	EXPECT_TRUE(reopened.is_complete("torn_2.exe", input));
+
+	std::filesystem::remove("torn.journal");
+}
+
+TEST(journal, unreadable_target_success)
+{
+	const sha256::digest input = sha256::hash(std::vector<std::uint8_t>{ 1, 2, 3 });
+
+	std::filesystem::remove("unreadable.journal");
+	std::filesystem::remove_all("unreadable_1.exe");
+	write_file("unreadable_1.exe", "stamped 1");
+	write_file("unreadable_2.exe", "stamped 2");
+
+	{
+		journal completed = journal{ "unreadable.journal" };
+
+		record_file(completed, "unreadable_1.exe", input);
+		record_file(completed, "unreadable_2.exe", input);
+	}
+
+	// The targets are gone or replaced by something that cannot be hashed.
+	std::filesystem::remove("unreadable_1.exe");
+	std::filesystem::create_directory("unreadable_1.exe");
+	std::filesystem::remove("unreadable_2.exe");
+
+	const journal reopened = journal{ "unreadable.journal" };
+
+	EXPECT_FALSE(reopened.is_complete("unreadable_1.exe", input));
+	EXPECT_FALSE(reopened.is_complete("unreadable_2.exe", input));
+
+	std::filesystem::remove("unreadable_1.exe");
+	std::filesystem::remove("unreadable.journal");
+}
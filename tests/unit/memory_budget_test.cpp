@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "memory_budget.cpp"
+
+#include <fstream>
+
+#include "bitmap.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(memory_budget, reservation_success)
+{
+	const memory_limits defaults = get_memory_limits();
+
+	set_memory_limits({ 100, 150 });
+
+	{
+		memory_reservation first = { 60, "First" };
+
+		first.grow(40, "First");
+
+		const memory_reservation moved = std::move(first);
+
+		EXPECT_EQ(0, first.get_size());
+		EXPECT_EQ(100, moved.get_size());
+
+		// Per-file cap, then what is left of the per-process cap.
+		EXPECT_THAT([]()
+		{
+			const memory_reservation second = memory_reservation(101, "Second");
+		},
+		ThrowsMessage<std::invalid_argument>(HasSubstr("allowed per file!")));
+
+		EXPECT_THAT([&moved]()
+		{
+			const memory_reservation copy = moved;
+		},
+		ThrowsMessage<std::runtime_error>(HasSubstr("only 50 of the 150 bytes")));
+	}
+
+	// Released with the reservations.
+	EXPECT_EQ(100, memory_reservation(100, "Third").get_size());
+
+	set_memory_limits(defaults);
+}
+
+TEST(memory_budget, checked_multiply_fail)
+{
+	EXPECT_EQ(12, checked_multiply(3, 4, "Pixels"));
+
+	ASSERT_THAT([]()
+	{
+		static_cast<void>(checked_multiply(UINT64_MAX / 2, 3, "Pixels"));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("too large!")));
+}
+
+TEST(memory_budget, bitmap_declared_size_fail)
+{
+	std::vector<char> bytes = std::vector<char>(54);
+	bitmap            bmp   = {};
+
+	// A 24-bit 0x7FFFFFFF x 0x7FFFFFFF header with no pixels behind it.
+	bytes[0] = 'B';
+	bytes[1] = 'M';
+	bytes[10] = 54;
+	bytes[14] = 40;
+	bytes[18] = bytes[19] = bytes[20] = bytes[22] = bytes[23] = bytes[24] = static_cast<char>(0xFF);
+	bytes[21] = bytes[25] = 0x7F;
+	bytes[26] = 1;
+	bytes[28] = 24;
+	std::ofstream{ "hostile.bmp", std::ios::binary }.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+	ASSERT_THAT([&bmp]()
+	{
+		bmp.loadFromImage("hostile.bmp");
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("smaller than its pixels")));
+
+	EXPECT_TRUE(bmp.getPixels().empty());
+}
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+#include "metrics.cpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Reads a file.
+/// \param file_path: The path to the file.
+/// \returns The contents.
+///
+static std::string read_file(const std::string_view file_path)
+{
+	std::ifstream     file     = std::ifstream{ std::string{ file_path }, std::ios::binary };
+	std::stringstream contents = {};
+
+	contents << file.rdbuf();
+
+	return contents.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(metrics, counters_success)
+{
+	static constexpr std::size_t THREAD_COUNT = 8;
+
+	const std::uint64_t before = get_total(counter::jobs_changed);
+
+	// Threads of each round reuse the shards returned by the previous one.
+	for (std::size_t round = 0; round < 4; ++round)
+	{
+		std::vector<std::jthread> threads = {};
+
+		for (std::size_t index = 0; index < THREAD_COUNT; ++index)
+		{
+			threads.emplace_back([]()
+			{
+				for (std::size_t count = 0; count < 1000; ++count)
+				{
+					add(counter::jobs_changed);
+				}
+			});
+		}
+	}
+
+	EXPECT_EQ(before + 4 * THREAD_COUNT * 1000, get_total(counter::jobs_changed));
+	EXPECT_GE(THREAD_COUNT + 1, all_shards.size());
+}
+
+TEST(metrics, format_success)
+{
+	add(counter::jobs_queued, 3);
+	add(counter::stamp_hits, 2);
+	observe(stage::journal, std::chrono::milliseconds{ 3 });
+	observe(stage::journal, std::chrono::seconds{ 30 });
+
+	const std::string text = format_metrics();
+
+	EXPECT_THAT(text, HasSubstr("# TYPE icon_changer_batch_jobs_total counter\n"));
+	EXPECT_THAT(text, HasSubstr("# TYPE icon_changer_stage_duration_seconds histogram\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stamp_cache_requests_total{result=\"hit\"} 2\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_bucket{stage=\"journal\",le=\"0.0025\"} 0\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_bucket{stage=\"journal\",le=\"0.005\"} 1\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_bucket{stage=\"journal\",le=\"10\"} 1\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_bucket{stage=\"journal\",le=\"+Inf\"} 2\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_sum{stage=\"journal\"} 30.003\n"));
+	EXPECT_THAT(text, HasSubstr("icon_changer_stage_duration_seconds_count{stage=\"journal\"} 2\n"));
+}
+
+TEST(metrics, exporter_success)
+{
+	std::filesystem::remove("metrics_test.prom");
+
+	{
+		const metrics_exporter exporter = { "metrics_test.prom", std::chrono::milliseconds{ 10 } };
+
+		EXPECT_TRUE(std::filesystem::exists("metrics_test.prom"));
+
+		add(counter::sections_appended, 5);
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+	}
+
+	EXPECT_THAT(read_file("metrics_test.prom"), HasSubstr(std::format("icon_changer_resource_sections_total{{placement=\"appended\"}} {}\n", get_total(counter::sections_appended))));
+	EXPECT_FALSE(std::filesystem::exists("metrics_test.prom.tmp"));
+}
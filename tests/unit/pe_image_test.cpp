@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "pe_image.cpp"
+
+#include <filesystem>
+
+#include "icon.hpp"
+#include "sha256.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// HELPERS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Stamps image1.ico into a copy of a test executable, the same way the
+/// CLI does it.
+/// \param source: The name of the executable in the test data.
+/// \param target: The path of the stamped copy.
+/// \returns The stamped image.
+///
+static pe_image stamp(const std::string_view source,
+                      const std::string_view target)
+{
+	icon icon = { std::string{ TEST_DATA_PATH } + "image1.ico" };
+
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + std::string{ source }, target, std::filesystem::copy_options::overwrite_existing);
+
+	pe_image      executable = pe_image{ target };
+	resource_tree resources  = executable.get_resources();
+	std::uint16_t id         = 0;
+
+	for (const std::pmr::vector<std::uint8_t>& image : icon.get_images())
+	{
+		resources.set(resource_type::icon, ++id, resource_tree::NEUTRAL_LANGUAGE, { image.begin(), image.end() });
+	}
+
+	resources.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, icon.get_header());
+	executable.set_resources(resources);
+	executable.save(target);
+
+	return executable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(pe_image, constructor_open_fail)
+{
+	static constexpr std::string_view INVALID_PATH = "invalid.exe";
+
+	ASSERT_THAT([]()
+	{
+		pe_image executable = pe_image{ INVALID_PATH };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr(std::format("Failed to open \"{}\"!", INVALID_PATH))));
+}
+
+TEST(pe_image, constructor_not_pe_fail)
+{
+	ASSERT_THAT([]()
+	{
+		pe_image executable = pe_image{ std::string{ TEST_DATA_PATH } + "image1.ico" };
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("Executable does not have a DOS header!")));
+}
+
+TEST(pe_image, get_resources_success)
+{
+	const pe_image      executable = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+	const resource_tree resources  = executable.get_resources();
+
+	ASSERT_EQ(1, resources.size());
+	ASSERT_NE(nullptr, resources.find(10, 1, 0x0409));
+	EXPECT_EQ("fixture resource", std::string(resources.find(10, 1, 0x0409)->data.begin(), resources.find(10, 1, 0x0409)->data.end()));
+	EXPECT_EQ(0, pe_image{ std::string{ TEST_DATA_PATH } + "no_rsrc.exe" }.get_resources().size());
+}
+
+TEST(pe_image, set_resources_in_place_success)
+{
+	pe_image      executable = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+	resource_tree resources  = executable.get_resources();
+	const auto    size       = executable.get_bytes().size();
+
+	resources.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02 });
+	executable.set_resources(resources);
+
+	EXPECT_EQ(size, executable.get_bytes().size());
+	EXPECT_EQ(2, executable.get_sections().size());
+	EXPECT_EQ(2, executable.get_resources().size());
+}
+
+TEST(pe_image, set_resources_grow_last_success)
+{
+	const pe_image executable = stamp("rsrc_last.exe", "stamped_last.exe");
+	const pe_image reloaded   = pe_image{ "stamped_last.exe" };
+	std::uint32_t  checksum   = 0;
+
+	// The fixtures have the NT headers at 0x40, followed by the signature and IMAGE_FILE_HEADER.
+	std::memcpy(&checksum, reloaded.get_bytes().data() + 0x40 + sizeof(std::uint32_t) + sizeof(file_header) + CHECKSUM_OFFSET, sizeof(checksum));
+
+	EXPECT_EQ(2, reloaded.get_sections().size());
+	EXPECT_EQ(3, reloaded.get_resources().size());
+	EXPECT_EQ(reloaded.get_sections().back().virtual_address, reloaded.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva);
+	EXPECT_EQ(reloaded.compute_checksum(), checksum);
+	EXPECT_EQ(0, reloaded.get_bytes().size() % 0x200);
+}
+
+TEST(pe_image, set_resources_append_section_success)
+{
+	const pe_image middle = stamp("rsrc_middle.exe", "stamped_middle.exe");
+	const pe_image none   = stamp("no_rsrc.exe", "stamped_none.exe");
+
+	ASSERT_EQ(4, middle.get_sections().size());
+	EXPECT_EQ(".rsrc", middle.get_sections().back().name);
+	EXPECT_EQ(middle.get_sections().back().virtual_address, middle.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva);
+	EXPECT_EQ(3, pe_image{ "stamped_middle.exe" }.get_resources().size());
+	EXPECT_EQ(0x4000, middle.get_sections().back().virtual_address);
+
+	ASSERT_EQ(2, none.get_sections().size());
+	EXPECT_EQ(2, pe_image{ "stamped_none.exe" }.get_resources().size());
+}
+
+TEST(pe_image, compact_resources_abandoned_success)
+{
+	pe_image            executable = stamp("rsrc_middle.exe", "compact_abandoned.exe");
+	const resource_tree resources  = executable.get_resources();
+	const std::size_t   size       = executable.get_bytes().size();
+
+	ASSERT_EQ(1, executable.compact_resources());
+
+	EXPECT_EQ(size - 0x200, executable.get_bytes().size());
+	EXPECT_EQ(0, executable.get_sections()[1].raw_size);
+	EXPECT_EQ(0x2000, executable.get_sections()[1].virtual_address);
+	EXPECT_EQ(0x400, executable.get_sections()[2].raw_offset);
+	EXPECT_EQ(executable.get_sections().back().virtual_address, executable.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva);
+	EXPECT_EQ(resources.serialize(0), executable.get_resources().serialize(0));
+
+	// Compacting twice changes nothing.
+	const std::pmr::vector<std::uint8_t> compacted = executable.get_bytes();
+
+	EXPECT_EQ(0, executable.compact_resources());
+	EXPECT_EQ(compacted, executable.get_bytes());
+}
+
+TEST(pe_image, compact_resources_relocate_success)
+{
+	pe_image            executable = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_middle.exe" };
+	const resource_tree resources  = executable.get_resources();
+
+	ASSERT_EQ(1, executable.compact_resources());
+
+	ASSERT_EQ(4, executable.get_sections().size());
+	EXPECT_EQ(0, executable.get_sections()[1].raw_size);
+	EXPECT_EQ(0x400, executable.get_sections()[2].raw_offset);
+	EXPECT_EQ(0x4000, executable.get_data_directory(pe_image::RESOURCE_DIRECTORY).rva);
+	EXPECT_EQ(0x600, executable.get_sections().back().raw_offset);
+	EXPECT_EQ(0x800, executable.get_bytes().size());
+	EXPECT_EQ(resources.serialize(0), executable.get_resources().serialize(0));
+}
+
+TEST(pe_image, compact_resources_shrink_success)
+{
+	pe_image      executable = stamp("rsrc_last.exe", "compact_shrink.exe");
+	resource_tree resources  = executable.get_resources();
+
+	resources = {};
+	resources.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+	executable.set_resources(resources);
+
+	ASSERT_EQ(0, executable.compact_resources());
+
+	EXPECT_EQ(0x200, executable.get_sections().back().raw_size);
+	EXPECT_EQ(0x600, executable.get_bytes().size());
+	EXPECT_EQ(1, executable.get_resources().size());
+}
+
+TEST(pe_image, stamp_reproducible_success)
+{
+	stamp("rsrc_middle.exe", "reproducible_1.exe");
+	stamp("rsrc_middle.exe", "reproducible_2.exe");
+
+	const sha256::digest first  = sha256::hash_file("reproducible_1.exe");
+	const sha256::digest second = sha256::hash_file("reproducible_2.exe");
+
+	EXPECT_EQ(sha256::to_string(first), sha256::to_string(second));
+
+	// Stamping an already stamped executable again must not change it either.
+	pe_image      restamped = pe_image{ "reproducible_1.exe" };
+	resource_tree resources = restamped.get_resources();
+
+	restamped.set_resources(resources);
+	restamped.save("reproducible_1.exe");
+
+	EXPECT_EQ(sha256::to_string(first), sha256::to_string(sha256::hash_file("reproducible_1.exe")));
+}
+
+TEST(pe_image, set_resources_spliced_success)
+{
+	for (const std::string_view source : { "rsrc_last.exe", "rsrc_middle.exe" })
+	{
+		const pe_image copied = stamp(source, "spliced_copy.exe");
+		const icon     icon   = { std::string{ TEST_DATA_PATH } + "image1.ico", true };
+
+		std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + std::string{ source }, "spliced.exe", std::filesystem::copy_options::overwrite_existing);
+
+		pe_image      executable = pe_image{ "spliced.exe" };
+		resource_tree resources  = executable.get_resources();
+
+		resources.set_range(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, icon.get_image_ranges().front());
+		resources.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, icon.get_header());
+		executable.set_resources(resources);
+
+		// The image is a hole until the file is written, but nothing else can tell.
+		EXPECT_NE(copied.get_bytes(), executable.get_bytes());
+		EXPECT_EQ(copied.compute_checksum(), executable.compute_checksum());
+		EXPECT_EQ(sha256::to_string(copied.compute_digest()), sha256::to_string(executable.compute_digest()));
+		EXPECT_EQ(3, executable.get_resources().size());
+
+		const sha256::digest digest = executable.save_with_digest("spliced.exe");
+
+		EXPECT_EQ(sha256::to_string(copied.compute_digest()), sha256::to_string(digest));
+		EXPECT_EQ(sha256::to_string(sha256::hash_file("spliced_copy.exe")), sha256::to_string(sha256::hash_file("spliced.exe")));
+	}
+}
+
+TEST(pe_image, save_with_digest_success)
+{
+	pe_image executable = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_middle.exe" };
+
+	const sha256::digest digest = executable.save_with_digest("digest.exe");
+
+	EXPECT_EQ(sha256::to_string(executable.compute_digest()), sha256::to_string(digest));
+	EXPECT_EQ(sha256::to_string(pe_image{ "digest.exe" }.compute_digest()), sha256::to_string(digest));
+}
+
+TEST(pe_image, save_with_digest_unaligned_success)
+{
+	const pe_image stamped = stamp("rsrc_unaligned.exe", "unaligned.exe");
+
+	ASSERT_NE(0, std::filesystem::file_size(std::string{ TEST_DATA_PATH } + "rsrc_unaligned.exe") % 8);
+
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_unaligned.exe", "unaligned_digest.exe", std::filesystem::copy_options::overwrite_existing);
+
+	pe_image      executable = pe_image{ "unaligned_digest.exe" };
+	resource_tree resources  = stamped.get_resources();
+
+	executable.set_resources(resources);
+
+	const sha256::digest digest = executable.save_with_digest("unaligned_digest.exe");
+
+	// The padding is part of the image, so the checksum covers it and both
+	// paths write the same file.
+	EXPECT_EQ(0, std::filesystem::file_size("unaligned.exe") % 8);
+	EXPECT_EQ(sha256::to_string(sha256::hash_file("unaligned.exe")), sha256::to_string(sha256::hash_file("unaligned_digest.exe")));
+	EXPECT_EQ(sha256::to_string(pe_image{ "unaligned.exe" }.compute_digest()), sha256::to_string(digest));
+	EXPECT_NO_THROW((void)pe_image::verify(pe_image{ "unaligned_digest.exe" }.get_bytes()));
+}
+
+TEST(pe_image, compute_digest_excludes_certificates_success)
+{
+	const pe_image executable = pe_image{ std::string{ TEST_DATA_PATH } + "signed.exe" };
+
+	const std::pmr::vector<std::uint8_t>& bytes       = executable.get_bytes();
+	const pe_image::data_directory        certificate = executable.get_data_directory(pe_image::SECURITY_DIRECTORY);
+	const std::size_t                     checksum    = 0x40 + sizeof(std::uint32_t) + sizeof(file_header) + CHECKSUM_OFFSET;
+	const std::size_t                     directory   = 0x40 + sizeof(std::uint32_t) + sizeof(file_header) + PE32_PLUS_DIRECTORIES_COUNT_OFFSET + sizeof(std::uint32_t) + pe_image::SECURITY_DIRECTORY * sizeof(pe_image::data_directory);
+	sha256                                hash        = {};
+
+	ASSERT_TRUE(executable.has_certificates());
+
+	hash.update({ bytes.data(), checksum });
+	hash.update({ bytes.data() + checksum + sizeof(std::uint32_t), directory - checksum - sizeof(std::uint32_t) });
+	hash.update({ bytes.data() + directory + sizeof(pe_image::data_directory), certificate.rva - directory - sizeof(pe_image::data_directory) });
+	hash.update({ bytes.data() + certificate.rva + certificate.size, bytes.size() - certificate.rva - certificate.size });
+
+	EXPECT_EQ(sha256::to_string(hash.finalize()), sha256::to_string(executable.compute_digest()));
+}
+
+TEST(pe_image, strip_certificates_success)
+{
+	pe_image executable = pe_image{ std::string{ TEST_DATA_PATH } + "signed.exe" };
+
+	const pe_image::data_directory certificate = executable.get_data_directory(pe_image::SECURITY_DIRECTORY);
+
+	executable.strip_certificates();
+
+	EXPECT_FALSE(executable.has_certificates());
+	EXPECT_EQ(certificate.rva, executable.get_bytes().size());
+	EXPECT_EQ(0, executable.get_data_directory(pe_image::SECURITY_DIRECTORY).size);
+}
+
+TEST(pe_image, sha256_known_answer_success)
+{
+	static constexpr std::string_view MESSAGE = "abc";
+
+	const sha256::digest digest = sha256::hash({ reinterpret_cast<const std::uint8_t*>(MESSAGE.data()), MESSAGE.size() });
+
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", sha256::to_string(digest));
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", sha256::to_string(sha256::hash({})));
+}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "png.cpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(png, crc32_success)
+{
+	const std::string_view check = "123456789";
+
+	EXPECT_EQ(0xCBF43926, crc32({ reinterpret_cast<const std::uint8_t*>(check.data()), check.size() }));
+	EXPECT_EQ(0, crc32({}));
+}
+
+TEST(png, encode_png_success)
+{
+	const std::vector<std::uint8_t> pixels = std::vector<std::uint8_t>(300 * 100 * 4, 0x7F);
+	const std::vector<std::uint8_t> png    = encode_png(300, 100, pixels);
+
+	ASSERT_LT(pixels.size(), png.size());
+	EXPECT_TRUE(std::equal(PNG_SIGNATURE.begin(), PNG_SIGNATURE.end(), png.begin()));
+	EXPECT_EQ("IHDR", std::string_view(reinterpret_cast<const char*>(png.data()) + 12, 4));
+	EXPECT_EQ(0x01, png[16 + 2]);
+	EXPECT_EQ(0x2C, png[16 + 3]);
+	EXPECT_EQ("IEND", std::string_view(reinterpret_cast<const char*>(png.data()) + png.size() - 8, 4));
+}
+
+TEST(png, encode_png_fail)
+{
+	ASSERT_THAT([]()
+	{
+		static_cast<void>(encode_png(2, 2, std::vector<std::uint8_t>(15)));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("15 bytes are not 2x2 RGBA pixels!")));
+}
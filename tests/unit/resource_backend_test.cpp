@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "resource_backend.cpp"
+
+#include <filesystem>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(resource_backend, memory_in_place_success)
+{
+	memory_backend backend = memory_backend{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+
+	backend.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02 });
+	backend.commit();
+
+	ASSERT_TRUE(backend.get_report().has_value());
+	EXPECT_EQ(pe_image::placement::in_place, backend.get_report()->placement);
+	EXPECT_EQ(backend.get_report()->old_size, backend.get_report()->new_size);
+	EXPECT_EQ(2, backend.get_image().get_resources().size());
+	EXPECT_THAT(backend.to_json("a.exe"), StartsWith("{\"path\":\"a.exe\",\"placement\":\"in_place\","));
+}
+
+TEST(resource_backend, memory_grown_success)
+{
+	memory_backend backend = memory_backend{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+
+	backend.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, std::vector<std::uint8_t>(0x1000, 0xAA));
+	backend.commit();
+
+	const memory_backend::report& report = backend.get_report().value();
+
+	EXPECT_EQ(pe_image::placement::grown, report.placement);
+	EXPECT_EQ(report.old_size + report.section.raw_size - 0x200, report.new_size);
+	EXPECT_EQ(report.new_size, backend.get_image().get_bytes().size());
+	EXPECT_EQ(".rsrc", report.section.name);
+	EXPECT_THAT(backend.to_json("a.exe"), HasSubstr(std::format("\"delta\":{},", report.new_size - report.old_size)));
+}
+
+TEST(resource_backend, memory_appended_success)
+{
+	memory_backend backend = memory_backend{ std::string{ TEST_DATA_PATH } + "rsrc_middle.exe" };
+	const auto     size    = std::filesystem::file_size(std::string{ TEST_DATA_PATH } + "rsrc_middle.exe");
+
+	backend.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, std::vector<std::uint8_t>(0x1000, 0xAA));
+	backend.commit();
+
+	EXPECT_EQ(pe_image::placement::appended, backend.get_report()->placement);
+	EXPECT_EQ(size, backend.get_report()->old_size);
+	EXPECT_EQ(size, std::filesystem::file_size(std::string{ TEST_DATA_PATH } + "rsrc_middle.exe"));
+	EXPECT_EQ(backend.get_image().get_sections().back().virtual_address, backend.get_report()->section.virtual_address);
+}
+
+TEST(resource_backend, memory_to_json_fail)
+{
+	const memory_backend backend = memory_backend{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+
+	ASSERT_THAT([&backend]()
+	{
+		static_cast<void>(backend.to_json("a.exe"));
+	},
+	ThrowsMessage<std::logic_error>(HasSubstr("Nothing was committed yet!")));
+}
+
+TEST(resource_backend, file_commit_success)
+{
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_last.exe", "backend.exe", std::filesystem::copy_options::overwrite_existing);
+
+	file_backend backend = file_backend{ "backend.exe", true };
+
+	backend.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+	backend.commit();
+
+	ASSERT_TRUE(backend.get_digest().has_value());
+	EXPECT_EQ(sha256::to_string(pe_image{ "backend.exe" }.compute_digest()), sha256::to_string(backend.get_digest().value()));
+	EXPECT_EQ(2, pe_image{ "backend.exe" }.get_resources().size());
+}
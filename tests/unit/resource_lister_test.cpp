@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "resource_lister.cpp"
+
+#include <filesystem>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(resource_lister, list_resources_success)
+{
+	const std::string path = std::string{ TEST_DATA_PATH } + "rsrc_last.exe";
+
+	EXPECT_EQ(std::format("{{\"path\":\"{}\",\"resources\":[{{\"type\":10,\"name\":1,\"language\":1033,\"size\":16}}]}}", path), list_resources(path));
+	EXPECT_EQ(std::format("{{\"path\":\"{}no_rsrc.exe\",\"resources\":[]}}", TEST_DATA_PATH), list_resources(std::string{ TEST_DATA_PATH } + "no_rsrc.exe"));
+}
+
+TEST(resource_lister, list_resources_group_icon_success)
+{
+	icon          icon       = { std::string{ TEST_DATA_PATH } + "image1.ico" };
+	pe_image      executable = pe_image{ std::string{ TEST_DATA_PATH } + "rsrc_last.exe" };
+	resource_tree resources  = executable.get_resources();
+
+	resources.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { icon.get_images().front().begin(), icon.get_images().front().end() });
+	resources.set(resource_type::group_icon, "MAIN\"ICON", resource_tree::NEUTRAL_LANGUAGE, icon.get_header());
+	executable.set_resources(resources);
+	executable.save("listed.exe");
+
+	EXPECT_THAT(list_resources("listed.exe"),
+	            HasSubstr(std::format("{{\"type\":14,\"name\":\"MAIN\\\"ICON\",\"language\":0,\"size\":{},"
+	                                  "\"icons\":[{{\"id\":1,\"width\":32,\"height\":32,\"color_count\":0,\"planes\":1,\"bit_count\":32,\"size\":4264}}]}}",
+	                                  icon.get_header().size())));
+}
+
+TEST(resource_lister, list_resources_fail)
+{
+	EXPECT_EQ("{\"path\":\"invalid.exe\",\"error\":\"Failed to open \\\"invalid.exe\\\"!\"}", list_resources("invalid.exe"));
+	EXPECT_THAT(list_resources(std::string{ TEST_DATA_PATH } + "image1.ico"), HasSubstr("\"error\":\"Executable does not have a DOS header!\""));
+}
+
+TEST(resource_lister, collect_executables_success)
+{
+	const std::array<const char*, 2> paths       = { "invalid.ico", TEST_DATA_PATH };
+	const std::vector<std::string>   executables = collect_executables(paths);
+
+	ASSERT_LE(4, executables.size());
+	EXPECT_EQ("invalid.ico", executables.front());
+	EXPECT_TRUE(std::is_sorted(executables.begin() + 1, executables.end()));
+	EXPECT_TRUE(std::none_of(executables.begin() + 1, executables.end(), [](const std::string& executable)
+	{
+		return executable.ends_with(".ico") || executable.ends_with(".bmp");
+	}));
+}
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "resource_tree.cpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(resource_tree, serialize_empty_success)
+{
+	const resource_tree             tree  = {};
+	const std::vector<std::uint8_t> bytes = tree.serialize(0x1000);
+
+	EXPECT_EQ(sizeof(resource_directory), tree.get_serialized_size());
+	EXPECT_EQ(std::vector<std::uint8_t>(sizeof(resource_directory), 0x00), bytes);
+}
+
+TEST(resource_tree, round_trip_success)
+{
+	static constexpr std::uint32_t SECTION_RVA = 0x3000;
+
+	resource_tree tree = {};
+
+	tree.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02, 0x03 });
+	tree.set(resource_type::icon, 2, 0x0409, { 0x04 });
+	tree.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, { 0x05, 0x06 });
+	tree.set("CUSTOM", "Data", 0x0409, {});
+
+	const std::vector<std::uint8_t> bytes  = tree.serialize(SECTION_RVA);
+	const resource_tree             parsed = resource_tree::parse(bytes, SECTION_RVA);
+
+	ASSERT_EQ(4, parsed.size());
+	ASSERT_NE(nullptr, parsed.find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE));
+	EXPECT_THAT(parsed.find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAre(0x01, 0x02, 0x03));
+	ASSERT_NE(nullptr, parsed.find(resource_type::group_icon, "mainicon", resource_tree::NEUTRAL_LANGUAGE));
+	EXPECT_THAT(parsed.find(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAre(0x05, 0x06));
+	EXPECT_EQ(nullptr, parsed.find(resource_type::icon, 2, resource_tree::NEUTRAL_LANGUAGE));
+	EXPECT_EQ(bytes, parsed.serialize(SECTION_RVA));
+}
+
+TEST(resource_tree, serialize_deterministic_success)
+{
+	resource_tree first  = {};
+	resource_tree second = {};
+
+	first.set(resource_type::icon, 2, resource_tree::NEUTRAL_LANGUAGE, { 0x02 });
+	first.set("B", 1, resource_tree::NEUTRAL_LANGUAGE, { 0x0B });
+	first.set("a", 1, resource_tree::NEUTRAL_LANGUAGE, { 0x0A });
+	first.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+
+	second.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+	second.set("a", 1, resource_tree::NEUTRAL_LANGUAGE, { 0x0A });
+	second.set(resource_type::icon, 2, resource_tree::NEUTRAL_LANGUAGE, { 0x02 });
+	second.set("B", 1, resource_tree::NEUTRAL_LANGUAGE, { 0x0B });
+
+	EXPECT_EQ(first.serialize(0x2000), second.serialize(0x2000));
+}
+
+TEST(resource_tree, merge_success)
+{
+	resource_tree target = {};
+	resource_tree stamp  = {};
+
+	target.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+	target.set(resource_type::icon, 3, resource_tree::NEUTRAL_LANGUAGE, { 0x03 });
+	stamp.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x0A });
+	stamp.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, { 0x0B });
+
+	target.merge(stamp);
+
+	ASSERT_EQ(3, target.size());
+	EXPECT_THAT(target.find(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAre(0x0A));
+	EXPECT_THAT(target.find(resource_type::icon, 3, resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAre(0x03));
+	EXPECT_EQ(2, stamp.size());
+}
+
+TEST(resource_tree, serialize_layout_success)
+{
+	resource_tree tree = {};
+
+	tree.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0xAA });
+	tree.set("B", 1, resource_tree::NEUTRAL_LANGUAGE, { 0xBB });
+	tree.set("a", 1, resource_tree::NEUTRAL_LANGUAGE, { 0xCC });
+
+	const std::vector<std::uint8_t> bytes = tree.serialize(0x2000);
+	resource_directory              root  = {};
+	resource_directory_entry        first = {};
+	resource_directory_entry        third = {};
+
+	std::memcpy(&root, bytes.data(), sizeof(root));
+	std::memcpy(&first, bytes.data() + sizeof(root), sizeof(first));
+	std::memcpy(&third, bytes.data() + sizeof(root) + 2 * sizeof(first), sizeof(third));
+
+	EXPECT_EQ(0, root.time_date_stamp);
+	EXPECT_EQ(2, root.named_entries_count);
+	EXPECT_EQ(1, root.id_entries_count);
+	EXPECT_NE(0, first.name & HIGH_BIT);
+	EXPECT_EQ(static_cast<std::uint32_t>(resource_type::icon), third.name);
+	EXPECT_EQ(0, bytes.size() % DATA_ALIGNMENT);
+	EXPECT_EQ(0xAA, bytes[bytes.size() - DATA_ALIGNMENT]);
+	EXPECT_EQ(std::vector<std::uint8_t>(DATA_ALIGNMENT - 1, 0x00), std::vector<std::uint8_t>(bytes.end() - DATA_ALIGNMENT + 1, bytes.end()));
+}
+
+TEST(resource_tree, parse_truncated_fail)
+{
+	const std::vector<std::uint8_t> bytes = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00 };
+
+	ASSERT_THAT([&]()
+	{
+		resource_tree::parse(bytes, 0x1000);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("has too many entries!")));
+}
+
+TEST(resource_tree, parse_shared_directory_fail)
+{
+	resource_tree tree = {};
+
+	tree.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+	tree.set(resource_type::group_icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x02 });
+
+	std::vector<std::uint8_t> bytes = tree.serialize(0x1000);
+
+	// The second type points at the names of the first one.
+	std::memcpy(bytes.data() + sizeof(resource_directory) + sizeof(resource_directory_entry) + offsetof(resource_directory_entry, offset),
+	            bytes.data() + sizeof(resource_directory) + offsetof(resource_directory_entry, offset), sizeof(std::uint32_t));
+
+	ASSERT_THAT([&]()
+	{
+		resource_tree::parse(bytes, 0x1000);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("is referenced more than once!")));
+}
+
+TEST(resource_tree, parse_data_out_of_bounds_fail)
+{
+	resource_tree tree = {};
+
+	tree.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+
+	const std::vector<std::uint8_t> bytes = tree.serialize(0x1000);
+
+	ASSERT_THAT([&]()
+	{
+		resource_tree::parse(bytes, 0x2000);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("data is out of bounds!")));
+}
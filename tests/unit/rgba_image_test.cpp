@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rgba_image.cpp"
+
+#include <fstream>
+
+#include "icon.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(rgba_image, from_bitmap_success)
+{
+	bitmap bmp = {};
+
+	ASSERT_TRUE(bmp.loadFromImage(TEST_DATA_PATH "valid_24bit.bmp"));
+
+	const rgba_image image = rgba_image::from_bitmap(bmp);
+
+	ASSERT_EQ(32, image.get_width());
+	ASSERT_EQ(32, image.get_height());
+	EXPECT_EQ(bmp.getPixels()[2], image.get_pixels()[0]);
+	EXPECT_EQ(bmp.getPixels()[0], image.get_pixels()[2]);
+	EXPECT_EQ(0xFF, image.get_pixels()[3]);
+}
+
+TEST(rgba_image, resize_success)
+{
+	// A 4x1 image: opaque red, opaque red, transparent green, transparent green.
+	const rgba_image image  = { 4, 1, { 0xFF, 0, 0, 0xFF, 0xFF, 0, 0, 0xFF, 0, 0xFF, 0, 0, 0, 0xFF, 0, 0 } };
+	const rgba_image shrunk = image.resize(2, 1);
+	const rgba_image grown  = image.resize(8, 2);
+
+	// Transparent pixels do not bleed their color into the average.
+	EXPECT_THAT(shrunk.get_pixels(), ElementsAre(0xFF, 0, 0, 0xDB, 0xFF, 0, 0, 0x24));
+	ASSERT_EQ(8 * 2 * 4, grown.get_pixels().size());
+	EXPECT_EQ(0xFF, grown.get_pixels()[3]);
+	EXPECT_EQ(0, grown.get_pixels()[7 * 4 + 3]);
+	EXPECT_EQ(image.get_pixels(), image.resize(4, 1).get_pixels());
+}
+
+TEST(rgba_image, to_dib_success)
+{
+	const rgba_image                image  = { 2, 2, { 1, 2, 3, 0xFF, 4, 5, 6, 0, 7, 8, 9, 0xFF, 10, 11, 12, 0xFF } };
+	const std::vector<std::uint8_t> dib    = image.to_dib();
+	dib_header                      header = {};
+
+	ASSERT_EQ(sizeof(header) + 2 * 2 * 4 + 2 * 4, dib.size());
+	std::memcpy(&header, dib.data(), sizeof(header));
+	EXPECT_EQ(4, header.height);
+	EXPECT_EQ(32, header.bit_count);
+
+	// Bottom row first, BGRA, then the AND mask with the transparent pixel set.
+	EXPECT_THAT(std::vector<std::uint8_t>(dib.begin() + sizeof(header), dib.begin() + sizeof(header) + 8), ElementsAre(9, 8, 7, 0xFF, 12, 11, 10, 0xFF));
+	EXPECT_EQ(0x00, dib[sizeof(header) + 16]);
+	EXPECT_EQ(0x40, dib[sizeof(header) + 20]);
+}
+
+TEST(rgba_image, from_dib_success)
+{
+	const rgba_image image   = { 2, 2, { 1, 2, 3, 0xFF, 4, 5, 6, 0, 7, 8, 9, 0xFF, 10, 11, 12, 0x80 } };
+	const rgba_image decoded = rgba_image::from_dib(image.to_dib());
+
+	EXPECT_EQ(image.get_pixels(), decoded.get_pixels());
+}
+
+TEST(rgba_image, from_dib_palettized_success)
+{
+	// A 3x2 1-bit DIB: black and white palette, then the rows bottom first, then the AND mask.
+	std::vector<std::uint8_t> dib    = std::vector<std::uint8_t>(sizeof(dib_header));
+	const dib_header          header = { sizeof(dib_header), 3, 4, 1, 1, 0, 0, 0, 0, 0, 0 };
+
+	std::memcpy(dib.data(), &header, sizeof(header));
+	dib.insert(dib.end(), { 0, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0 });
+	dib.insert(dib.end(), { 0b10100000, 0, 0, 0, 0b01000000, 0, 0, 0 });
+	dib.insert(dib.end(), { 0b00100000, 0, 0, 0, 0, 0, 0, 0 });
+
+	const rgba_image image = rgba_image::from_dib(dib);
+
+	ASSERT_EQ(3, image.get_width());
+	ASSERT_EQ(2, image.get_height());
+	EXPECT_THAT(image.get_pixels(), ElementsAre(0, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0xFF,
+	                                            0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0));
+}
+
+TEST(rgba_image, from_dib_icon_success)
+{
+	icon             icon  = { TEST_DATA_PATH "image1.ico" };
+	const rgba_image image = rgba_image::from_dib(icon.get_images().front());
+
+	EXPECT_EQ(32, image.get_width());
+	EXPECT_EQ(32, image.get_height());
+	EXPECT_EQ(image.get_pixels(), rgba_image::from_dib(image.to_dib()).get_pixels());
+}
+
+TEST(rgba_image, from_dib_fail)
+{
+	const rgba_image                image     = rgba_image(4, 4, std::vector<std::uint8_t>(4 * 4 * 4));
+	const std::vector<std::uint8_t> png       = image.to_png();
+	std::vector<std::uint8_t>       truncated = image.to_dib();
+
+	// An 8-bit header makes the pixels too small for their palette.
+	truncated[offsetof(dib_header, bit_count)] = 8;
+
+	ASSERT_THAT([&png]()
+	{
+		static_cast<void>(rgba_image::from_dib(png));
+	},
+	Throws<std::invalid_argument>());
+
+	ASSERT_THAT([&truncated]()
+	{
+		static_cast<void>(rgba_image::from_dib(truncated));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("too small")));
+}
+
+TEST(rgba_image, encode_ico_success)
+{
+	const std::vector<rgba_image>   images = { rgba_image{ 16, 16, std::vector<std::uint8_t>(16 * 16 * 4, 0xFF) },
+	                                           rgba_image{ 256, 256, std::vector<std::uint8_t>(256 * 256 * 4, 0xFF) } };
+	const std::vector<std::uint8_t> ico    = rgba_image::encode_ico(images);
+	ico_directory_entry             entry  = {};
+
+	std::ofstream{ "encoded.ico", std::ios::binary }.write(reinterpret_cast<const char*>(ico.data()), static_cast<std::streamsize>(ico.size()));
+
+	EXPECT_EQ(2, icon{ "encoded.ico" }.get_images().size());
+
+	std::memcpy(&entry, ico.data() + sizeof(icon::header) + sizeof(entry), sizeof(entry));
+	EXPECT_EQ(0, entry.width);
+	EXPECT_EQ(0x89, ico[entry.image_offset]);
+}
+
+TEST(rgba_image, encode_ico_fail)
+{
+	ASSERT_THAT([]()
+	{
+		static_cast<void>(rgba_image::encode_ico({}));
+	},
+	ThrowsMessage<std::invalid_argument>(HasSubstr("cannot hold 0 image(s)!")));
+}
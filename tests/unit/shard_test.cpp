@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "shard.cpp"
+
+#include <fstream>
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(shard, parse_shard_success)
+{
+	const shard_spec shard = parse_shard("2/4");
+
+	EXPECT_EQ(1, shard.index);
+	EXPECT_EQ(4, shard.count);
+	EXPECT_EQ("2/4", format_shard(shard));
+}
+
+TEST(shard, parse_shard_fail)
+{
+	for (const std::string_view text : { std::string_view{ "0/4" }, std::string_view{ "5/4" }, std::string_view{ "1/0" }, std::string_view{ "1" },
+	                                     std::string_view{ "1/4x" }, std::string_view{ "/4" } })
+	{
+		EXPECT_THAT([text]()
+		{
+			static_cast<void>(parse_shard(text));
+		},
+		ThrowsMessage<std::invalid_argument>(HasSubstr("expecting i/N")));
+	}
+}
+
+TEST(shard, select_shard_success)
+{
+	static constexpr std::uint32_t SHARD_COUNT = 4;
+
+	std::vector<std::string> paths = {};
+	std::uint64_t            total = 0;
+
+	std::filesystem::create_directories("shard_targets");
+
+	// A few big files among many small ones.
+	for (std::size_t index = 0; index < 200; ++index)
+	{
+		const std::size_t size = 0 == index % 50 ? 20000 : 100 + index;
+		std::ofstream     file = std::ofstream{ std::format("shard_targets/{}.exe", index), std::ios::binary };
+
+		file << std::string(size, 'x');
+		paths.push_back(std::format("shard_targets/{}.exe", index));
+		total += size;
+	}
+
+	const std::vector<std::uint64_t> sizes  = get_file_sizes(paths);
+	std::vector<std::size_t>         owners = std::vector<std::size_t>(paths.size(), SHARD_COUNT);
+
+	for (std::uint32_t index = 0; index < SHARD_COUNT; ++index)
+	{
+		const shard_selection          selection = select_shard(paths, sizes, { index, SHARD_COUNT });
+		const std::vector<std::size_t> selected  = selection.indices;
+		std::uint64_t                  bytes     = 0;
+
+		EXPECT_TRUE(std::is_sorted(selected.begin(), selected.end()));
+		EXPECT_EQ(selected, select_shard(paths, sizes, { index, SHARD_COUNT }).indices);
+		EXPECT_EQ(select_shard(paths, sizes, { 0, SHARD_COUNT }).partition, selection.partition);
+
+		for (const std::size_t target : selected)
+		{
+			EXPECT_EQ(SHARD_COUNT, owners[target]);
+			owners[target] = index;
+			bytes         += std::filesystem::file_size(paths[target]);
+		}
+
+		// Balanced by bytes: within one big file of the even split.
+		EXPECT_GT(total / SHARD_COUNT + 20000, bytes);
+		EXPECT_LT(total / SHARD_COUNT, bytes + 20000);
+	}
+
+	EXPECT_EQ(paths.size(), std::count_if(owners.begin(), owners.end(), [](const std::size_t owner)
+	{
+		return SHARD_COUNT > owner;
+	}));
+
+	// The partition depends on the paths, not on their order.
+	const std::vector<std::string>   reversed       = std::vector<std::string>(paths.rbegin(), paths.rend());
+	const std::vector<std::uint64_t> reversed_sizes = std::vector<std::uint64_t>(sizes.rbegin(), sizes.rend());
+
+	for (const std::size_t target : select_shard(reversed, reversed_sizes, { 0, SHARD_COUNT }).indices)
+	{
+		EXPECT_EQ(0, owners[paths.size() - 1 - target]);
+	}
+
+	// Only the sizes given count: stamping a target changes nothing until
+	// its new size is passed, which the fingerprint shows.
+	const std::uint64_t partition = select_shard(paths, sizes, { 0, SHARD_COUNT }).partition;
+
+	std::ofstream{ paths.front(), std::ios::app } << "stamped";
+
+	EXPECT_EQ(partition, select_shard(paths, sizes, { 0, SHARD_COUNT }).partition);
+	EXPECT_NE(partition, select_shard(paths, get_file_sizes(paths), { 0, SHARD_COUNT }).partition);
+
+	std::filesystem::remove_all("shard_targets");
+
+	// The sizes must match the paths.
+	EXPECT_THROW(static_cast<void>(select_shard(paths, std::span<const std::uint64_t>{ sizes }.first(1), { 0, SHARD_COUNT })), std::logic_error);
+}
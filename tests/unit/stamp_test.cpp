@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "stamp.cpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "pe_image.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// HELPERS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Builds an RT_GROUP_CURSOR resource with a single cursor.
+/// \param cursor_id: The RT_CURSOR identifier of the cursor.
+/// \returns The group header.
+///
+static std::vector<std::uint8_t> make_group_cursor(const std::uint16_t cursor_id)
+{
+	const icon::header        header = { 0, 2, 1 };
+	const icon::cursor_entry  entry  = { 32, 64, 1, 1, 0x134, cursor_id };
+	std::vector<std::uint8_t> bytes  = std::vector<std::uint8_t>(sizeof(header) + sizeof(entry));
+
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	std::memcpy(bytes.data() + sizeof(header), &entry, sizeof(entry));
+
+	return bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(stamp, place_cursors_after_target_success)
+{
+	resource_tree stamp  = {};
+	resource_tree target = {};
+
+	stamp.set(resource_type::cursor, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02 });
+	stamp.set(resource_type::group_cursor, "ARROW", resource_tree::NEUTRAL_LANGUAGE, make_group_cursor(1));
+	target.set(resource_type::cursor, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x03 });
+	target.set(resource_type::cursor, 2, resource_tree::NEUTRAL_LANGUAGE, { 0x04 });
+	target.set(resource_type::group_cursor, "HAND", resource_tree::NEUTRAL_LANGUAGE, make_group_cursor(1));
+	target.set(resource_type::group_cursor, "WAIT", resource_tree::NEUTRAL_LANGUAGE, make_group_cursor(2));
+
+	const std::optional<resource_tree> placed = place_cursors(stamp, target);
+
+	ASSERT_TRUE(placed.has_value());
+	EXPECT_EQ(2, placed->size());
+	EXPECT_EQ(nullptr, placed->find(resource_type::cursor, 1, resource_tree::NEUTRAL_LANGUAGE));
+	ASSERT_NE(nullptr, placed->find(resource_type::cursor, 3, resource_tree::NEUTRAL_LANGUAGE));
+	EXPECT_THAT(placed->find(resource_type::cursor, 3, resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAre(0x01, 0x02));
+	EXPECT_THAT(placed->find(resource_type::group_cursor, "ARROW", resource_tree::NEUTRAL_LANGUAGE)->data, ElementsAreArray(make_group_cursor(3)));
+}
+
+TEST(stamp, place_cursors_restamp_success)
+{
+	resource_tree stamp = {};
+
+	stamp.set(resource_type::cursor, 1, resource_tree::NEUTRAL_LANGUAGE, { 0x01, 0x02 });
+	stamp.set(resource_type::group_cursor, "ARROW", resource_tree::NEUTRAL_LANGUAGE, make_group_cursor(1));
+
+	// The images of the replaced group are reused, so stamping again is stable.
+	EXPECT_FALSE(place_cursors(stamp, stamp).has_value());
+	EXPECT_FALSE(place_cursors(stamp, resource_tree{}).has_value());
+}
+
+TEST(stamp, stamp_file_success)
+{
+	const stamp_options options = { { std::string{ TEST_DATA_PATH } + "image1.cur" }, false, certificate_policy::unspecified, true };
+	const resource_tree stamp   = build_stamp(std::string{ TEST_DATA_PATH } + "image1.ico", options);
+
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_last.exe", "stamp_file.exe", std::filesystem::copy_options::overwrite_existing);
+
+	ASSERT_NE(nullptr, stamp.find(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE));
+	ASSERT_NE(nullptr, stamp.find(resource_type::group_cursor, "IMAGE1", resource_tree::NEUTRAL_LANGUAGE));
+
+	const stamp_result result = stamp_file(stamp, "stamp_file.exe", options, true, true);
+
+	ASSERT_TRUE(result.digest.has_value());
+	ASSERT_TRUE(result.contents.has_value());
+	EXPECT_EQ(sha256::to_string(pe_image{ "stamp_file.exe" }.compute_digest()), sha256::to_string(*result.digest));
+	EXPECT_EQ(sha256::to_string(sha256::hash_file("stamp_file.exe")), sha256::to_string(*result.contents));
+	EXPECT_EQ(std::filesystem::file_size("stamp_file.exe"), result.size);
+	EXPECT_FALSE(stamp_file(stamp, "stamp_file.exe", options, false, false).contents.has_value());
+}
+
+TEST(stamp, verify_fail)
+{
+	resource_tree stamp = {};
+
+	stamp.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, std::vector<std::uint8_t>(64, 0xA5));
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_last.exe", "verify_fail.exe", std::filesystem::copy_options::overwrite_existing);
+
+	const std::string original = sha256::to_string(sha256::hash_file("verify_fail.exe"));
+	file_backend      backend  = file_backend{ "verify_fail.exe", false };
+
+	backend.merge(stamp);
+	backend.set_check([&stamp](const std::string_view written_path)
+	{
+		std::fstream      file     = std::fstream{ std::string{ written_path }, std::ios::binary | std::ios::in | std::ios::out };
+		const std::string contents = std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+		// Damage the stamped image, as a faulty writer or disk would.
+		file.seekp(static_cast<std::streamoff>(contents.find(std::string(64, '\xA5'))));
+		file.put('\x00');
+		file.close();
+
+		verify_stamp(written_path, stamp);
+	});
+
+	ASSERT_THAT([&backend]()
+	{
+		backend.commit();
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("failed verification")));
+
+	EXPECT_EQ(original, sha256::to_string(sha256::hash_file("verify_fail.exe")));
+	EXPECT_FALSE(std::filesystem::exists("verify_fail.exe.tmp"));
+}
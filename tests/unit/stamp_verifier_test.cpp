@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+// This is free and unencumbered software released into the public domain.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to https://unlicense.org
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// HEADER FILE INCLUDES
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "stamp_verifier.cpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include "resource_backend.hpp"
+
+using namespace testing;
+using namespace icon_changer;
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// \brief Builds a stamp with an icon and its header.
+/// \param fill: The value of the icon bytes.
+/// \returns The stamp.
+///
+static resource_tree make_stamp(const std::uint8_t fill)
+{
+	resource_tree stamp = {};
+
+	stamp.set(resource_type::icon, 1, resource_tree::NEUTRAL_LANGUAGE, std::vector<std::uint8_t>(0x1000, fill));
+	stamp.set(resource_type::group_icon, "MAINICON", resource_tree::NEUTRAL_LANGUAGE, { 0x00, 0x00, 0x01, 0x00 });
+
+	return stamp;
+}
+
+///
+/// \brief Stamps a copy of rsrc_last.exe.
+/// \param file_path: The path to the copy.
+/// \param stamp: The resources to be stamped.
+///
+static void write_stamped(const std::string_view file_path,
+                          const resource_tree&   stamp)
+{
+	std::filesystem::copy_file(std::string{ TEST_DATA_PATH } + "rsrc_last.exe", file_path, std::filesystem::copy_options::overwrite_existing);
+
+	file_backend backend = file_backend{ file_path, false };
+
+	backend.merge(stamp);
+	backend.commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TESTS
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(stamp_verifier, verify_success)
+{
+	const resource_tree stamp = make_stamp(0xAA);
+
+	write_stamped("verify.exe", stamp);
+
+	EXPECT_NO_THROW(verify_stamp("verify.exe", stamp));
+}
+
+TEST(stamp_verifier, mismatch_fail)
+{
+	const resource_tree other = make_stamp(0xBB);
+
+	write_stamped("verify_mismatch.exe", make_stamp(0xAA));
+
+	ASSERT_THAT([&other]()
+	{
+		verify_stamp("verify_mismatch.exe", other);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("Resource 3/1/0 does not match what was stamped!")));
+}
+
+TEST(stamp_verifier, missing_fail)
+{
+	resource_tree stamp = make_stamp(0xAA);
+
+	write_stamped("verify_missing.exe", stamp);
+	stamp.set(resource_type::icon, 2, resource_tree::NEUTRAL_LANGUAGE, { 0x01 });
+
+	ASSERT_THAT([&stamp]()
+	{
+		verify_stamp("verify_missing.exe", stamp);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("1 of 3 stamped resource(s) are missing!")));
+}
+
+TEST(stamp_verifier, checksum_fail)
+{
+	const resource_tree stamp = make_stamp(0xAA);
+
+	write_stamped("verify_checksum.exe", stamp);
+
+	{
+		std::fstream file = std::fstream{ "verify_checksum.exe", std::ios::binary | std::ios::in | std::ios::out };
+
+		file.seekp(static_cast<std::streamoff>(std::filesystem::file_size("verify_checksum.exe") - 1));
+		file.put('\x5A');
+	}
+
+	ASSERT_THAT([&stamp]()
+	{
+		verify_stamp("verify_checksum.exe", stamp);
+	},
+	ThrowsMessage<std::runtime_error>(HasSubstr("does not match the contents")));
+}